@@ -99,28 +99,32 @@ namespace impl
             return r;
         }
 
-        inline bool findAndStoreRange(const typename BaseCache::KeyType_impl& _key, size_t& _inOutStorageSize, typename BaseCache::MutablePairType* _out)
+        template<typename LookupKeyT = typename BaseCache::KeyType_impl>
+        inline bool findAndStoreRange(const LookupKeyT& _key, size_t& _inOutStorageSize, typename BaseCache::MutablePairType* _out)
         {
             auto lk = lock_read();
             const bool r = BaseCache::findAndStoreRange(_key, _inOutStorageSize, _out);
             return r;
         }
 
-        inline bool findAndStoreRange(const typename BaseCache::KeyType_impl& _key, size_t& _inOutStorageSize, typename BaseCache::MutablePairType* _out) const
+        template<typename LookupKeyT = typename BaseCache::KeyType_impl>
+        inline bool findAndStoreRange(const LookupKeyT& _key, size_t& _inOutStorageSize, typename BaseCache::MutablePairType* _out) const
         {
             auto lk = lock_read();
             const bool r = BaseCache::findAndStoreRange(_key, _inOutStorageSize, _out);
             return r;
         }
 
-        inline bool findAndStoreRange(const typename BaseCache::KeyType_impl& _key, size_t& _inOutStorageSize, typename BaseCache::ValueType_impl* _out)
+        template<typename LookupKeyT = typename BaseCache::KeyType_impl>
+        inline bool findAndStoreRange(const LookupKeyT& _key, size_t& _inOutStorageSize, typename BaseCache::ValueType_impl* _out)
         {
             auto lk = lock_read();
             const bool r = BaseCache::findAndStoreRange(_key, _inOutStorageSize, _out);
             return r;
         }
 
-        inline bool findAndStoreRange(const typename BaseCache::KeyType_impl& _key, size_t& _inOutStorageSize, typename BaseCache::ValueType_impl* _out) const
+        template<typename LookupKeyT = typename BaseCache::KeyType_impl>
+        inline bool findAndStoreRange(const LookupKeyT& _key, size_t& _inOutStorageSize, typename BaseCache::ValueType_impl* _out) const
         {
             auto lk = lock_read();
             const bool r = BaseCache::findAndStoreRange(_key, _inOutStorageSize, _out);
@@ -15,6 +15,7 @@
 #include "nbl/macros.h"
 #include "nbl/core/decl/Types.h"
 #include "nbl/core/SRange.h"
+#include "nbl/core/containers/stable_flat_hash_map.h"
 
 namespace nbl::core
 {
@@ -47,6 +48,8 @@ namespace impl
     struct is_multi_container<std::multimap> : std::true_type {};
     template<>
     struct is_multi_container<std::unordered_multimap> : std::true_type {};
+    template<>
+    struct is_multi_container<core::stable_flat_hash_multimap> : std::true_type {};
 
     template<template<typename...> class>
     struct is_assoc_container : std::false_type {};
@@ -58,6 +61,22 @@ namespace impl
     struct is_assoc_container<std::multimap> : std::true_type {};
     template<>
     struct is_assoc_container<std::unordered_multimap> : std::true_type {};
+    template<>
+    struct is_assoc_container<core::stable_flat_hash_map> : std::true_type {};
+    template<>
+    struct is_assoc_container<core::stable_flat_hash_multimap> : std::true_type {};
+
+    //! Hash based containers get a transparent hasher, so they can be searched without constructing a key (e.g. with a `std::string_view`)
+    template<template<typename...> class>
+    struct is_hash_container : std::false_type {};
+    template<>
+    struct is_hash_container<std::unordered_map> : std::true_type {};
+    template<>
+    struct is_hash_container<std::unordered_multimap> : std::true_type {};
+    template<>
+    struct is_hash_container<core::stable_flat_hash_map> : std::true_type {};
+    template<>
+    struct is_hash_container<core::stable_flat_hash_multimap> : std::true_type {};
 
     template<typename K, typename...>
     struct NBL_FORCE_EBO NBL_NO_VTABLE PropagKeyTypeTypedef_ { using KeyType = K; };
@@ -76,17 +95,23 @@ namespace impl
     struct NBL_FORCE_EBO CObjectCacheBase
     {
     private:
-        template<bool isAssoc, template<typename...> class C>
+        template<bool isAssoc, bool isHash, template<typename...> class C>
         struct help;
 
         template<template<typename...> class C>
-        struct help<true, C>
+        struct help<true, false, C>
         {
             template<typename KK, typename TT, typename AAlloc>
             using container_t = C<KK, TT, std::less<KK>, AAlloc>;
         };
         template<template<typename...> class C>
-        struct help<false, C>
+        struct help<true, true, C>
+        {
+            template<typename KK, typename TT, typename AAlloc>
+            using container_t = C<KK, TT, core::transparent_hash<std::remove_const_t<KK>>, std::equal_to<>, AAlloc>;
+        };
+        template<template<typename...> class C>
+        struct help<false, false, C>
         {
             template<typename TT, typename AAlloc>
             using container_t = C<TT, AAlloc>;
@@ -95,7 +120,7 @@ namespace impl
     public:
         using AllocatorType = Alloc;
 
-        using UnderlyingContainerType = typename help<is_assoc_container<ContainerT_T>::value, ContainerT_T>::template container_t<K..., T, Alloc>;
+        using UnderlyingContainerType = typename help<is_assoc_container<ContainerT_T>::value, is_hash_container<ContainerT_T>::value, ContainerT_T>::template container_t<K..., T, Alloc>;
         using IteratorType = typename UnderlyingContainerType::iterator;
         using ConstIteratorType = typename UnderlyingContainerType::const_iterator;
         using RevIteratorType = typename UnderlyingContainerType::reverse_iterator;
@@ -334,12 +359,15 @@ namespace impl
         }
 
     public:
-        inline typename Base::RangeType findRange(const typename Base::KeyType_impl& _key)
+        //! Hash based containers can be searched with any type their hasher accepts
+        template<typename LookupKeyT = typename Base::KeyType_impl>
+        inline typename Base::RangeType findRange(const LookupKeyT& _key)
         {
             auto p = Base::m_container.equal_range(_key);
             return typename Base::RangeType(p.first,p.second);
         }
-        inline typename Base::ConstRangeType findRange(const typename Base::KeyType_impl& _key) const
+        template<typename LookupKeyT = typename Base::KeyType_impl>
+        inline typename Base::ConstRangeType findRange(const LookupKeyT& _key) const
         {
             auto p = Base::m_container.equal_range(_key);
             return typename Base::ConstRangeType(p.first, p.second);
@@ -527,18 +555,19 @@ namespace impl
             INSERT_IMPL_ASSOC
         }
 
-        inline typename Base::RangeType findRange(const typename Base::KeyType_impl& _key)
+        //! Hash based containers can be searched with any type their hasher accepts
+        template<typename LookupKeyT = typename Base::KeyType_impl>
+        inline typename Base::RangeType findRange(const LookupKeyT& _key)
         {
-            auto it = this->m_container.lower_bound(_key);
-            if (it == std::end(this->m_container) || it->first > _key)
-                return { it, it };
-            return { it, std::next(it) };
+            // unlike `lower_bound` this works for hash based containers too, and for a missing key it still returns the insertion hint
+            auto p = this->m_container.equal_range(_key);
+            return typename Base::RangeType(p.first, p.second);
         }
-        inline typename Base::ConstRangeType findRange(const typename Base::KeyType_impl& _key) const
+        template<typename LookupKeyT = typename Base::KeyType_impl>
+        inline typename Base::ConstRangeType findRange(const LookupKeyT& _key) const
         {
-            typename Base::RangeType range =
-                const_cast<typename std::decay<decltype(*this)>::type&>(*this).findRange(_key);
-            return typename Base::ConstRangeType(range.first, range.second);
+            auto p = this->m_container.equal_range(_key);
+            return typename Base::ConstRangeType(p.first, p.second);
         }
     };
 
@@ -623,12 +652,14 @@ namespace impl
             return false;
         }
 
-        inline bool findAndStoreRange(const typename Base::KeyType_impl& _key, size_t& _inOutStorageSize, typename Base::MutablePairType* _out) const
+        template<typename LookupKeyT = typename Base::KeyType_impl>
+        inline bool findAndStoreRange(const LookupKeyT& _key, size_t& _inOutStorageSize, typename Base::MutablePairType* _out) const
         {
             return this->outputRange(this->findRange(_key), _inOutStorageSize, _out);
         }
 
-        inline bool findAndStoreRange(const typename Base::KeyType_impl& _key, size_t& _inOutStorageSize, typename Base::ValueType_impl* _out) const
+        template<typename LookupKeyT = typename Base::KeyType_impl>
+        inline bool findAndStoreRange(const LookupKeyT& _key, size_t& _inOutStorageSize, typename Base::ValueType_impl* _out) const
         {
             return this->outputRange(this->findRange(_key), _inOutStorageSize, _out);
         }
@@ -727,7 +758,7 @@ class NBL_FORCE_EBO CMultiObjectCache<K, T, ContainerT_T, Alloc, false> :
     public impl::CDirectMultiCacheBase<false, ContainerT_T, Alloc, T, const K>,
     public impl::PropagTypedefs<T, const K>
 {
-    static_assert(impl::is_same_templ<ContainerT_T, std::multimap>::value || impl::is_same_templ<ContainerT_T, std::unordered_multimap>::value, "ContainerT_T must be one of: std::vector, std::multimap, std::unordered_multimap");
+    static_assert(impl::is_multi_container<ContainerT_T>::value, "ContainerT_T must be one of: std::vector, std::multimap, std::unordered_multimap, core::stable_flat_hash_multimap");
 
 private:
     using Base = impl::CDirectMultiCacheBase<false, ContainerT_T, Alloc, T, const K>;
@@ -772,7 +803,7 @@ class NBL_FORCE_EBO CObjectCache<K, T, ContainerT_T, Alloc, false> :
     public impl::CDirectUniqCacheBase<false, ContainerT_T, Alloc, T, const K>,
     public impl::PropagTypedefs<T, const K>
 {
-    static_assert(impl::is_same_templ<ContainerT_T, std::map>::value || impl::is_same_templ<ContainerT_T, std::unordered_map>::value, "ContainerT_T must be one of: std::vector, std::map, std::unordered_map");
+    static_assert(impl::is_assoc_container<ContainerT_T>::value && !impl::is_multi_container<ContainerT_T>::value, "ContainerT_T must be one of: std::vector, std::map, std::unordered_map, core::stable_flat_hash_map");
     using Base = impl::CDirectUniqCacheBase<false, ContainerT_T, Alloc, T, const K>;
 
 public:
@@ -0,0 +1,354 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef __NBL_C_SHARDED_OBJECT_CACHE_H_INCLUDED__
+#define __NBL_C_SHARDED_OBJECT_CACHE_H_INCLUDED__
+
+#include "CObjectCache.h"
+#include "nbl/core/containers/stable_flat_hash_map.h"
+
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <thread>
+
+namespace nbl { namespace core
+{
+
+namespace impl
+{
+    //! Reader-writer lock for each of `ShardCount` shards, tuned for lookups being far more common than modifications.
+    /** Instead of every reader incrementing the same counter (and bouncing its cache line between cores), a reader only bumps
+    the counter of its own thread's slot, announcing it's inside the shard (like announcing the epoch in epoch based reclamation).
+    A writer raises the shard's flag and waits until the counters of all slots drain, readers seeing the flag back off until it's gone,
+    so writers can't be starved by a stream of readers. Reads of the same shard must not nest on one thread. */
+    template<uint32_t ShardCount>
+    class CShardedReadMostlyLock
+    {
+        public:
+            _NBL_STATIC_INLINE_CONSTEXPR uint32_t ReaderSlotCount = 16u;
+            _NBL_STATIC_INLINE_CONSTEXPR size_t CacheLineSize = 64ull;
+
+            CShardedReadMostlyLock() = default;
+            CShardedReadMostlyLock(const CShardedReadMostlyLock&) = delete;
+            CShardedReadMostlyLock& operator=(const CShardedReadMostlyLock&) = delete;
+
+            inline void lock_read(const uint32_t shard) const
+            {
+                auto& counter = m_readers[getThreadSlot()].counts[shard];
+                uint32_t i = 0u;
+                while (true)
+                {
+                    counter.fetch_add(1u,std::memory_order_seq_cst);
+                    if (!m_writers[shard].flag.load(std::memory_order_seq_cst))
+                        return;
+                    // let the writer through
+                    counter.fetch_sub(1u,std::memory_order_relaxed);
+                    while (m_writers[shard].flag.load(std::memory_order_relaxed))
+                        spin(i);
+                }
+            }
+            inline void unlock_read(const uint32_t shard) const
+            {
+                m_readers[getThreadSlot()].counts[shard].fetch_sub(1u,std::memory_order_release);
+            }
+
+            inline void lock_write(const uint32_t shard) const
+            {
+                uint32_t i = 0u;
+                while (m_writers[shard].flag.exchange(1u,std::memory_order_seq_cst))
+                    spin(i);
+                for (const auto& slot : m_readers)
+                while (slot.counts[shard].load(std::memory_order_seq_cst))
+                    spin(i);
+            }
+            inline void unlock_write(const uint32_t shard) const
+            {
+                m_writers[shard].flag.store(0u,std::memory_order_release);
+            }
+
+        private:
+            static inline constexpr uint32_t SpinsBeforeYield = 5000u;
+
+            static inline void spin(uint32_t& i)
+            {
+                if (i++>=SpinsBeforeYield)
+                    std::this_thread::yield();
+            }
+            //! Threads only need to be spread over the slots, two threads sharing a slot is still correct (just slower)
+            static inline uint32_t getThreadSlot()
+            {
+                static std::atomic_uint32_t nextSlot = 0u;
+                thread_local const uint32_t slot = nextSlot.fetch_add(1u,std::memory_order_relaxed)%ReaderSlotCount;
+                return slot;
+            }
+
+            struct alignas(CacheLineSize) SReaderSlot
+            {
+                std::atomic_uint32_t counts[ShardCount] = {};
+            };
+            struct alignas(CacheLineSize) SWriterFlag
+            {
+                std::atomic_uint32_t flag = 0u;
+            };
+
+            mutable SReaderSlot m_readers[ReaderSlotCount];
+            mutable SWriterFlag m_writers[ShardCount];
+    };
+
+    //! Splits the keys of a cache between `ShardCount` independently locked copies of `CacheT`, so writers only block the lookups of their own shard
+    template<typename CacheT, uint32_t ShardCount>
+    class CMakeCacheSharded
+    {
+        static_assert(ShardCount>1u && std::has_single_bit(ShardCount), "ShardCount must be a Power of Two greater than 1");
+
+        // the `_impl` typedefs are only visible to derived classes
+        class CShard final : public CacheT
+        {
+            public:
+                using CacheT::CacheT;
+                using typename CacheT::KeyType_impl;
+                using typename CacheT::ValueType_impl;
+                using typename CacheT::ImmutableValueType_impl;
+        };
+        using BaseCache = CShard;
+        using K = typename BaseCache::KeyType_impl;
+        using T = typename BaseCache::CachedType;
+        using lock_t = CShardedReadMostlyLock<ShardCount>;
+
+        struct SReadGuard
+        {
+            SReadGuard(const lock_t& _lock, const uint32_t _shard) : lock(_lock), shard(_shard) {lock.lock_read(shard);}
+            ~SReadGuard() {lock.unlock_read(shard);}
+
+            const lock_t& lock;
+            const uint32_t shard;
+        };
+        struct SWriteGuard
+        {
+            SWriteGuard(const lock_t& _lock, const uint32_t _shard) : lock(_lock), shard(_shard) {lock.lock_write(shard);}
+            ~SWriteGuard() {lock.unlock_write(shard);}
+
+            const lock_t& lock;
+            const uint32_t shard;
+        };
+
+    public:
+        using PairType = typename BaseCache::PairType;
+        using MutablePairType = typename BaseCache::MutablePairType;
+        using CachedType = T;
+        using KeyType = typename BaseCache::KeyType;
+        using GreetFuncType = typename BaseCache::GreetFuncType;
+        using DisposalFuncType = typename BaseCache::DisposalFuncType;
+
+        _NBL_STATIC_INLINE_CONSTEXPR uint32_t shard_count = ShardCount;
+
+        //! Every shard gets constructed with a copy of the arguments (e.g. the greeting and disposal functions)
+        template<typename... Args>
+        explicit CMakeCacheSharded(const Args&... args)
+        {
+            for (auto& shard : m_shards)
+                shard = std::make_unique<BaseCache>(args...);
+        }
+        // same as `CConcurrentObjectCacheBase`
+        CMakeCacheSharded(const CMakeCacheSharded&) = delete;
+        CMakeCacheSharded(CMakeCacheSharded&&) = delete;
+        CMakeCacheSharded& operator=(const CMakeCacheSharded&) = delete;
+        CMakeCacheSharded& operator=(CMakeCacheSharded&&) = delete;
+
+        //! Works with anything `core::transparent_hash` of the key type accepts, so a `std::string` keyed cache can be searched with a `std::string_view`
+        template<typename LookupKeyT>
+        static inline uint32_t getShardIndex(const LookupKeyT& _key)
+        {
+            // `std::hash` is the identity for pointers and integers, so mix before taking the top bits
+            uint64_t h = transparent_hash<std::remove_cv_t<K>>()(_key);
+            h ^= h>>33u;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h>>33u;
+            h *= 0xc4ceb9fe1a85ec53ull;
+            h ^= h>>33u;
+            return static_cast<uint32_t>(h>>(64u-std::countr_zero(ShardCount)));
+        }
+
+        inline bool insert(const typename BaseCache::KeyType_impl& _key, const typename BaseCache::ValueType_impl& _val)
+        {
+            const uint32_t ix = getShardIndex(_key);
+            SWriteGuard lk(m_lock,ix);
+            return m_shards[ix]->insert(_key,_val);
+        }
+
+        inline bool contains(typename BaseCache::ImmutableValueType_impl& _object) const
+        {
+            // we don't know the key, so have to go through all shards
+            for (uint32_t i=0u; i<ShardCount; i++)
+            {
+                SReadGuard lk(m_lock,i);
+                if (m_shards[i]->contains(_object))
+                    return true;
+            }
+            return false;
+        }
+
+        //! Shards are counted one after the other, so concurrent modifications can make the sum slightly off
+        inline size_t getSize() const
+        {
+            size_t retval = 0ull;
+            for (uint32_t i=0u; i<ShardCount; i++)
+            {
+                SReadGuard lk(m_lock,i);
+                retval += m_shards[i]->getSize();
+            }
+            return retval;
+        }
+
+        inline void clear()
+        {
+            for (uint32_t i=0u; i<ShardCount; i++)
+            {
+                SWriteGuard lk(m_lock,i);
+                m_shards[i]->clear();
+            }
+        }
+
+        //! Returns true if had to insert
+        bool swapObjectValue(const typename BaseCache::KeyType_impl& _key, const typename BaseCache::ImmutableValueType_impl& _obj, const typename BaseCache::ValueType_impl& _val)
+        {
+            const uint32_t ix = getShardIndex(_key);
+            SWriteGuard lk(m_lock,ix);
+            return m_shards[ix]->swapObjectValue(_key,_obj,_val);
+        }
+
+        bool getAndStoreKeyRangeOrReserve(const typename BaseCache::KeyType_impl& _key, size_t& _inOutStorageSize, typename BaseCache::ValueType_impl* _out, bool* _gotAll)
+        {
+            const uint32_t ix = getShardIndex(_key);
+            SWriteGuard lk(m_lock,ix);
+            return m_shards[ix]->getAndStoreKeyRangeOrReserve(_key,_inOutStorageSize,_out,_gotAll);
+        }
+
+        inline bool removeObject(const typename BaseCache::ValueType_impl& _obj, const typename BaseCache::KeyType_impl& _key)
+        {
+            const uint32_t ix = getShardIndex(_key);
+            SWriteGuard lk(m_lock,ix);
+            return m_shards[ix]->removeObject(_obj,_key);
+        }
+
+        template<typename LookupKeyT = typename BaseCache::KeyType_impl>
+        inline bool findAndStoreRange(const LookupKeyT& _key, size_t& _inOutStorageSize, typename BaseCache::MutablePairType* _out) const
+        {
+            const uint32_t ix = getShardIndex(_key);
+            SReadGuard lk(m_lock,ix);
+            return m_shards[ix]->findAndStoreRange(_key,_inOutStorageSize,_out);
+        }
+
+        template<typename LookupKeyT = typename BaseCache::KeyType_impl>
+        inline bool findAndStoreRange(const LookupKeyT& _key, size_t& _inOutStorageSize, typename BaseCache::ValueType_impl* _out) const
+        {
+            const uint32_t ix = getShardIndex(_key);
+            SReadGuard lk(m_lock,ix);
+            return m_shards[ix]->findAndStoreRange(_key,_inOutStorageSize,_out);
+        }
+
+        //! Same semantics as `CObjectCacheBase::outputAll`, all shards are read locked for the duration so the output is a consistent snapshot
+        inline bool outputAll(size_t& _inOutStorageSize, MutablePairType* _out) const
+        {
+            return outputAll_impl(_inOutStorageSize,_out);
+        }
+        inline bool outputAll(size_t& _inOutStorageSize, typename BaseCache::ValueType_impl* _out) const
+        {
+            return outputAll_impl(_inOutStorageSize,_out);
+        }
+
+        //! The object can move to a different shard, in which case both get locked (always in ascending order, so there's no deadlock)
+        inline bool changeObjectKey(const typename BaseCache::ValueType_impl& _obj, const typename BaseCache::KeyType_impl& _key, const typename BaseCache::KeyType_impl& _newKey)
+        {
+            const uint32_t oldIx = getShardIndex(_key);
+            const uint32_t newIx = getShardIndex(_newKey);
+            if (oldIx==newIx)
+            {
+                SWriteGuard lk(m_lock,oldIx);
+                return m_shards[oldIx]->changeObjectKey(_obj,_key,_newKey);
+            }
+
+            SWriteGuard lk0(m_lock,std::min(oldIx,newIx));
+            SWriteGuard lk1(m_lock,std::max(oldIx,newIx));
+            // same as `CDirectCacheBase::changeObjectKey`, the object stays in the cache so it doesn't get greeted or disposed
+            constexpr bool DoGreetOrDispose = false;
+            if (m_shards[oldIx]->template removeObject<DoGreetOrDispose>(_obj,_key))
+            {
+                m_shards[newIx]->template insert<DoGreetOrDispose>(_newKey,_obj);
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        template<typename StorageT>
+        inline bool outputAll_impl(size_t& _inOutStorageSize, StorageT* _out) const
+        {
+            for (uint32_t i=0u; i<ShardCount; i++)
+                m_lock.lock_read(i);
+
+            size_t reqSize = 0ull;
+            for (const auto& shard : m_shards)
+                reqSize += shard->getSize();
+
+            bool res = false;
+            if (!_out)
+                _inOutStorageSize = reqSize;
+            else
+            {
+                size_t written = 0ull;
+                for (const auto& shard : m_shards)
+                {
+                    size_t shardStorageSize = _inOutStorageSize-written;
+                    if (!shardStorageSize)
+                        break;
+                    shard->outputAll(shardStorageSize,_out+written);
+                    written += shardStorageSize;
+                }
+                res = _inOutStorageSize<=reqSize;
+                _inOutStorageSize = written;
+            }
+
+            for (uint32_t i=0u; i<ShardCount; i++)
+                m_lock.unlock_read(i);
+            return res;
+        }
+
+        lock_t m_lock;
+        std::unique_ptr<BaseCache> m_shards[ShardCount];
+    };
+}
+
+//! Drop-in replacement for `CConcurrentObjectCache` which doesn't serialize every access on a single lock, for caches being filled and queried by many threads at once
+template<
+    typename K,
+    typename T,
+    template<typename...> class ContainerT_T = std::vector,
+    typename Alloc = core::allocator<typename impl::key_val_pair_type_for<ContainerT_T, K, T>::type>,
+    uint32_t ShardCount = 16u
+>
+using CShardedObjectCache =
+    impl::CMakeCacheSharded<
+        CObjectCache<K, T, ContainerT_T, Alloc>,
+        ShardCount
+    >;
+
+//! Drop-in replacement for `CConcurrentMultiObjectCache`, all objects with the same key end up in the same shard
+template<
+    typename K,
+    typename T,
+    template<typename...> class ContainerT_T = std::vector,
+    typename Alloc = core::allocator<typename impl::key_val_pair_type_for<ContainerT_T, K, T>::type>,
+    uint32_t ShardCount = 16u
+>
+using CShardedMultiObjectCache =
+    impl::CMakeCacheSharded<
+        CMultiObjectCache<K, T, ContainerT_T, Alloc>,
+        ShardCount
+    >;
+
+}}
+
+#endif
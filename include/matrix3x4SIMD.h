@@ -155,6 +155,17 @@ class matrix3x4SIMD// : private AllocationOverrideBase<_NBL_MATRIX_ALIGNMENT> EB
 			mulSub3x3WithNx1(_in_out, _in_out);
 		}
 
+		//! Batched `pseudoMulWith4x1` of `_count` 3D points, each point being 3 floats and `_inStride`/`_outStride` bytes after the previous one.
+		/** The strides let the points be interleaved with other vertex attributes, only 3 floats per output point get written.
+		Transforming in-place (`_out==_in` and equal strides) is fine, other kinds of overlap are not.
+		Uses the widest of SSE, AVX2 and AVX-512 the CPU supports, picked at runtime. */
+		NBL_API2 void transformPoints(float* _out, size_t _outStride, const float* _in, size_t _inStride, size_t _count) const;
+		//! Batched `mulSub3x3WithNx1`, same as `transformPoints` but without translation. For normals use the matrix from `getSub3x3InverseTranspose`
+		NBL_API2 void transformDirections(float* _out, size_t _outStride, const float* _in, size_t _inStride, size_t _count) const;
+		//! Structure of Arrays variants, `_in[i]` and `_out[i]` point at the `i`-th components of all the vectors
+		NBL_API2 void transformPointsSoA(float* const _out[3], const float* const _in[3], size_t _count) const;
+		NBL_API2 void transformDirectionsSoA(float* const _out[3], const float* const _in[3], size_t _count) const;
+
 		inline static matrix3x4SIMD buildCameraLookAtMatrixLH(
 			const vectorSIMDf& position,
 			const vectorSIMDf& target,
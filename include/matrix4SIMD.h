@@ -316,6 +316,13 @@ class matrix4SIMD// : public AlignedBase<_NBL_SIMD_ALIGNMENT> don't inherit from
 			transformVect(_vector, _vector);
 		}
 
+		//! Batched `transformVect` of `_count` 3D points with an implicit `w=1`, each input point being 3 floats `_inStride` bytes after the previous one.
+		/** Every output is the full homogeneous 4 floats, `_outStride` bytes apart. The input and output must not overlap.
+		Uses the widest of SSE, AVX2 and AVX-512 the CPU supports, picked at runtime. */
+		NBL_API2 void transformPoints(float* _out, size_t _outStride, const float* _in, size_t _inStride, size_t _count) const;
+		//! Structure of Arrays variant, `_in[i]` and `_out[i]` point at the `i`-th components of all the vectors
+		NBL_API2 void transformPointsSoA(float* const _out[4], const float* const _in[3], size_t _count) const;
+
 		inline void translateVect(vectorSIMDf& _vect) const
 		{
 			_vect += getTranslation();
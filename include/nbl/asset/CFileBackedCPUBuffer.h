@@ -0,0 +1,72 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_ASSET_C_FILE_BACKED_CPU_BUFFER_H_INCLUDED_
+#define _NBL_ASSET_C_FILE_BACKED_CPU_BUFFER_H_INCLUDED_
+
+#include <mutex>
+
+#include "nbl/system/IFile.h"
+
+#include "nbl/asset/ICPUBuffer.h"
+
+namespace nbl::asset
+{
+
+//! ICPUBuffer whose contents are a range of a file, read in only when they're needed
+/**
+	Nothing gets allocated or read on creation. The contents get read in pages of `PageSize` bytes, all of them on the first `getPointer()`,
+	or only the ones overlapping the range passed to `getPointer(offset,size)` or `prefetch()`. The memory for the whole buffer gets allocated
+	with the first page, so the pointers stay valid until `drop()`.
+
+	`drop()` releases the memory, the next access reads the file again. Modifications are lost then, and all the pointers returned before dangle.
+
+	The buffer keeps the file open and the file must not change while the buffer exists. Loaders create these with `IAssetLoader::ELPF_LAZY_BUFFERS`.
+
+	When restored from a dummy it takes over the file of another `CFileBackedCPUBuffer`, or copies the contents of any other buffer and
+	stops being backed by a file, `getFile()` returns null and `drop()` does nothing from then on.
+*/
+class NBL_API2 CFileBackedCPUBuffer final : public ICPUBuffer
+{
+	public:
+		_NBL_STATIC_INLINE_CONSTEXPR size_t PageSize = 64ull<<10ull;
+
+		CFileBackedCPUBuffer(core::smart_refctd_ptr<system::IFile>&& _file, const size_t _fileOffset, const size_t _size);
+
+		//! Reads in the pages overlapping the range, if they aren't already, returns false if the file couldn't be read
+		bool prefetch(const size_t offset = 0ull, const size_t size = ~0ull);
+		//! Releases the memory, see the class description, does nothing without a file to read the contents from again
+		void drop();
+
+		//! Bytes currently in memory
+		size_t getResidentSize() const;
+		inline const system::IFile* getFile() const { return m_file.get(); }
+		inline size_t getFileOffset() const { return m_fileOffset; }
+
+	protected:
+		~CFileBackedCPUBuffer();
+
+		void* pageIn(const size_t offset, const size_t size) override;
+		void freeData() override;
+		void restoreFromDummy_impl(IAsset* _other, uint32_t _levelsBelow) override;
+		void* exchangeData(void* _data) override;
+
+	private:
+		// caller holds the lock
+		uint8_t* pageIn_impl(const size_t offset, const size_t size);
+		void release();
+		// takes ownership of `_storage` holding all the contents, which no longer come from a file
+		void adopt(uint8_t* _storage);
+
+		core::smart_refctd_ptr<system::IFile> m_file;
+		size_t m_fileOffset;
+
+		mutable std::mutex m_lock;
+		uint8_t* m_storage = nullptr;
+		core::vector<bool> m_residentPages;
+		size_t m_residentPageCount = 0ull;
+};
+
+}
+
+#endif
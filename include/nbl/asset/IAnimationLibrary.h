@@ -119,6 +119,12 @@ class IAnimationLibrary : public virtual core::IReferenceCounted
 			return reinterpret_cast<const SBufferRange<const BufferType>&>(m_animationStorageRange);
 		}
 
+		//
+		inline uint32_t getKeyframeCount() const
+		{
+			return m_keyframeCount;
+		}
+
 		//
 		inline uint32_t getAnimationCapacity() const
 		{
@@ -134,6 +140,13 @@ class IAnimationLibrary : public virtual core::IReferenceCounted
 				return found->second;
 			return getAnimationCapacity();
 		}
+		//! Calls `f(name,animationOffset)` for every named animation
+		template<typename F>
+		inline void forEachAnimationName(F&& f) const
+		{
+			for (const auto& entry : m_nameToAnimation)
+				f(m_stringPool.data()+entry.first,entry.second);
+		}
 
 
 	protected:
@@ -169,8 +169,56 @@ class IAsset : virtual public core::IReferenceCounted
 		*/
 		virtual size_t conservativeSizeEstimate() const = 0; // TODO: this shouldn't be a method of IAsset but BlobSerializable ?
 
+		//! Gathers the clones made on the calling thread during its lifetime, so that a DAG gets cloned into a DAG
+		/**
+			Without a session every reference gets cloned anew, so an asset referenced by N others ends up cloned N times.
+			With one, each (asset,depth) gets cloned once and every later reference to it gets the same clone.
+
+			Large buffer contents are not copied straight away, they get copied in parallel on `core::CThreadPool::getDefault()`
+			right before the outermost `clone()` returns, so `clone_impl` overrides must not read the contents of the buffers they cloned.
+			The session keeps a reference to every asset it cloned, so the memoized clones can't get mixed up by an address getting reused.
+			Sessions nest, the innermost one is used.
+		*/
+		class NBL_API2 SCloneSession final : public core::Uncopyable
+		{
+			public:
+				//! Copies smaller than this are done right away, there's no point in deferring them
+				_NBL_STATIC_INLINE_CONSTEXPR size_t ParallelCopyThreshold = 64ull<<10ull;
+				//! Size of the pieces large copies get split into
+				_NBL_STATIC_INLINE_CONSTEXPR size_t ParallelCopyChunkSize = 1ull<<20ull;
+
+				SCloneSession();
+				//! Flushes
+				~SCloneSession();
+
+				//! The innermost session open on the calling thread, null if none
+				static SCloneSession* getCurrent();
+
+				//! Performs all the deferred copies, the memoized clones are kept
+				/** Happens by itself when the outermost `clone()` returns, only needed after calling `copy` directly. */
+				void flush();
+
+				//! For `clone_impl` overrides, copies right away or defers the copy until `flush()` depending on the size
+				void copy(void* dst, const void* src, const size_t size);
+
+			private:
+				friend class IAsset;
+
+				core::smart_refctd_ptr<IAsset> clone(const IAsset* _asset, uint32_t _depth);
+
+				struct SState;
+				SState* m_state;
+				SCloneSession* m_previous;
+		};
+
 		//! creates a copy of the asset, duplicating dependant resources up to a certain depth (default duplicate everything)
-        virtual core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const = 0;
+		/** Inside an `SCloneSession` the clones are shared by everything referencing the same asset. */
+		inline core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const
+		{
+			if (auto* session=SCloneSession::getCurrent())
+				return session->clone(this,_depth);
+			return clone_impl(_depth);
+		}
 
 		// TODO: `_other` should probably be const qualified!
 		inline bool restoreFromDummy(IAsset* _other, uint32_t _levelsBelow = (~0u))
@@ -226,6 +274,9 @@ class IAsset : virtual public core::IReferenceCounted
 
 		virtual void restoreFromDummy_impl(IAsset* _other, uint32_t _levelsBelow) = 0;
 
+		//! The actual cloning, dependencies must be cloned with `clone` (not `clone_impl`) so they get shared within an `SCloneSession`
+		virtual core::smart_refctd_ptr<IAsset> clone_impl(uint32_t _depth) const = 0;
+
 		// returns if any of `this`'s up to `_levelsBelow` levels below is dummy
 		virtual bool isAnyDependencyDummy_impl(uint32_t _levelsBelow) const { return false; }
 
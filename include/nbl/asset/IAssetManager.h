@@ -6,11 +6,17 @@
 #define __NBL_ASSET_I_ASSET_MANAGER_H_INCLUDED__
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <ostream>
+#include <span>
 
 #include "nbl/core/declarations.h"
+#include "nbl/core/execution.h"
 #include "nbl/system/path.h"
 #include "CConcurrentObjectCache.h"
+#include "CShardedObjectCache.h"
 
 #include "nbl/system/ISystem.h"
 #include "nbl/system/IFile.h"
@@ -18,6 +24,7 @@
 #include "nbl/asset/interchange/IAssetWriter.h"
 
 #include "nbl/asset/utils/CCompilerSet.h"
+#include "nbl/asset/utils/CAssetDeduplicator.h"
 #include "nbl/asset/utils/IGeometryCreator.h"
 
 
@@ -36,8 +43,9 @@ std::function<void(SAssetBundle&)> makeAssetDisposeFunc(const IAssetManager* con
 //! Class responsible for handling loading of assets from file system or other resources
 /**
 	It provides a loading, writing and creation functionality that is almost thread-safe.
-	There is one issue with threading, starting loading the same asset at the exact same time 
-	may end up with two copies in the cache.
+	Loading the same file on two threads at the exact same time does the work twice, but only the bundle which gets
+	into the cache first is kept and returned to both, so the cache never ends up with two copies.
+	Loaders which insert their own intermediate assets into the cache (see IAssetLoaderOverride::insertAssetIntoCache) don't get that guarantee.
 
 	IAssetManager performs caching of CPU assets associated with resource handles such as names, 
 	filenames, UUIDs. However there are separate caches for each asset type.
@@ -53,12 +61,14 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
 
     public:
 #ifdef USE_MAPS_FOR_PATH_BASED_CACHE
-        using AssetCacheType = core::CConcurrentMultiObjectCache<std::string, SAssetBundle, std::multimap>;
+        // hash based so that lookups are O(1) and can be done with a `std::string_view` without allocating,
+        // sharded so that loaders inserting on other threads only block the lookups of keys in the same shard
+        using AssetCacheType = core::CShardedMultiObjectCache<std::string, SAssetBundle, core::stable_flat_hash_multimap>;
 #else
-        using AssetCacheType = core::CConcurrentMultiObjectCache<std::string, IAssetBundle, std::vector>;
+        using AssetCacheType = core::CShardedMultiObjectCache<std::string, IAssetBundle, std::vector>;
 #endif //USE_MAPS_FOR_PATH_BASED_CACHE
 
-        using CpuGpuCacheType = core::CConcurrentObjectCache<const IAsset*, core::smart_refctd_ptr<core::IReferenceCounted> >;
+        using CpuGpuCacheType = core::CShardedObjectCache<const IAsset*, core::smart_refctd_ptr<core::IReferenceCounted>, core::stable_flat_hash_map>;
 
     private:
         struct WriterKey
@@ -79,47 +89,194 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
             }
         };
 
-        template<typename T>
-        static void refCtdGreet(T* _asset) { _asset->grab(); }
-        template<typename T>
-        static void refCtdDispose(T* _asset) { _asset->drop(); }
-
         core::smart_refctd_ptr<system::ISystem> m_system;
         IAssetLoader::IAssetLoaderOverride m_defaultLoaderOverride;
 
         std::array<AssetCacheType*, IAsset::ET_STANDARD_TYPES_COUNT> m_assetCache;
         std::array<CpuGpuCacheType*, IAsset::ET_STANDARD_TYPES_COUNT> m_cpuGpuCache;
 
-        struct Loaders {
-            Loaders() : perFileExt{&refCtdGreet<IAssetLoader>, &refCtdDispose<IAssetLoader>} {}
-
-            core::vector<core::smart_refctd_ptr<IAssetLoader> > vector;
-            //! The key is file extension
-            core::CMultiObjectCache<std::string, IAssetLoader*, std::vector> perFileExt;
-
-            void pushToVector(core::smart_refctd_ptr<IAssetLoader>&& _loader)
-			{
-                vector.push_back(std::move(_loader));
-            }
-            void eraseFromVector(decltype(vector)::const_iterator _loaderItr)
-			{
-                vector.erase(_loaderItr);
-            }
-        } m_loaders;
-
-        struct Writers {
-            Writers() : perTypeAndFileExt{&refCtdGreet<IAssetWriter>, &refCtdDispose<IAssetWriter>}, perType{&refCtdGreet<IAssetWriter>, &refCtdDispose<IAssetWriter>} {}
-
-            core::CMultiObjectCache<WriterKey, IAssetWriter*, std::vector> perTypeAndFileExt;
-            core::CMultiObjectCache<IAsset::E_TYPE, IAssetWriter*, std::vector> perType;
-        } m_writers;
-
         friend class IAssetLoader;
         friend class IAssetLoader::IAssetLoaderOverride; // for access to non-const findAssets
 
         core::smart_refctd_ptr<IGeometryCreator> m_geometryCreator;
         core::smart_refctd_ptr<IMeshManipulator> m_meshManipulator;
         core::smart_refctd_ptr<CCompilerSet> m_compilerSet;
+        core::smart_refctd_ptr<CAssetDeduplicator> m_deduplicator = core::make_smart_refctd_ptr<CAssetDeduplicator>();
+
+        // Bookkeeping for the byte budgets of the asset caches, done by the greet and dispose functions of the caches.
+        // Lock order is cache shard then accounting, eviction never holds the latter while modifying a cache.
+        struct SCacheAccounting
+        {
+            struct SUsage
+            {
+                // only used for identifying the bundle, never dereferenced outside the lock
+                const IAsset* firstAsset;
+                // sizes can change while cached, so remember what got added
+                uint64_t bytes;
+                uint64_t lastUse;
+                // inserted as immutable, which only the builtins are, never evicted
+                bool builtin;
+            };
+
+            std::mutex lock;
+            core::unordered_map<std::string,core::vector<SUsage>> usage;
+            uint64_t bytesCached = 0ull;
+            uint64_t byteBudget = 0ull;
+            uint64_t bundleCount = 0ull;
+            uint64_t hits = 0ull;
+            uint64_t evictions = 0ull;
+            uint64_t evictedBytes = 0ull;
+        };
+        mutable std::array<SCacheAccounting,IAsset::ET_STANDARD_TYPES_COUNT> m_cacheAccounting;
+        mutable std::atomic_uint64_t m_cacheUseClock = 0ull;
+        std::atomic_uint64_t m_loadCacheHits = 0ull;
+        std::atomic_uint64_t m_loadCacheMisses = 0ull;
+
+        void accountCachedBundle(const SAssetBundle& _bundle, const bool _inserted) const;
+        void touchCachedBundles(const uint32_t _typeIx, const SAssetBundle* _bundles, const size_t _count) const;
+        void changeCachedBundleKey(const SAssetBundle& _bundle, const std::string& _oldKey, const std::string& _newKey);
+        void evictToBudget(const uint32_t _typeIx);
+
+        // Which files needed which other files while loading, keyed by cache key, edges get recorded whenever a load or a findAssets which found something happens inside of a IAssetLoader::SLoadScope
+        struct SDependencyGraph
+        {
+            std::mutex lock;
+            core::unordered_map<std::string,core::unordered_set<std::string>> dependencies;
+            core::unordered_map<std::string,core::unordered_set<std::string>> dependents;
+            // keys loaders inserted their intermediate assets under (like "file.mtl?derivative_map"), mapped to the file being loaded at the time
+            core::unordered_map<std::string,std::string> intermediateOwners;
+        };
+        mutable SDependencyGraph m_dependencyGraph;
+
+        // records `_key` as a dependency of whatever is being loaded on this thread, if anything
+        void recordDependency(const std::string& _key) const;
+        void recordIntermediateInsertion(const std::string& _key);
+        // so that a reload records them anew, files can stop depending on others, returns what they were
+        core::unordered_set<std::string> forgetDependencies(const std::string& _key);
+        // the intermediates would get found in the cache and reused instead of being made anew from the changed file
+        void removeIntermediates(const std::string& _key);
+
+        // Per loader and writer counters, only updated while `m_statisticsEnabled`.
+        // The entries get made when the loaders and writers are added and live in the registry with them, shared by all its copies.
+        struct SLoaderCounters final : public core::IReferenceCounted
+        {
+            std::atomic_uint64_t calls = 0ull;
+            std::atomic_uint64_t failures = 0ull;
+            std::atomic_uint64_t inputFileBytes = 0ull;
+            std::atomic_uint64_t wallTimeNs = 0ull;
+            std::atomic_uint64_t dependencyTimeNs = 0ull;
+            std::array<std::atomic_uint64_t,IAsset::ET_STANDARD_TYPES_COUNT> cacheHits = {};
+            std::array<std::atomic_uint64_t,IAsset::ET_STANDARD_TYPES_COUNT> cacheMisses = {};
+        };
+        struct SWriterCounters final : public core::IReferenceCounted
+        {
+            std::atomic_uint64_t calls = 0ull;
+            std::atomic_uint64_t failures = 0ull;
+            std::atomic_uint64_t bytesWritten = 0ull;
+            std::atomic_uint64_t wallTimeNs = 0ull;
+        };
+        std::atomic_bool m_statisticsEnabled = false;
+
+        // The loaders and writers. Nothing modifies a registry once it's published, every change copies the current one and swaps the pointer,
+        // so lookups never take a lock and loaders can be added and removed while loads are running. The loads which started before keep
+        // using the registry they grabbed, which keeps its loaders alive, and the last of them frees it.
+        struct SRegistry
+        {
+            core::vector<core::smart_refctd_ptr<IAssetLoader>> loaders;
+            //! The key is file extension, the loaders are in the order they got added
+            core::unordered_map<std::string,core::vector<IAssetLoader*>> loadersPerFileExt;
+            //! For when the extension is unknown or wrong, checked against the sniffed header in the order the loaders got added
+            core::vector<std::pair<IAssetLoader::SMagicNumber,IAssetLoader*>> loadersPerMagicNumber;
+            core::unordered_map<const IAssetLoader*,core::smart_refctd_ptr<SLoaderCounters>> loaderCounters;
+
+            core::vector<core::smart_refctd_ptr<IAssetWriter>> writers;
+            core::map<WriterKey,core::vector<IAssetWriter*>> writersPerTypeAndFileExt;
+            core::map<IAsset::E_TYPE,core::vector<IAssetWriter*>> writersPerType;
+            core::unordered_map<const IAssetWriter*,core::smart_refctd_ptr<SWriterCounters>> writerCounters;
+        };
+        // the atomic shared pointer can't let the count drop to zero between reading the pointer and taking a reference, unlike a raw one
+        std::atomic<std::shared_ptr<const SRegistry>> m_registry = std::make_shared<const SRegistry>();
+        // only the changes lock, to not lose each other's updates
+        std::mutex m_registryChangeLock;
+        // the registry doesn't get freed while this exists
+        class SRegistryReader final : public core::Uncopyable
+        {
+            public:
+                SRegistryReader(const IAssetManager* _mgr) : m_registry(_mgr->m_registry.load(std::memory_order_acquire)) {}
+
+                inline const SRegistry* operator->() const { return m_registry.get(); }
+                inline const SRegistry& operator*() const { return *m_registry; }
+
+            private:
+                std::shared_ptr<const SRegistry> m_registry;
+        };
+        // serialized with other changes, `_change` gets a copy of the current registry
+        void changeRegistry(const std::function<void(SRegistry&)>& _change);
+
+        // periodic dump, a zero period means none
+        std::mutex m_statisticsLogLock;
+        core::smart_refctd_ptr<system::ILogger> m_statisticsLogger;
+        std::atomic<std::chrono::steady_clock::rep> m_statisticsLogPeriod = 0;
+        std::atomic<std::chrono::steady_clock::rep> m_nextStatisticsLog = 0;
+
+        // the loader call running on a thread while statistics are enabled
+        struct SLoaderCall
+        {
+            SLoaderCounters* counters;
+            // cache key of the file it loads, loads on the same thread are its dependencies only while this is the innermost IAssetLoader::SLoadScope
+            const std::string* loading;
+            uint64_t dependencyTimeNs = 0ull;
+        };
+        static SLoaderCall*& getLoaderCallOnThisThread();
+        // the loader a load on this thread is a dependency of, if statistics are being gathered
+        inline SLoaderCall* getDependentLoaderCall() const
+        {
+            if (!m_statisticsEnabled.load(std::memory_order_relaxed))
+                return nullptr;
+            auto* call = getLoaderCallOnThisThread();
+            return call && call->loading==IAssetLoader::SLoadScope::getCurrent() ? call:nullptr;
+        }
+        // attributes the time and cache lookup of a dependency load to the loader which needed it, on whichever path getAssetInHierarchy_impl returns
+        class SDependencyLoadRecord final : public core::Uncopyable
+        {
+            public:
+                SDependencyLoadRecord(SLoaderCall* _call, const SAssetBundle& _loaded) : m_call(_call), m_loaded(_loaded)
+                {
+                    if (m_call)
+                        m_start = std::chrono::steady_clock::now();
+                }
+                ~SDependencyLoadRecord()
+                {
+                    if (!m_call)
+                        return;
+                    m_call->dependencyTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-m_start).count();
+                    if (m_hitType)
+                        m_call->counters->cacheHits[IAsset::typeFlagToIndex(m_hitType)].fetch_add(1ull,std::memory_order_relaxed);
+                    else if (m_missed && !m_loaded.getContents().empty())
+                        m_call->counters->cacheMisses[IAsset::typeFlagToIndex(m_loaded.getAssetType())].fetch_add(1ull,std::memory_order_relaxed);
+                }
+
+                inline void foundInCache(const IAsset::E_TYPE _type) { m_hitType = _type; }
+                inline void notInCache() { m_missed = true; }
+
+            private:
+                SLoaderCall* const m_call;
+                const SAssetBundle& m_loaded;
+                std::chrono::steady_clock::time_point m_start;
+                IAsset::E_TYPE m_hitType = static_cast<IAsset::E_TYPE>(0u);
+                bool m_missed = false;
+        };
+        // the calls to the loaders and writers go through these, to gather statistics when enabled
+        SAssetBundle callLoader(const SRegistry& _registry, IAssetLoader* _loader, system::IFile* _file, const std::string& _cacheKey, const IAssetLoader::SAssetLoadParams& _params, IAssetLoader::IAssetLoaderOverride* _override, const uint32_t _hierarchyLevel);
+        bool callWriter(const SRegistry& _registry, IAssetWriter* _writer, system::IFile* _file, const IAssetWriter::SAssetWriteParams& _params, IAssetWriter::IAssetWriterOverride* _override);
+        void logStatisticsIfDue(const std::chrono::steady_clock::time_point _now);
+
+        // makes looking for an earlier copy and inserting the freshly loaded bundle atomic, picked by the hash of the cache key
+        std::array<std::mutex,16> m_cacheInsertionLocks;
+        inline std::mutex& getCacheInsertionLock(const std::string_view _key)
+        {
+            return m_cacheInsertionLocks[std::hash<std::string_view>()(_key)%m_cacheInsertionLocks.size()];
+        }
         // called as a part of constructor only
         void initializeMeshTools();
 
@@ -146,6 +303,8 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
         const IGeometryCreator* getGeometryCreator() const;
         IMeshManipulator* getMeshManipulator();
         CCompilerSet* getCompilerSet() const { return m_compilerSet.get(); }
+        //! Used for the loads with `IAssetLoader::ELPF_DEDUPLICATE`, its statistics tell how much memory that saved
+        CAssetDeduplicator* getDeduplicator() const { return m_deduplicator.get(); }
 
     protected:
 		virtual ~IAssetManager()
@@ -168,6 +327,9 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
 					delete m_cpuGpuCache[i]; // drop on values (GPU objects) will be done by cache's destructor
 				}
 			}
+
+			// the loaders go before the rest of the manager, only the loads still running could be holding the registry
+			m_registry.store(nullptr);
 		}
 
 		//TODO change name
@@ -227,13 +389,23 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
 
             const uint64_t levelFlags = params.cacheFlags >> ((uint64_t)_hierarchyLevel * 2ull);
 
+            const std::string cacheKey = filename.string();
+            recordDependency(cacheKey);
+
             SAssetBundle bundle;
+            SDependencyLoadRecord dependencyRecord(getDependentLoaderCall(), bundle);
             if ((levelFlags & IAssetLoader::ECF_DUPLICATE_TOP_LEVEL) != IAssetLoader::ECF_DUPLICATE_TOP_LEVEL)
             {
-                auto found = findAssets(filename.string());
+                auto found = findAssets(cacheKey);
                 if (found->size())
+                {
+                    m_loadCacheHits.fetch_add(1ull,std::memory_order_relaxed);
+                    dependencyRecord.foundInCache(found->begin()->getAssetType());
                     return _override->chooseRelevantFromFound(found->begin(), found->end(), ctx, _hierarchyLevel);
-                else if (!(bundle = _override->handleSearchFail(filename.string(), ctx, _hierarchyLevel)).getContents().empty())
+                }
+                m_loadCacheMisses.fetch_add(1ull,std::memory_order_relaxed);
+                dependencyRecord.notInCache();
+                if (!(bundle = _override->handleSearchFail(cacheKey, ctx, _hierarchyLevel)).getContents().empty())
                     return bundle;
             }
 
@@ -241,24 +413,55 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
             if (!file)
                 return {};//return empty bundle
 
+            // everything the loader fetches from now on is a dependency of this file
+            IAssetLoader::SLoadScope loadScope(&cacheKey);
+            const SRegistryReader registry(this);
+            // read once for all the loaders to look at
+            std::array<uint8_t,IAssetLoader::SniffedHeaderSize> headerStorage;
+            const auto header = IAssetLoader::sniffHeader(file.get(), headerStorage);
+            core::vector<IAssetLoader*> triedLoaders;
+            auto tryLoader = [&](IAssetLoader* loader) -> bool
+            {
+                if (std::find(triedLoaders.begin(), triedLoaders.end(), loader) != triedLoaders.end())
+                    return false;
+                triedLoaders.push_back(loader);
+                return loader->isALoadableFileHeader(file.get(), header) && !(bundle = callLoader(*registry, loader, file.get(), cacheKey, params, _override, _hierarchyLevel)).getContents().empty();
+            };
+
             auto ext = system::extension_wo_dot(filename);
-            auto capableLoadersRng = m_loaders.perFileExt.findRange(ext);
             // loaders associated with the file's extension tryout
-            for (auto& loader : capableLoadersRng)
+            if (auto capableLoaders=registry->loadersPerFileExt.find(ext); capableLoaders!=registry->loadersPerFileExt.end())
+            for (auto* loader : capableLoaders->second)
             {
-                if (loader.second->isALoadableFileFormat(file.get()) && !(bundle = loader.second->loadAsset(file.get(), params, _override, _hierarchyLevel)).getContents().empty())
+                if (tryLoader(loader))
                     break;
             }
-            for (auto loaderItr = std::begin(m_loaders.vector); bundle.getContents().empty() && loaderItr != std::end(m_loaders.vector); ++loaderItr) // all loaders tryout
+            // then the ones the magic number points at
+            for (auto magicItr = std::begin(registry->loadersPerMagicNumber); bundle.getContents().empty() && magicItr != std::end(registry->loadersPerMagicNumber); ++magicItr)
             {
-                if ((*loaderItr)->isALoadableFileFormat(file.get()) && !(bundle = (*loaderItr)->loadAsset(file.get(), params, _override, _hierarchyLevel)).getContents().empty())
+                if (magicItr->first.matches(header) && tryLoader(magicItr->second))
+                    break;
+            }
+            for (auto loaderItr = std::begin(registry->loaders); bundle.getContents().empty() && loaderItr != std::end(registry->loaders); ++loaderItr) // all loaders tryout
+            {
+                if (tryLoader(loaderItr->get()))
                     break;
             }
 
+            // once for the whole hierarchy, the top level assets are what gets cached under the filename so they can't be swapped
+            if (_hierarchyLevel==0u && (params.loaderFlags&IAssetLoader::ELPF_DEDUPLICATE))
+            for (const auto& asset : bundle.getContents())
+                m_deduplicator->deduplicate(asset.get(),bundle.getMetadata(),true);
+
             if (!bundle.getContents().empty() && 
                 ((levelFlags & IAssetLoader::ECF_DONT_CACHE_TOP_LEVEL) != IAssetLoader::ECF_DONT_CACHE_TOP_LEVEL) &&
                 ((levelFlags & IAssetLoader::ECF_DUPLICATE_TOP_LEVEL) != IAssetLoader::ECF_DUPLICATE_TOP_LEVEL))
             {
+                // another thread could have loaded the same file in the meantime, the first bundle in the cache wins so everyone gets the same assets as if the loads happened one after another
+                std::unique_lock lock(getCacheInsertionLock(filename.string()));
+                auto found = findAssets(filename.string());
+                if (found->size())
+                    return _override->chooseRelevantFromFound(found->begin(), found->end(), ctx, _hierarchyLevel);
                 _override->insertAssetIntoCache(bundle, filename.string(), ctx, _hierarchyLevel);
             }
             else if (bundle.getContents().empty())
@@ -409,6 +612,47 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
             return getAsset(_file, _supposedFilename, _params, &m_defaultLoaderOverride);
         }
 
+        //! Loads many files at once on the threads of `core::CThreadPool::getDefault()`, returns the bundles in the order of `_filePaths`
+        /** Repeated paths get loaded once and share the bundle, the results are the same as calling getAsset() for every path in turn.
+        Loaders can load their own dependencies as parallel sub-tasks too, see IAssetLoader::interm_loadInParallel().
+        The loaders and the override must be safe to call from multiple threads at once. */
+        inline core::vector<SAssetBundle> getAssets(std::span<const system::path> _filePaths, const IAssetLoader::SAssetLoadParams& _params, IAssetLoader::IAssetLoaderOverride* _override)
+        {
+            core::vector<SAssetBundle> retval(_filePaths.size());
+
+            core::vector<std::string> keys(_filePaths.size());
+            core::vector<uint32_t> firstOccurence(_filePaths.size());
+            core::vector<uint32_t> uniqueIxs;
+            {
+                core::unordered_map<std::string_view,uint32_t> seen;
+                seen.reserve(_filePaths.size());
+                for (uint32_t i=0u; i<_filePaths.size(); i++)
+                {
+                    keys[i] = _filePaths[i].string();
+                    const auto found = seen.try_emplace(keys[i],i);
+                    firstOccurence[i] = found.first->second;
+                    if (found.second)
+                        uniqueIxs.push_back(i);
+                }
+            }
+
+            // every file is a lot of work, so don't batch them up
+            core::for_each(core::execution::par_pool.with_grain_size(1ull),uniqueIxs.begin(),uniqueIxs.end(),[&](const uint32_t i) -> void
+            {
+                // these are top level loads, even when a pool thread picks one up while it waits in the middle of another load
+                IAssetLoader::SLoadScope scope(nullptr);
+                retval[i] = getAsset(keys[i],_params,_override);
+            });
+            for (uint32_t i=0u; i<_filePaths.size(); i++)
+            if (firstOccurence[i]!=i)
+                retval[i] = retval[firstOccurence[i]];
+            return retval;
+        }
+        inline core::vector<SAssetBundle> getAssets(std::span<const system::path> _filePaths, const IAssetLoader::SAssetLoadParams& _params)
+        {
+            return getAssets(_filePaths, _params, &m_defaultLoaderOverride);
+        }
+
         SAssetBundle getAssetWholeBundleRestore(const std::string& _filename, const IAssetLoader::SAssetLoadParams& _params, IAssetLoader::IAssetLoaderOverride* _override)
         {
             return getAssetInHierarchyWholeBundleRestore(_filename, _params, 0u, _override);
@@ -450,7 +694,7 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
 			@see SAssetBundle
 			@see IAsset::E_TYPE
 		*/
-        inline bool findAssets(size_t& _inOutStorageSize, SAssetBundle* _out, const std::string& _key, const IAsset::E_TYPE* _types = nullptr) const
+        inline bool findAssets(size_t& _inOutStorageSize, SAssetBundle* _out, const std::string_view _key, const IAsset::E_TYPE* _types = nullptr) const
         {
             size_t availableSize = _inOutStorageSize;
             _inOutStorageSize = 0u;
@@ -463,9 +707,14 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
                     uint32_t typeIx = IAsset::typeFlagToIndex(_types[i]);
                     size_t readCnt = availableSize;
                     res = m_assetCache[typeIx]->findAndStoreRange(_key, readCnt, _out);
+                    // a null `_out` only queries the size, there are no bundles to mark as used
+                    if (_out)
+                    {
+                        touchCachedBundles(typeIx, _out, readCnt);
+                        _out += readCnt;
+                    }
                     availableSize -= readCnt;
                     _inOutStorageSize += readCnt;
-                    _out += readCnt;
                     ++i;
                 }
             }
@@ -475,16 +724,24 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
                 {
                     size_t readCnt = availableSize;
                     res = m_assetCache[typeIx]->findAndStoreRange(_key, readCnt, _out);
+                    // a null `_out` only queries the size, there are no bundles to mark as used
+                    if (_out)
+                    {
+                        touchCachedBundles(typeIx, _out, readCnt);
+                        _out += readCnt;
+                    }
                     availableSize -= readCnt;
                     _inOutStorageSize += readCnt;
-                    _out += readCnt;
                 }
             }
+            // loaders finding assets of other files in the cache themselves depend on these files just as much as if they loaded them
+            if (_out && _inOutStorageSize && IAssetLoader::SLoadScope::getCurrent())
+                recordDependency(std::string(_key));
             return res;
         }
         
 		//! It finds Assets and returnes all found. 
-        inline core::smart_refctd_dynamic_array<SAssetBundle> findAssets(const std::string& _key, const IAsset::E_TYPE* _types = nullptr) const
+        inline core::smart_refctd_dynamic_array<SAssetBundle> findAssets(const std::string_view _key, const IAsset::E_TYPE* _types = nullptr) const
         {
             size_t reqSz = 0u;
             if (_types)
@@ -513,8 +770,15 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
         //TODO change name
         inline void changeAssetKey(SAssetBundle& _asset, const std::string& _newKey)
         {
+            if (_asset.isInAResourceCache())
+            {
+                // the cache looks the bundle up under the key it's stored with, and the accounting only follows if it actually moved
+                const std::string oldKey = _asset.getCacheKey();
+                if (!m_assetCache[IAsset::typeFlagToIndex(_asset.getAssetType())]->changeObjectKey(_asset, oldKey, _newKey))
+                    return;
+                changeCachedBundleKey(_asset, oldKey, _newKey);
+            }
             _asset.setNewCacheKey(_newKey);
-            m_assetCache[IAsset::typeFlagToIndex(_asset.getAssetType())]->changeObjectKey(_asset, _asset.getCacheKey(), _newKey);
         }
 
         //! Insert an asset into the cache (calls the private methods of IAsset behind the scenes)
@@ -527,7 +791,9 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
             const uint32_t ix = IAsset::typeFlagToIndex(_asset.getAssetType());
             for (auto ass : _asset.getContents())
                 setAssetMutability(ass.get(), _mutability);
-            return m_assetCache[ix]->insert(_asset.getCacheKey(), _asset);
+            const bool inserted = m_assetCache[ix]->insert(_asset.getCacheKey(), _asset);
+            evictToBudget(ix);
+            return inserted;
         }
 
         //! Remove an asset from cache (calls the private methods of IAsset behind the scenes)
@@ -538,6 +804,102 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
             return m_assetCache[ix]->removeObject(_asset, _asset.getCacheKey());
         }
 
+        //! Caps the memory taken by cached assets of a type, as estimated by IAsset::conservativeSizeEstimate() on insertion, zero means no limit (the default)
+        /** Whenever the cache goes over budget the least recently used bundles get removed until it's 1/8th under, so this doesn't happen on every insertion.
+        Only bundles nothing outside the cache holds a reference to can be evicted, so assets in use (or used by other cached assets) are pinned,
+        as are the builtin assets. The budget can stay exceeded while everything is pinned, eviction is retried on the next insertion. */
+        void setCacheBudget(const IAsset::E_TYPE _type, const uint64_t _byteBudget);
+
+        struct SCacheStatistics
+        {
+            //! Sum of the size estimates of the cached assets, taken when they got inserted
+            uint64_t bytesCached = 0ull;
+            uint64_t byteBudget = 0ull;
+            uint64_t bundleCount = 0ull;
+            //! Bundles of this type returned by lookups by key (findAssets, and so all the loads)
+            uint64_t hits = 0ull;
+            uint64_t evictions = 0ull;
+            uint64_t evictedBytes = 0ull;
+        };
+        SCacheStatistics getCacheStatistics(const IAsset::E_TYPE _type) const;
+
+        //! How many loads (getAsset and friends, including the dependencies loaded by the loaders) were satisfied from the cache, only counts loads which were allowed to look into it
+        struct SLoadCacheStatistics
+        {
+            inline float getHitRate() const { return hits+misses ? float(hits)/float(hits+misses):0.f; }
+
+            uint64_t hits = 0ull;
+            uint64_t misses = 0ull;
+        };
+        inline SLoadCacheStatistics getLoadCacheStatistics() const
+        {
+            return {m_loadCacheHits.load(std::memory_order_relaxed),m_loadCacheMisses.load(std::memory_order_relaxed)};
+        }
+
+        //! Per loader counters, see setStatisticsEnabled()
+        struct SLoaderStatistics
+        {
+            //! Calls to IAssetLoader::loadAsset, which only happen for files it said it can load
+            uint64_t calls = 0ull;
+            uint64_t failures = 0ull;
+            //! Sizes of the files it was given, not how much of them it read, the loaders read (or map) the files as they please
+            uint64_t inputFileBytes = 0ull;
+            //! Time spent in IAssetLoader::loadAsset, including the dependencies
+            std::chrono::nanoseconds wallTime = {};
+            //! Time spent loading (or finding in the cache) the files the loader needed on its own thread,
+            //! the loads it spreads over the thread pool with IAssetLoader::interm_loadInParallel count for the loaders doing them
+            std::chrono::nanoseconds dependencyTime = {};
+            //! Dependencies found in the cache, indexed with IAsset::typeFlagToIndex()
+            std::array<uint64_t,IAsset::ET_STANDARD_TYPES_COUNT> cacheHits = {};
+            //! Dependencies which weren't in the cache, by the type of what got loaded, the ones which failed to load aren't counted
+            std::array<uint64_t,IAsset::ET_STANDARD_TYPES_COUNT> cacheMisses = {};
+        };
+        //! Per writer counters, see setStatisticsEnabled()
+        struct SWriterStatistics
+        {
+            //! Calls to IAssetWriter::writeAsset
+            uint64_t calls = 0ull;
+            uint64_t failures = 0ull;
+            //! Size of the files after the successful writes
+            uint64_t bytesWritten = 0ull;
+            std::chrono::nanoseconds wallTime = {};
+        };
+
+        //! Starts or stops gathering the loader and writer statistics, off by default
+        /** When off nothing gets timed or counted, the loads only check this flag. */
+        inline void setStatisticsEnabled(const bool _enabled) { m_statisticsEnabled.store(_enabled,std::memory_order_relaxed); }
+        inline bool areStatisticsEnabled() const { return m_statisticsEnabled.load(std::memory_order_relaxed); }
+
+        //! Zeroes for loaders and writers which weren't added to this manager
+        SLoaderStatistics getLoaderStatistics(const IAssetLoader* _loader) const;
+        SWriterStatistics getWriterStatistics(const IAssetWriter* _writer) const;
+        void resetStatistics();
+
+        //! Logs the statistics of every loader and writer which got called with ELL_PERFORMANCE
+        void logStatistics(const system::logger_opt_ptr _logger) const;
+        //! Makes logStatistics() happen every `_period` with `_logger`, a null logger or zero period stops it
+        /** There's no timer thread, the log gets written by the first load or write to finish after the period passed, and only while statistics are enabled. */
+        void setPeriodicStatisticsLog(core::smart_refctd_ptr<system::ILogger>&& _logger, const std::chrono::milliseconds _period);
+
+        //! Files which needed the file with the `_key` cache key to be loaded (directly or not), in the order they should be reloaded in when it changes
+        /** The dependencies are recorded as loads happen, every file loaded, or found in the cache with findAssets, by a loader while it loads another file is its dependency.
+        Assets a loader gets any other way (from an IAssetLoaderOverride, or held from before the load) are not tracked, so files using them won't be reloaded.
+        The order is topological, every file comes after all the files it depends on. */
+        core::vector<std::string> getDependentFiles(const std::string& _key) const;
+
+        //! Reloads a file which changed on disk, and then every cached file which depends on it (see getDependentFiles()), returns the keys of what got reloaded in order
+        /** Only the changed file and its dependents get loaded again, their other dependencies keep coming from the cache.
+        If the new version of the changed file has the same layout (IAsset::canBeRestoredFrom), the file doesn't depend on other files and none of the assets its assets reference
+        are referenced by anything else (as ELPF_DEDUPLICATE makes files share them), the cached assets get their contents
+        swapped for the new ones with IAsset::restoreFromDummy, so everything referencing them (including assets you hold) sees the change without being reloaded.
+        Otherwise, and for the dependents which share their subtrees with files which haven't changed, the new bundles replace the old ones in the cache.
+        Files which fail to load keep their old bundles. Don't load the affected files on other threads while this runs. */
+        core::vector<std::string> reloadAffected(const system::path& _filePath, const IAssetLoader::SAssetLoadParams& _params, IAssetLoader::IAssetLoaderOverride* _override);
+        inline core::vector<std::string> reloadAffected(const system::path& _filePath, const IAssetLoader::SAssetLoadParams& _params)
+        {
+            return reloadAffected(_filePath, _params, &m_defaultLoaderOverride);
+        }
+
         //! Removes all assets from the specified caches, all caches by default
         void clearAllAssetCache(const uint64_t& _assetTypeBitFlags = 0xffffffffffffffffull)
         {
@@ -662,10 +1024,13 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
             if (!_override)
                 _override = &defOverride;
             auto ext = system::extension_wo_dot(_file->getFileName());
-            auto capableWritersRng = m_writers.perTypeAndFileExt.findRange({_params.rootAsset->getAssetType(), ext});
+            const SRegistryReader registry(this);
+            auto capableWriters = registry->writersPerTypeAndFileExt.find({_params.rootAsset->getAssetType(), ext});
+            if (capableWriters==registry->writersPerTypeAndFileExt.end())
+                return false;
 
-            for (auto& writer : capableWritersRng)
-            if (writer.second->writeAsset(_file, _params, _override))
+            for (auto* writer : capableWriters->second)
+            if (callWriter(*registry, writer, _file, _params, _override))
                 return true;
             return false;
         }
@@ -678,65 +1043,98 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
             return writeAsset(_file, _params, nullptr);
         }
 
-        // Asset Loaders [FOLLOWING ARE NOT THREAD SAFE]
-        uint32_t getAssetLoaderCount() { return static_cast<uint32_t>(m_loaders.vector.size()); }
+        // Asset Loaders, these can be called at any time from any thread, the loads already running keep using the loaders they found
+        uint32_t getAssetLoaderCount() const { return static_cast<uint32_t>(SRegistryReader(this)->loaders.size()); }
 
         //! @returns 0xdeadbeefu on failure or 0-based index on success.
+        /** The index is where the loader went in the registry at the time, it shifts when an earlier loader gets removed, so `removeAssetLoader` takes the pointer. */
         uint32_t addAssetLoader(core::smart_refctd_ptr<IAssetLoader>&& _loader)
         {
             // there's no way it ever fails, so no 0xdeadbeef return
-            const char** exts = _loader->getAssociatedFileExtensions();
-            size_t extIx = 0u;
-            while (const char* ext = exts[extIx++])
-                m_loaders.perFileExt.insert(ext, _loader.get());
-            m_loaders.pushToVector(std::move(_loader));
-            return static_cast<uint32_t>(m_loaders.vector.size())-1u;
+            uint32_t retval;
+            changeRegistry([&](SRegistry& registry) -> void
+            {
+                const char** exts = _loader->getAssociatedFileExtensions();
+                size_t extIx = 0u;
+                while (const char* ext = exts[extIx++])
+                    registry.loadersPerFileExt[ext].push_back(_loader.get());
+                for (const auto& magicNumber : _loader->getMagicNumbers())
+                    registry.loadersPerMagicNumber.emplace_back(magicNumber, _loader.get());
+                registry.loaderCounters.try_emplace(_loader.get(), core::make_smart_refctd_ptr<SLoaderCounters>());
+                registry.loaders.push_back(std::move(_loader));
+                retval = static_cast<uint32_t>(registry.loaders.size())-1u;
+            });
+            return retval;
         }
         void removeAssetLoader(IAssetLoader* _loader)
         {
-            m_loaders.eraseFromVector(
-                std::find_if(std::begin(m_loaders.vector), std::end(m_loaders.vector), [_loader](const core::smart_refctd_ptr<IAssetLoader>& a)->bool { return a.get()==_loader; })
-            );
-            const char** exts = _loader->getAssociatedFileExtensions();
-            size_t extIx = 0u;
-            while (const char* ext = exts[extIx++])
-                m_loaders.perFileExt.removeObject(_loader, ext);
+            changeRegistry([_loader](SRegistry& registry) -> void
+            {
+                const char** exts = _loader->getAssociatedFileExtensions();
+                size_t extIx = 0u;
+                while (const char* ext = exts[extIx++])
+                if (auto found=registry.loadersPerFileExt.find(ext); found!=registry.loadersPerFileExt.end())
+                {
+                    std::erase(found->second, _loader);
+                    if (found->second.empty())
+                        registry.loadersPerFileExt.erase(found);
+                }
+                std::erase_if(registry.loadersPerMagicNumber, [_loader](const auto& entry)->bool { return entry.second==_loader; });
+                registry.loaderCounters.erase(_loader);
+                // last, it might hold the last reference
+                std::erase_if(registry.loaders, [_loader](const core::smart_refctd_ptr<IAssetLoader>& a)->bool { return a.get()==_loader; });
+            });
         }
 
-        // Asset Writers [FOLLOWING ARE NOT THREAD SAFE]
-        uint32_t getAssetWriterCount() { return static_cast<uint32_t>(m_writers.perType.getSize()); } // todo.. well, it's not really writer count.. but rather type<->writer association count
+        // Asset Writers, same as the loaders
+        uint32_t getAssetWriterCount() const // todo.. well, it's not really writer count.. but rather type<->writer association count
+        {
+            const SRegistryReader registry(this);
+            size_t retval = 0ull;
+            for (const auto& type : registry->writersPerType)
+                retval += type.second.size();
+            return static_cast<uint32_t>(retval);
+        }
 
         void addAssetWriter(core::smart_refctd_ptr<IAssetWriter>&& _writer)
         {
-            const uint64_t suppTypes = _writer->getSupportedAssetTypesBitfield();
-            const char** exts = _writer->getAssociatedFileExtensions();
-            for (uint32_t i = 0u; i < IAsset::ET_STANDARD_TYPES_COUNT; ++i)
+            changeRegistry([&](SRegistry& registry) -> void
             {
-                const IAsset::E_TYPE type = IAsset::E_TYPE(1u << i);
-                if ((suppTypes>>i) & 1u)
+                const uint64_t suppTypes = _writer->getSupportedAssetTypesBitfield();
+                const char** exts = _writer->getAssociatedFileExtensions();
+                registry.writerCounters.try_emplace(_writer.get(), core::make_smart_refctd_ptr<SWriterCounters>());
+                for (uint32_t i = 0u; i < IAsset::ET_STANDARD_TYPES_COUNT; ++i)
                 {
-                    m_writers.perType.insert(type, _writer.get());
-                    size_t extIx = 0u;
-                    while (const char* ext = exts[extIx++])
-                        m_writers.perTypeAndFileExt.insert({type, ext}, _writer.get());
+                    const IAsset::E_TYPE type = IAsset::E_TYPE(1u << i);
+                    if ((suppTypes>>i) & 1u)
+                    {
+                        registry.writersPerType[type].push_back(_writer.get());
+                        size_t extIx = 0u;
+                        while (const char* ext = exts[extIx++])
+                            registry.writersPerTypeAndFileExt[{type, ext}].push_back(_writer.get());
+                    }
                 }
-            }
+                registry.writers.push_back(std::move(_writer));
+            });
         }
         void removeAssetWriter(IAssetWriter* _writer)
         {
-            const uint64_t suppTypes = _writer->getSupportedAssetTypesBitfield();
-            const char** exts = _writer->getAssociatedFileExtensions();
-            size_t extIx = 0u;
-            for (uint32_t i = 0u; i < IAsset::ET_STANDARD_TYPES_COUNT; ++i)
+            changeRegistry([_writer](SRegistry& registry) -> void
             {
-                if ((suppTypes >> i) & 1u)
+                auto eraseFrom = [_writer](auto& map) -> void
                 {
-                    const IAsset::E_TYPE type = IAsset::E_TYPE(1u << i);
-                    m_writers.perType.removeObject(_writer, type);
-                    while (const char* ext = exts[extIx++])
-                        m_writers.perTypeAndFileExt.removeObject(_writer, {type, ext});
-                }
-            }
+                    std::erase_if(map, [_writer](auto& entry) -> bool
+                    {
+                        std::erase(entry.second, _writer);
+                        return entry.second.empty();
+                    });
+                };
+                eraseFrom(registry.writersPerType);
+                eraseFrom(registry.writersPerTypeAndFileExt);
+                registry.writerCounters.erase(_writer);
+                // last, it might hold the last reference
+                std::erase_if(registry.writers, [_writer](const core::smart_refctd_ptr<IAssetWriter>& a)->bool { return a.get()==_writer; });
+            });
         }
 
         void dumpDebug(std::ostream& _outs) const
@@ -754,18 +1152,22 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
                 delete[] storage;
             }
             */
+            const SRegistryReader registry(this);
             _outs << "Loaders vector:\n";
-            for (const auto& ldr : m_loaders.vector)
+            for (const auto& ldr : registry->loaders)
                 _outs << '\t' << static_cast<void*>(ldr.get()) << '\n';
             _outs << "Loaders per-file-ext cache:\n";
-            for (const auto& ldr : m_loaders.perFileExt)
-                _outs << "\tKey: " << ldr.first << ", Value: " << ldr.second << '\n';
+            for (const auto& ext : registry->loadersPerFileExt)
+            for (const auto* ldr : ext.second)
+                _outs << "\tKey: " << ext.first << ", Value: " << static_cast<const void*>(ldr) << '\n';
             _outs << "Writers per-asset-type cache:\n";
-            for (const auto& wtr : m_writers.perType)
-                _outs << "\tKey: " << static_cast<uint64_t>(wtr.first) << ", Value: " << static_cast<void*>(wtr.second) << '\n';
+            for (const auto& type : registry->writersPerType)
+            for (const auto* wtr : type.second)
+                _outs << "\tKey: " << static_cast<uint64_t>(type.first) << ", Value: " << static_cast<const void*>(wtr) << '\n';
             _outs << "Writers per-asset-type-and-file-ext cache:\n";
-            for (const auto& wtr : m_writers.perTypeAndFileExt)
-                _outs << "\tKey: " << wtr.first << ", Value: " << static_cast<void*>(wtr.second) << '\n';
+            for (const auto& key : registry->writersPerTypeAndFileExt)
+            for (const auto* wtr : key.second)
+                _outs << "\tKey: " << key.first << ", Value: " << static_cast<const void*>(wtr) << '\n';
         }
 
         /*
@@ -813,6 +1215,11 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
 		void addLoadersAndWriters();
 
         void insertBuiltinAssets();
+
+    private:
+        // snapshots of the counters, the registry they're in has to be held by the caller
+        static SLoaderStatistics getStatistics(const SLoaderCounters& _counters);
+        static SWriterStatistics getStatistics(const SWriterCounters& _counters);
 };
 
 
@@ -113,7 +113,7 @@ class ICPUBottomLevelAccelerationStructure final : public IBottomLevelAccelerati
 			return sizeof(ICPUBottomLevelAccelerationStructure)+(m_buildFlags.hasFlags(BUILD_FLAGS::GEOMETRY_TYPE_IS_AABB_BIT) ? sizeof(AABBs<ICPUBuffer>):sizeof(Triangles<ICPUBuffer>))*getGeometryCount();
 		}
 
-		inline core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const override
+		inline core::smart_refctd_ptr<IAsset> clone_impl(uint32_t _depth) const override
 		{
 			auto cp = core::make_smart_refctd_ptr<ICPUBottomLevelAccelerationStructure>();
 			clone_common(cp.get());
@@ -346,7 +346,7 @@ class ICPUTopLevelAccelerationStructure final : public ITopLevelAccelerationStru
 			return sizeof(ICPUBottomLevelAccelerationStructure)+sizeof(PolymorphicInstance)*m_instances->size();
 		}
 
-		inline core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const override
+		inline core::smart_refctd_ptr<IAsset> clone_impl(uint32_t _depth) const override
 		{
 			auto cp = core::make_smart_refctd_ptr<ICPUTopLevelAccelerationStructure>();
 			clone_common(cp.get());
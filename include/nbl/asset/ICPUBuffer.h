@@ -4,6 +4,7 @@
 #ifndef _NBL_ASSET_I_CPU_BUFFER_H_INCLUDED_
 #define _NBL_ASSET_I_CPU_BUFFER_H_INCLUDED_
 
+#include <atomic>
 #include <type_traits>
 
 #include "nbl/core/alloc/null_allocator.h"
@@ -42,11 +43,15 @@ class ICPUBuffer : public asset::IBuffer, public asset::IAsset
             m_creationParams.size = sizeInBytes;
         }
 
-        core::smart_refctd_ptr<IAsset> clone(uint32_t = ~0u) const override final
+        core::smart_refctd_ptr<IAsset> clone_impl(uint32_t) const override final
         {
             auto cp = core::make_smart_refctd_ptr<ICPUBuffer>(m_creationParams.size);
             clone_common(cp.get());
-            memcpy(cp->getPointer(), data, m_creationParams.size);
+            // big buffers get copied in parallel when the session flushes
+            if (auto* session=SCloneSession::getCurrent())
+                session->copy(cp->getPointer(), getPointer(), m_creationParams.size);
+            else
+                memcpy(cp->getPointer(), getPointer(), m_creationParams.size);
 
             return cp;
         }
@@ -66,11 +71,28 @@ class ICPUBuffer : public asset::IBuffer, public asset::IAsset
         size_t conservativeSizeEstimate() const override final { return getSize(); }
 
         //! Returns pointer to data.
-        const void* getPointer() const {return data;}
+        const void* getPointer() const
+        {
+            const void* dat = data.load(std::memory_order_acquire);
+            return dat ? dat:const_cast<ICPUBuffer*>(this)->pageIn(0ull,getSize());
+        }
         void* getPointer() 
         { 
             assert(!isImmutable_debug());
-            return data;
+            void* dat = data.load(std::memory_order_acquire);
+            return dat ? dat:pageIn(0ull,getSize());
+        }
+        //! Returns pointer to the data at `offset`, only `[offset,offset+size)` is guaranteed to be there, so buffers which read their contents in on demand (CFileBackedCPUBuffer) only read that much
+        const void* getPointer(const size_t offset, const size_t size) const
+        {
+            const void* dat = data.load(std::memory_order_acquire);
+            return dat ? (reinterpret_cast<const uint8_t*>(dat)+offset):const_cast<ICPUBuffer*>(this)->pageIn(offset,size);
+        }
+        void* getPointer(const size_t offset, const size_t size)
+        {
+            assert(!isImmutable_debug());
+            void* dat = data.load(std::memory_order_acquire);
+            return dat ? (reinterpret_cast<uint8_t*>(dat)+offset):pageIn(offset,size);
         }
 
         bool canBeRestoredFrom(const IAsset* _other) const override final
@@ -101,28 +123,38 @@ class ICPUBuffer : public asset::IBuffer, public asset::IAsset
         }
 
     protected:
-        void restoreFromDummy_impl(IAsset* _other, uint32_t _levelsBelow) override final
+        void restoreFromDummy_impl(IAsset* _other, uint32_t _levelsBelow) override
         {
             auto* other = static_cast<ICPUBuffer*>(_other);
 
             // NO THIS IS A NIGHTMARE!
             // FIXME: ONLY SWAP FOR COMPATIBLE ALLOCATORS! OTHERWISE MEMCPY!
             if (willBeRestoredFrom(_other))
-                std::swap(data, other->data);
+                data.store(other->exchangeData(data.load()),std::memory_order_release);
         }
 
+        //! For `restoreFromDummy`, gives away all the contents in memory from `_NBL_ALIGNED_MALLOC` in exchange for `_data`, buffers which keep them anywhere but in `data` override it
+        virtual void* exchangeData(void* _data)
+        {
+            return data.exchange(_data);
+        }
+
+        //! Only called while `data` is null, buffers which keep their contents elsewhere until needed make the range available and return a pointer to `offset`, and set `data` once all of it is
+        virtual void* pageIn(const size_t offset, const size_t size) { return nullptr; }
+
         // REMEMBER TO CALL FROM DTOR!
         // TODO: idea, make the `ICPUBuffer` an ADT, and use the default allocator CCPUBuffer instead for consistency
         // TODO: idea make a macro for overriding all `delete` operators of a class to enforce a finalizer that runs in reverse order to destructors (to allow polymorphic cleanups)
         virtual void freeData()
         {
-            if (data)
-                _NBL_ALIGNED_FREE(data);
+            if (void* dat=data.load())
+                _NBL_ALIGNED_FREE(dat);
             data = nullptr;
             m_creationParams.size = 0ull;
         }
 
-        void* data;
+        // buffers which read their contents in on demand set it from any thread once they're all there, so it's released after the contents got written
+        std::atomic<void*> data;
 };
 
 
@@ -170,8 +202,8 @@ class CCustomAllocatorCPUBuffer<Allocator,true> : public ICPUBuffer
         }
         inline void freeData() override
         {
-            if (ICPUBuffer::data)
-                m_allocator.deallocate(reinterpret_cast<typename Allocator::pointer>(ICPUBuffer::data), ICPUBuffer::m_creationParams.size);
+            if (void* dat=ICPUBuffer::data.load())
+                m_allocator.deallocate(reinterpret_cast<typename Allocator::pointer>(dat), ICPUBuffer::m_creationParams.size);
             ICPUBuffer::data = nullptr; // so that ICPUBuffer won't try deallocating
         }
 
@@ -196,10 +228,10 @@ class CCustomAllocatorCPUBuffer<Allocator, false> : public CCustomAllocatorCPUBu
         // TODO: remove, alloc can fail, should be a static create method instead!
         CCustomAllocatorCPUBuffer(size_t sizeInBytes, const void* dat, Allocator&& alctr = Allocator()) : Base(sizeInBytes, alctr.allocate(sizeInBytes), core::adopt_memory, std::move(alctr))
         {
-            memcpy(Base::data,dat,sizeInBytes);
+            memcpy(Base::data.load(),dat,sizeInBytes);
         }
 };
 
 } // end namespace nbl::asset
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
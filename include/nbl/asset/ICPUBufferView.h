@@ -21,7 +21,7 @@ class ICPUBufferView : public IBufferView<ICPUBuffer>, public IAsset
 
 		size_t conservativeSizeEstimate() const override { return sizeof(IBufferView<ICPUBuffer>); }
 
-        core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const override
+        core::smart_refctd_ptr<IAsset> clone_impl(uint32_t _depth) const override
         {
             auto buf = (_depth > 0u && m_buffer) ? core::smart_refctd_ptr_static_cast<ICPUBuffer>(m_buffer->clone(_depth-1u)) : m_buffer;
 			auto cp = core::make_smart_refctd_ptr<ICPUBufferView>(SBufferRange<ICPUBuffer>{m_offset,m_size,m_buffer},m_format);
@@ -87,7 +87,7 @@ class NBL_API2 ICPUDescriptorSet final : public IDescriptorSet<ICPUDescriptorSet
 
 		std::span<const SDescriptorInfo> getDescriptorInfos(const ICPUDescriptorSetLayout::CBindingRedirect::binding_number_t binding, IDescriptor::E_TYPE type = IDescriptor::E_TYPE::ET_COUNT) const;
 
-		core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const override;
+		core::smart_refctd_ptr<IAsset> clone_impl(uint32_t _depth) const override;
 
 		void convertToDummyObject(uint32_t referenceLevelsBelowToConvert = 0u) override;
 
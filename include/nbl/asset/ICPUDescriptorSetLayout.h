@@ -26,7 +26,7 @@ class ICPUDescriptorSetLayout : public IDescriptorSetLayout<ICPUSampler>, public
 
         ICPUDescriptorSetLayout(const SBinding* const _begin, const SBinding* const _end) : base_t({_begin,_end}) {}
 
-        core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const override
+        core::smart_refctd_ptr<IAsset> clone_impl(uint32_t _depth) const override
         {
             auto cp = core::make_smart_refctd_ptr<ICPUDescriptorSetLayout>(nullptr, nullptr);
             clone_common(cp.get());
@@ -20,7 +20,7 @@ public:
 
     size_t conservativeSizeEstimate() const override { return 0ull; } // TODO
 
-    core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const override
+    core::smart_refctd_ptr<IAsset> clone_impl(uint32_t _depth) const override
     {
         return nullptr; // TODO
     }
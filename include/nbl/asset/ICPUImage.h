@@ -25,7 +25,7 @@ class ICPUImage final : public IImage, public IAsset
 			return core::smart_refctd_ptr<ICPUImage>(new ICPUImage(_params), core::dont_grab);
 		}
 
-        core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const override
+        core::smart_refctd_ptr<IAsset> clone_impl(uint32_t _depth) const override
         {
             auto par = m_creationParams;
             auto cp = core::smart_refctd_ptr<ICPUImage>(new ICPUImage(std::move(par)), core::dont_grab);
@@ -42,7 +42,7 @@ class ICPUImageView final : public IImageView<ICPUImage>, public IAsset
 			return sizeof(SCreationParams);
 		}
 
-        core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const override
+        core::smart_refctd_ptr<IAsset> clone_impl(uint32_t _depth) const override
         {
             auto par = params;
             if (_depth > 0u && par.image)
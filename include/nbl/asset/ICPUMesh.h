@@ -103,7 +103,7 @@ class ICPUMesh final : public IMesh<ICPUMeshBuffer>, public BlobSerializable, pu
 			return true;
 		}
 		
-        core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const override
+        core::smart_refctd_ptr<IAsset> clone_impl(uint32_t _depth) const override
         {
             auto cp = core::make_smart_refctd_ptr<ICPUMesh>();
             clone_common(cp.get());
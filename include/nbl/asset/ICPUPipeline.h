@@ -38,7 +38,7 @@ class ICPUPipeline : public IAsset, public PipelineNonAssetBase
 		    }
 	    }
 
-        inline core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const override final
+        inline core::smart_refctd_ptr<IAsset> clone_impl(uint32_t _depth) const override final
         {
             core::smart_refctd_ptr<ICPUPipelineLayout> layout;
             if (_depth>0u && PipelineNonAssetBase::m_layout)
@@ -57,7 +57,7 @@ class ICPUPipelineCache final : public IAsset
 		_NBL_STATIC_INLINE_CONSTEXPR auto AssetType = ET_PIPELINE_CACHE;
 		inline E_TYPE getAssetType() const override { return AssetType; }
 
-		core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const override
+		core::smart_refctd_ptr<IAsset> clone_impl(uint32_t _depth) const override
 		{
 			auto cache_cp = m_cache;
 		
@@ -14,7 +14,7 @@ public:
     using IRenderpass::IRenderpass;
 
     size_t conservativeSizeEstimate() const { return 0ull; /*TODO*/ }
-    core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const override
+    core::smart_refctd_ptr<IAsset> clone_impl(uint32_t _depth) const override
     {
         // TODO
         return nullptr;
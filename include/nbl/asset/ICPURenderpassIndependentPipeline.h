@@ -59,7 +59,7 @@ class ICPURenderpassIndependentPipeline : public IRenderpassIndependentPipeline<
 			}
 		}
 
-        core::smart_refctd_ptr<IAsset> clone(const uint32_t _depth = ~0u) const override
+        core::smart_refctd_ptr<IAsset> clone_impl(const uint32_t _depth) const override
         {
             core::smart_refctd_ptr<ICPUPipelineLayout> layout;
             if (_depth>0u && m_layout)
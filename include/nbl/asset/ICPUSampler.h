@@ -61,7 +61,7 @@ class ICPUSampler : public ISampler, public IAsset
 			return std::move(reinterpret_cast<core::vectorSIMDu32&>(texelCoord));
 		}
 
-        core::smart_refctd_ptr<IAsset> clone(uint32_t = ~0u) const override
+        core::smart_refctd_ptr<IAsset> clone_impl(uint32_t) const override
         {
             auto cp = core::make_smart_refctd_ptr<ICPUSampler>(m_params);
             clone_common(cp.get());
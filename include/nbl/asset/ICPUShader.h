@@ -49,7 +49,7 @@ class ICPUShader : public IAsset, public IShader
 			return estimate;
 		}
 
-		core::smart_refctd_ptr<IAsset> clone(uint32_t _depth = ~0u) const override
+		core::smart_refctd_ptr<IAsset> clone_impl(uint32_t _depth) const override
 		{
 			auto buf = (_depth > 0u && m_code) ? core::smart_refctd_ptr_static_cast<ICPUBuffer>(m_code->clone(_depth-1u)) : m_code;
 			auto cp = core::smart_refctd_ptr<ICPUShader>(new ICPUShader(std::move(buf), getStage(), m_contentType, std::string(getFilepathHint())), core::dont_grab);
@@ -21,6 +21,7 @@
 
 // base
 #include "nbl/asset/ICPUBuffer.h"
+#include "nbl/asset/CFileBackedCPUBuffer.h"
 #include "nbl/asset/IMesh.h" //depr
 
 // images
@@ -50,6 +50,59 @@ class CSwizzleAndConvertImageFilterBase : public CSwizzleableAndDitherableFilter
 		}
 
 	protected:
+		//! Plain float32 <-> float16 conversions skip the per-texel decode and encode through doubles, and convert whole rows with F16C/AVX-512.
+		/** Only taken without dithering, normalization or a non-identity swizzle, and float32 -> float16 rounds to nearest even where the per-texel path truncates.
+		Returns false if it didn't apply, then the generic path needs to run. */
+		template<class ExecutionPolicy>
+		static inline bool tryExecuteHalfFloatConversion(ExecutionPolicy&& policy, state_type* state, const E_FORMAT inFormat, const E_FORMAT outFormat)
+		{
+			constexpr bool IdentitySwizzleType = std::is_same_v<Swizzle,VoidSwizzle> || std::is_same_v<Swizzle,DefaultSwizzle>;
+			if constexpr (IdentitySwizzleType && std::is_same_v<Dither,IdentityDither> && std::is_void_v<Normalization>)
+			{
+				auto getFloatChannelCount = [](const E_FORMAT format, const uint32_t bits) -> uint32_t
+				{
+					if (!isFloatingPointFormat(format) || isDepthOrStencilFormat(format) || getTexelOrBlockBytesize(format)!=getFormatChannelCount(format)*bits/8u)
+						return 0u;
+					return getFormatChannelCount(format);
+				};
+				const uint32_t channels = getFloatChannelCount(inFormat,16u)|getFloatChannelCount(inFormat,32u);
+				const bool toHalf = getFloatChannelCount(inFormat,32u) && getFloatChannelCount(outFormat,16u)==channels;
+				const bool fromHalf = getFloatChannelCount(inFormat,16u) && getFloatChannelCount(outFormat,32u)==channels;
+				// clamping float16 infinities to float32 max is the one thing the batch conversion doesn't do
+				if (!toHalf && !(fromHalf && !Clamp))
+					return false;
+				if constexpr (std::is_same_v<Swizzle,DefaultSwizzle>)
+				for (uint32_t i=0u; i<channels; i++)
+				{
+					const auto mapping = (&state->swizzle.r)[i];
+					if (mapping!=ICPUImageView::SComponentMapping::ES_IDENTITY && mapping!=ICPUImageView::SComponentMapping::ES_R+i)
+						return false;
+				}
+
+				auto perOutputRegion = [&policy,channels,toHalf](const CMatchedSizeInOutImageFilterCommon::CommonExecuteData& commonExecuteData, CBasicImageFilterCommon::clip_region_functor_t& clip) -> bool
+				{
+					auto convertRow = [&commonExecuteData,channels,toHalf](uint32_t readBlockArrayOffset, core::vectorSIMDu32 readBlockPos, uint32_t blockCount)
+					{
+						const uint8_t* srcPix = commonExecuteData.inData+readBlockArrayOffset;
+						uint8_t* dstPix = commonExecuteData.outData+commonExecuteData.oit->getByteOffset(readBlockPos+commonExecuteData.offsetDifferenceInTexels,commonExecuteData.outByteStrides);
+						if (toHalf)
+							core::float32_to_float16(reinterpret_cast<uint16_t*>(dstPix),reinterpret_cast<const float*>(srcPix),size_t(blockCount)*channels,Clamp);
+						else
+							core::float16_to_float32(reinterpret_cast<float*>(dstPix),reinterpret_cast<const uint16_t*>(srcPix),size_t(blockCount)*channels);
+					};
+					for (auto it=commonExecuteData.inRegions.begin(); it!=commonExecuteData.inRegions.end(); it++)
+					{
+						IImage::SBufferCopy region = *it;
+						if (clip(region,it))
+							CBasicImageFilterCommon::executePerBlockRow(policy,commonExecuteData.inImg,region,convertRow);
+					}
+					return true;
+				};
+				return CMatchedSizeInOutImageFilterCommon::commonExecute(state,perOutputRegion);
+			}
+			return false;
+		}
+
 		template<E_FORMAT kInFormat, class ExecutionPolicy, typename decodeBufferType, typename encodeBufferType>
 		static inline void normalizationPrepass(E_FORMAT rInFormat, const ExecutionPolicy& policy, state_type* state, const core::vectorSIMDu32& blockDims)
 		{
@@ -125,6 +178,9 @@ class CSwizzleAndConvertImageFilter : public CImageFilter<CSwizzleAndConvertImag
 			if (!validate(state))
 				return false;
 
+			if (base_t::tryExecuteHalfFloatConversion(policy,state,inFormat,outFormat))
+				return true;
+
 			const auto blockDims = asset::getBlockDimensions(inFormat);
 			#ifdef _NBL_DEBUG
 				assert(blockDims.z==1u);
@@ -194,6 +250,9 @@ class CSwizzleAndConvertImageFilter<EF_UNKNOWN,EF_UNKNOWN,Swizzle,Dither,Normali
 
 			const auto inFormat = state->inImage->getCreationParameters().format;
 			const auto outFormat = state->outImage->getCreationParameters().format;
+			if (base_t::tryExecuteHalfFloatConversion(policy,state,inFormat,outFormat))
+				return true;
+
 			const auto blockDims = asset::getBlockDimensions(inFormat);
 			const uint32_t outChannelsAmount = asset::getFormatChannelCount(outFormat);
 			#ifdef _NBL_DEBUG
@@ -265,6 +324,9 @@ class CSwizzleAndConvertImageFilter<EF_UNKNOWN,outFormat,Swizzle,Dither,Normaliz
 				return false;
 
 			const auto inFormat = state->inImage->getCreationParameters().format;
+			if (base_t::tryExecuteHalfFloatConversion(policy,state,inFormat,outFormat))
+				return true;
+
 			const auto blockDims = asset::getBlockDimensions(inFormat);
 			#ifdef _NBL_DEBUG
 			assert(blockDims.z == 1u);
@@ -339,6 +401,9 @@ class CSwizzleAndConvertImageFilter<inFormat,EF_UNKNOWN,Swizzle,Dither,Normaliza
 				return false;
 
 			const auto outFormat = state->outImage->getCreationParameters().format;
+			if (base_t::tryExecuteHalfFloatConversion(policy,state,inFormat,outFormat))
+				return true;
+
 			const auto blockDims = asset::getBlockDimensions(inFormat);
 			const uint32_t outChannelsAmount = asset::getFormatChannelCount(outFormat);
 			#ifdef _NBL_DEBUG
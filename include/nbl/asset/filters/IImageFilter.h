@@ -9,6 +9,8 @@
 
 #include <algorithm>
 
+#include "nbl/core/execution.h"
+
 #include "nbl/asset/ICPUImage.h"
 
 namespace nbl
@@ -157,6 +159,7 @@ class IImageFilter
 		virtual bool pExecute(const core::execution::sequenced_policy&, IState* state) const = 0;
 		virtual bool pExecute(const core::execution::parallel_policy&, IState* state) const = 0;
 		virtual bool pExecute(const core::execution::parallel_unsequenced_policy&, IState* state) const = 0;
+		virtual bool pExecute(const core::execution::pool_policy&, IState* state) const = 0;
 
 		virtual bool pExecute(IState* state) const {return pExecute(core::execution::seq,state);}
 };
@@ -201,6 +204,10 @@ class CImageFilter : public IImageFilter
 		{
 			return execute(policy,state);
 		}
+		inline bool pExecute(const core::execution::pool_policy& policy, IState* state) const override
+		{
+			return execute(policy,state);
+		}
 };
 
 }
@@ -5,7 +5,11 @@
 #ifndef __NBL_ASSET_I_ASSET_LOADER_H_INCLUDED__
 #define __NBL_ASSET_I_ASSET_LOADER_H_INCLUDED__
 
+#include <array>
+#include <span>
+
 #include "nbl/system/declarations.h"
+#include "nbl/core/execution.h"
 
 #include "nbl/system/ISystem.h"
 #include "nbl/system/ILogger.h"
@@ -82,6 +86,10 @@ public:
 		a way that it'll look correctly in right-handed camera system. If it isn't set, compatibility with 
 		left-handed coordinate camera is assumed.
 		E_LOADER_PARAMETER_FLAGS::ELPF_DONT_COMPILE_GLSL means that GLSL won't be compiled to SPIR-V if it is loaded or generated.
+		E_LOADER_PARAMETER_FLAGS::ELPF_LAZY_BUFFERS means that buffers get read from the file only once something accesses them, so loading
+		huge scenes takes little memory until they're used. The files stay open for as long as the buffers exist.
+		E_LOADER_PARAMETER_FLAGS::ELPF_DEDUPLICATE makes the IAssetManager collapse whatever the loaded assets reference into the assets
+		with the same contents it has loaded before with this flag, see CAssetDeduplicator. The loaded assets themselves stay as they are.
 	*/
 
 	enum E_LOADER_PARAMETER_FLAGS : uint64_t
@@ -89,7 +97,9 @@ public:
 		ELPF_NONE = 0,											//!< default value, it doesn't do anything
 		ELPF_RIGHT_HANDED_MESHES = 0x1,							//!< specifies that a mesh will be flipped in such a way that it'll look correctly in right-handed camera system
 		ELPF_DONT_COMPILE_GLSL = 0x2,							//!< it states that GLSL won't be compiled to SPIR-V if it is loaded or generated
-		ELPF_LOAD_METADATA_ONLY = 0x4							//!< it forces the loader to not load the entire scene for performance in special cases to fetch metadata.
+		ELPF_LOAD_METADATA_ONLY = 0x4,							//!< it forces the loader to not load the entire scene for performance in special cases to fetch metadata.
+		ELPF_LAZY_BUFFERS = 0x8,								//!< loaders which support it (BIN and the native NBL loader) return CFileBackedCPUBuffer's which read their contents from the file on first use
+		ELPF_DEDUPLICATE = 0x10									//!< buffers, images, pipelines and meshbuffers with the same contents get shared between everything loaded with this flag
 	};
 
     struct SAssetLoadParams
@@ -291,6 +301,35 @@ public:
 	\return True if file seems to be loadable. */
 	virtual bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger = nullptr) const = 0;
 
+	//! How many bytes from the start of a file IAssetManager reads once, and then hands to every loader it asks whether it can load the file
+	_NBL_STATIC_INLINE_CONSTEXPR size_t SniffedHeaderSize = 128ull;
+
+	//! Same check as isALoadableFileFormat(), but with the first `SniffedHeaderSize` bytes of the file (less if the file is shorter, none if it couldn't be read) already in `_header`
+	/** Loaders which can tell from the start of a file should override this and implement isALoadableFileFormat() with sniffHeader(), so trying many loaders on a file costs a single read.
+	Not an overload of isALoadableFileFormat() so that overriding just one doesn't hide the other. The default ignores `_header`. */
+	virtual bool isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger = nullptr) const
+	{
+		return isALoadableFileFormat(_file, logger);
+	}
+
+	//! A byte sequence every file of some format has at a fixed offset
+	struct SMagicNumber
+	{
+		inline bool matches(const std::span<const uint8_t> _header) const
+		{
+			return offset+bytes.size()<=_header.size() && std::equal(bytes.begin(),bytes.end(),_header.begin()+offset);
+		}
+
+		size_t offset;
+		std::span<const uint8_t> bytes;
+	};
+	//! When the extension doesn't tell, IAssetManager asks the loaders with a matching magic number first, none by default
+	/** All the bytes must lie within the first `SniffedHeaderSize` bytes of the file, and the span must stay valid for as long as the loader lives. */
+	virtual std::span<const SMagicNumber> getMagicNumbers() const { return {}; }
+
+	//! Reads the first `SniffedHeaderSize` bytes of the file into `_storage`, returns the part that got read
+	static std::span<const uint8_t> sniffHeader(system::IFile* _file, std::array<uint8_t,SniffedHeaderSize>& _storage);
+
 	//! Returns an array of string literals terminated by nullptr
 	virtual const char** getAssociatedFileExtensions() const = 0;
 
@@ -304,6 +343,22 @@ public:
 
 	virtual void initialize() {}
 
+	//! Marks which file the loader(s) running on this thread are loading, for the duration of its lifetime.
+	/** IAssetManager opens one around every loader call and records every file looked up in the cache or loaded inside of it as a dependency,
+	that's what IAssetManager::reloadAffected() works off. Scopes nest like the loads do, a null key means "not loading anything". */
+	class NBL_API2 SLoadScope final : public core::Uncopyable
+	{
+		public:
+			explicit SLoadScope(const std::string* _key);
+			~SLoadScope();
+
+			//! Cache key of the file being loaded on the calling thread, null if none
+			static const std::string* getCurrent();
+
+		private:
+			const std::string* m_previous;
+	};
+
 protected:
 	// accessors for loaders
 	SAssetBundle interm_getAssetInHierarchy(IAssetManager* _mgr, system::IFile* _file, const std::string& _supposedFilename, const IAssetLoader::SAssetLoadParams& _params, uint32_t _hierarchyLevel, IAssetLoader::IAssetLoaderOverride* _override);
@@ -324,6 +379,22 @@ protected:
 	bool insertBuiltinAssetIntoCache(IAssetManager* _mgr, core::smart_refctd_ptr<IAsset>& _asset, core::smart_refctd_ptr<IAssetMetadata>&& metadata, const std::string _path);
 	bool insertBuiltinAssetIntoCache(IAssetManager* _mgr, core::smart_refctd_ptr<IAsset>&& _asset, core::smart_refctd_ptr<IAssetMetadata>&& metadata, const std::string _path);
 
+	//! Calls `_load(i)` for every `i` in `[0,_count)` as parallel sub-tasks, so a loader can fetch all of its dependencies with `interm_getAssetInHierarchy` at once instead of one after another
+	/** Runs on the same pool as IAssetManager::getAssets(), waiting for the sub-tasks helps with other work instead of blocking a thread.
+	`_load` gets called from many threads at once, so it should only write to its own `i`-th outputs. */
+	template<typename F>
+	inline void interm_loadInParallel(const uint32_t _count, F&& _load)
+	{
+		// sub-tasks can run on other threads (or get picked up by this one while it waits on something else), so they need the scope passed along
+		const std::string* loading = SLoadScope::getCurrent();
+		core::execution::par_pool.getPool().parallel_for(_count,1ull,[&_load,loading](const size_t begin, const size_t end) -> void
+		{
+			SLoadScope scope(loading);
+			for (size_t i=begin; i<end; i++)
+				_load(static_cast<uint32_t>(i));
+		});
+	}
+
 	inline void setAssetInBundle(SAssetBundle& bundle, const uint32_t offset, core::smart_refctd_ptr<IAsset>&& _asset)
 	{
 		bundle.setAsset(offset,std::move(_asset));
@@ -6,6 +6,7 @@
 #define __NBL_ASSET_S_ASSET_BUNDLE_H_INCLUDED__
 
 #include <string>
+#include "nbl/core/containers/small_dynamic_array.h"
 #include "nbl/asset/IAsset.h"
 #include "nbl/asset/metadata/IAssetMetadata.h"
 
@@ -19,20 +20,22 @@ class SAssetBundle
 {
 		inline bool allSameTypeAndNotNull()
 		{
-			if (m_contents->size() == 0ull)
+			if (m_contents.size() == 0ull)
 				return true;
-			if (!*m_contents->begin())
+			if (!*m_contents.begin())
 				return false;
-			IAsset::E_TYPE t = (*m_contents->begin())->getAssetType();
-			for (auto it=m_contents->cbegin(); it!=m_contents->cend(); it++)
+			IAsset::E_TYPE t = (*m_contents.begin())->getAssetType();
+			for (auto it=m_contents.cbegin(); it!=m_contents.cend(); it++)
 				if (!(*it) || (*it)->getAssetType()!=t)
 					return false;
 			return true;
 		}
 	public:
-		using contents_container_t = core::smart_refctd_dynamic_array<core::smart_refctd_ptr<IAsset> >;
+		//! Nearly all loaders return a single asset, so bundles up to this size don't allocate and copying one only bumps the reference counts
+		_NBL_STATIC_INLINE_CONSTEXPR size_t InlineAssetCount = 2ull;
+		using contents_container_t = core::small_dynamic_array<core::smart_refctd_ptr<IAsset>,InlineAssetCount>;
     
-		SAssetBundle(const size_t assetCount=0ull) : m_metadata(nullptr), m_contents(core::make_refctd_dynamic_array<contents_container_t>(assetCount)), m_cacheKey("")
+		SAssetBundle(const size_t assetCount=0ull) : m_metadata(nullptr), m_contents(assetCount), m_cacheKey("")
 		{
 		}
 		SAssetBundle(core::smart_refctd_ptr<IAssetMetadata>&& _metadata, contents_container_t&& _contents) : m_metadata(std::move(_metadata)), m_contents(std::move(_contents)), m_cacheKey{}
@@ -40,12 +43,12 @@ class SAssetBundle
 			assert(allSameTypeAndNotNull());
 		}
 		SAssetBundle(core::smart_refctd_ptr<IAssetMetadata>&& _metadata, std::initializer_list<core::smart_refctd_ptr<IAsset> > _contents) : 
-			SAssetBundle(std::move(_metadata),core::make_refctd_dynamic_array<contents_container_t>(_contents))
+			SAssetBundle(std::move(_metadata),contents_container_t(_contents))
 		{
 		}
 		template<typename ContainerT>
 		SAssetBundle(core::smart_refctd_ptr<IAssetMetadata>&& _metadata, ContainerT&& _contents) :
-			SAssetBundle(std::move(_metadata),core::make_refctd_dynamic_array<contents_container_t>(std::forward<ContainerT>(_contents)))
+			SAssetBundle(std::move(_metadata),contents_container_t(std::forward<ContainerT>(_contents)))
 		{
 		}
 
@@ -54,12 +57,12 @@ class SAssetBundle
 			An Asset type is specified in E_TYPE enum.
 			@see E_TYPE
 		*/
-		inline IAsset::E_TYPE getAssetType() const { return m_contents->front()->getAssetType(); }
+		inline IAsset::E_TYPE getAssetType() const { return m_contents.front()->getAssetType(); }
 
 		//! Getting beginning and end of an Asset stored by m_contents
 		inline core::SRange<const core::smart_refctd_ptr<IAsset>> getContents() const
 		{
-			return core::SRange<const core::smart_refctd_ptr<IAsset>>(m_contents->begin(),m_contents->end());
+			return core::SRange<const core::smart_refctd_ptr<IAsset>>(m_contents.begin(),m_contents.end());
 		}
 
 		//! Whether this asset bundle is in a cache and should be removed from cache to destroy
@@ -82,12 +85,7 @@ class SAssetBundle
 		{
 			if (m_metadata != _other.m_metadata)
 				return false;
-            if (m_contents->size() != _other.m_contents->size())
-                return false;
-            for (size_t i = 0ull; i < m_contents->size(); ++i)
-                if ((*m_contents)[i] != (*_other.m_contents)[i])
-                    return false;
-            return true;
+            return m_contents == _other.m_contents;
 		}
 
 		//! Overloaded operator checking if both collections of Assets\b aren't\b the same arrays in memory
@@ -106,7 +104,7 @@ class SAssetBundle
 		friend class IAssetLoader;
 		inline void setAsset(const uint32_t offset, core::smart_refctd_ptr<IAsset>&& _asset)
 		{
-			m_contents->operator[](offset) = std::move(_asset);
+			m_contents[offset] = std::move(_asset);
 			assert(allSameTypeAndNotNull());
 		}
 
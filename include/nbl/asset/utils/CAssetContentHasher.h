@@ -0,0 +1,45 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_ASSET_C_ASSET_CONTENT_HASHER_H_INCLUDED_
+#define _NBL_ASSET_C_ASSET_CONTENT_HASHER_H_INCLUDED_
+
+#include "nbl/asset/IAsset.h"
+
+namespace nbl::asset
+{
+
+//! Hashes what an asset contains instead of where it came from, with xxHash
+/**
+	Two assets get the same hash when they'd be interchangeable: same type, same parameters, same contents of the buffers
+	and the same hashes of the assets they reference. The names of the files they got loaded from don't matter, neither do the usage
+	flags of buffers.
+
+	Supported are `ICPUBuffer`, `ICPUImage`, `ICPUSampler`, `ICPUShader`, `ICPURenderpassIndependentPipeline`, `ICPUMeshBuffer`
+	and `ICPUMesh`. Any other asset hashes to its address, so it only ever matches itself, the same goes for dummies.
+
+	The hashes get memoized by the asset's address, so an asset referenced many times only gets hashed once. Don't keep the hasher
+	across modifications or destructions of the assets, call `clear()` or make a new one. Hashing a `CFileBackedCPUBuffer` reads it in.
+*/
+class NBL_API2 CAssetContentHasher final
+{
+	public:
+		using hash_t = std::array<uint64_t,4>;
+		struct HashFunc
+		{
+			inline size_t operator()(const hash_t& hash) const { return hash[0]; }
+		};
+
+		static bool isSupported(const IAsset::E_TYPE type);
+
+		hash_t hash(const IAsset* asset);
+
+		inline void clear() { m_memo.clear(); }
+
+	private:
+		core::unordered_map<const IAsset*,hash_t> m_memo;
+};
+
+}
+
+#endif
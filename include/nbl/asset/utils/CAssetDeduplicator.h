@@ -0,0 +1,67 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_ASSET_C_ASSET_DEDUPLICATOR_H_INCLUDED_
+#define _NBL_ASSET_C_ASSET_DEDUPLICATOR_H_INCLUDED_
+
+#include <mutex>
+
+#include "nbl/asset/metadata/IAssetMetadata.h"
+#include "nbl/asset/utils/CAssetContentHasher.h"
+
+namespace nbl::asset
+{
+
+//! Collapses assets with the same contents (see `CAssetContentHasher`) into the first one of them it has seen
+/**
+	`deduplicate` walks the references of the asset bottom-up and makes its meshes, meshbuffers, pipelines and images point at the
+	first asset with the same hash it knows. Only references of mutable assets get replaced, and the buffer of a shader can't be.
+
+	The first assets get kept alive by the deduplicator, so that anything loaded later can be collapsed into them, until `clear()`
+	or until `releaseUnused()` finds nothing else references them anymore. If one got modified since, it stops being the one others
+	collapse into. Passes only lock the deduplicator to look up and replace references, so they can run on many threads at once,
+	as long as they don't walk the same mutable assets. Images, pipelines and meshes with an entry in the
+	metadata passed to `deduplicate`, and whatever references them, never get replaced as the metadata is looked up by address.
+
+	`IAssetManager` runs its deduplicator on everything loaded with `IAssetLoader::ELPF_DEDUPLICATE`.
+*/
+class NBL_API2 CAssetDeduplicator final : public core::IReferenceCounted
+{
+	public:
+		struct SStatistics
+		{
+			//! Assets which got replaced by an earlier asset with the same contents
+			uint64_t duplicates = 0ull;
+			//! Sum of `conservativeSizeEstimate()` of these, they only get freed if nothing else referenced them
+			uint64_t bytesSaved = 0ull;
+		};
+
+		//! Returns the asset `asset` should be replaced by, which is `asset` itself if it's the first one with its contents
+		/** With `onlyDependencies` it's always `asset`, for when the caller can't replace it, only what it references gets collapsed. */
+		core::smart_refctd_ptr<IAsset> deduplicate(IAsset* asset, const IAssetMetadata* metadata=nullptr, const bool onlyDependencies=false);
+
+		SStatistics getStatistics() const;
+
+		//! Forgets all the assets seen so far and the statistics
+		void clear();
+
+		//! How many of the references to `asset` the deduplicator holds, these don't make it in use by anything else
+		uint32_t getHeldReferenceCount(const IAsset* asset) const;
+		//! Forgets the assets nothing but the deduplicator references, so they get freed
+		/** `IAssetManager` calls it after evicting from its cache, otherwise the assets would live for as long as the deduplicator. */
+		void releaseUnused();
+
+	private:
+		struct SPass;
+		core::smart_refctd_ptr<IAsset> deduplicate_impl(SPass& pass, IAsset* asset);
+
+		mutable std::mutex m_lock;
+		core::unordered_map<CAssetContentHasher::hash_t,core::smart_refctd_ptr<IAsset>,CAssetContentHasher::HashFunc> m_firstSeen;
+		// an asset modified since it went in can be in `m_firstSeen` under its old and its new hash
+		core::unordered_map<const IAsset*,uint32_t> m_held;
+		SStatistics m_statistics;
+};
+
+}
+
+#endif
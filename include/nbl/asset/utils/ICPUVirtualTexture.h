@@ -9,6 +9,7 @@
 #include <nbl/asset/ICPUImageView.h>
 #include <nbl/asset/ICPUDescriptorSet.h>
 
+#include "nbl/core/containers/CFrameArena.h"
 #include "nbl/asset/filters/CMipMapGenerationImageFilter.h"
 
 namespace nbl {
@@ -154,13 +155,15 @@ public:
         blit.inImage = const_cast<ICPUImage*>(_img);
         blit.outImage = upscaled_img.get();
         blit.scratchMemoryByteSize = blit_filter_t::getRequiredScratchByteSize(&blit);
-        blit.scratchMemory = reinterpret_cast<uint8_t*>(_NBL_ALIGNED_MALLOC(blit.scratchMemoryByteSize, _NBL_SIMD_ALIGNMENT));
+        core::CFrameArena::SScratch scratch(core::CFrameArena::getThreadLocal(),blit.scratchMemoryByteSize);
+        if (!scratch.get())
+            return nullptr;
+        blit.scratchMemory = reinterpret_cast<uint8_t*>(scratch.get());
 
         if (!blit.recomputeScaledKernelPhasedLUT())
             return nullptr;
 
         const bool blit_succeeded = blit_filter_t::execute(&blit);
-        _NBL_ALIGNED_FREE(blit.scratchMemory);
         if (!blit_succeeded)
             return nullptr;
 
@@ -237,13 +240,15 @@ public:
             genmips.endMipLevel = paddedImg->getCreationParameters().mipLevels;
             genmips.inOutImage = paddedImg.get();
             genmips.scratchMemoryByteSize = mip_gen_filter_t::getRequiredScratchByteSize(&genmips);
-            genmips.scratchMemory = reinterpret_cast<uint8_t*>(_NBL_ALIGNED_MALLOC(genmips.scratchMemoryByteSize,_NBL_SIMD_ALIGNMENT));
+            core::CFrameArena::SScratch scratch(core::CFrameArena::getThreadLocal(),genmips.scratchMemoryByteSize);
+            if (!scratch.get())
+                return { nullptr, VkExtent3D{0u,0u,0u} };
+            genmips.scratchMemory = reinterpret_cast<uint8_t*>(scratch.get());
             genmips.axisWraps[0] = _wrapu;
             genmips.axisWraps[1] = _wrapv;
             genmips.axisWraps[2] = ISampler::ETC_CLAMP_TO_EDGE;
             genmips.borderColor = _borderColor;
             mip_gen_filter_t::execute(core::execution::par_unseq,&genmips);
-            _NBL_ALIGNED_FREE(genmips.scratchMemory);
         }
 
         return std::make_pair(std::move(paddedImg), originalExtent);
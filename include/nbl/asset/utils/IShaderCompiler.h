@@ -327,31 +327,32 @@ class NBL_API2 IShaderCompiler : public core::IReferenceCounted
 					// to get the "real" stage before lookup in the cache, defeating its purpose
 					inline SEntry(const std::string_view _mainFileContents, const SCompilerOptions& compilerOptions) : mainFileContents(std::move(std::string(_mainFileContents))), compilerArgs(compilerOptions)
 					{
-						// Form the hashable for the compiler data
-						size_t preprocessorArgsHashableSize = compilerArgs.preprocessorArgs.sourceIdentifier.size() + compilerArgs.preprocessorArgs.extraDefines.size() * sizeof(SMacroDefinition);
-						size_t compilerArgsHashableSize = sizeof(compilerArgs.stage) + sizeof(compilerArgs.targetSpirvVersion) + sizeof(compilerArgs.debugInfoFlags.value) + compilerArgs.optimizerPasses.size();
-						std::vector<uint8_t> hashable;
-						hashable.reserve(preprocessorArgsHashableSize + compilerArgsHashableSize + mainFileContents.size());
-					
+						// Hash the compiler data in the same order it used to be laid out in a single hashable array, so existing caches stay valid
+						size_t hashableSize = compilerArgs.preprocessorArgs.sourceIdentifier.size();
+						for (const auto& defines : compilerArgs.preprocessorArgs.extraDefines)
+							hashableSize += defines.identifier.size() + defines.definition.size();
+						hashableSize += sizeof(compilerArgs.stage) + sizeof(compilerArgs.targetSpirvVersion) + sizeof(compilerArgs.debugInfoFlags.value) + compilerArgs.optimizerPasses.size();
+						hashableSize += mainFileContents.size();
+						core::XXHash_256_Stream hasher(hashableSize);
+
 						// Insert preproc stuff
-						hashable.insert(hashable.end(), compilerArgs.preprocessorArgs.sourceIdentifier.begin(), compilerArgs.preprocessorArgs.sourceIdentifier.end());
+						hasher.update(compilerArgs.preprocessorArgs.sourceIdentifier.data(), compilerArgs.preprocessorArgs.sourceIdentifier.size());
 						for (const auto& defines : compilerArgs.preprocessorArgs.extraDefines)
 						{
-							hashable.insert(hashable.end(), defines.identifier.begin(), defines.identifier.end());
-							hashable.insert(hashable.end(), defines.definition.begin(), defines.definition.end());
+							hasher.update(defines.identifier.data(), defines.identifier.size());
+							hasher.update(defines.definition.data(), defines.definition.size());
 						}
 
 						// Insert rest of stuff from this struct. We're going to treat stage, targetSpirvVersion and debugInfoFlags.value as byte arrays for simplicity
-						hashable.insert(hashable.end(), reinterpret_cast<uint8_t*>(&compilerArgs.stage), reinterpret_cast<uint8_t*>(&compilerArgs.stage) + sizeof(compilerArgs.stage));
-						hashable.insert(hashable.end(), reinterpret_cast<uint8_t*>(&compilerArgs.targetSpirvVersion), reinterpret_cast<uint8_t*>(&compilerArgs.targetSpirvVersion) + sizeof(compilerArgs.targetSpirvVersion));
-						hashable.insert(hashable.end(), reinterpret_cast<uint8_t*>(&compilerArgs.debugInfoFlags.value), reinterpret_cast<uint8_t*>(&compilerArgs.debugInfoFlags.value) + sizeof(compilerArgs.debugInfoFlags.value));
-						for (auto pass : compilerArgs.optimizerPasses) {
-							hashable.push_back(static_cast<uint8_t>(pass));
-						}
+						hasher.updateWithObject(compilerArgs.stage);
+						hasher.updateWithObject(compilerArgs.targetSpirvVersion);
+						hasher.updateWithObject(compilerArgs.debugInfoFlags.value);
+						for (auto pass : compilerArgs.optimizerPasses)
+							hasher.updateWithObject(static_cast<uint8_t>(pass));
 
 						// Now add the mainFileContents and produce both lookup and early equality rejection hashes
-						hashable.insert(hashable.end(), mainFileContents.begin(), mainFileContents.end());
-						hash = nbl::core::XXHash_256(hashable.data(), hashable.size());
+						hasher.update(mainFileContents.data(), mainFileContents.size());
+						hash = hasher.finalize();
 						lookupHash = hash[0];
 						for (auto i = 1u; i < 4; i++) {
 							core::hash_combine<uint64_t>(lookupHash, hash[i]);
@@ -9,7 +9,7 @@
 
 #include "nbl/core/math/morton.h"
 #include "nbl/core/memory/memory.h"
-#include "nbl/core/alloc/GeneralpurposeAddressAllocator.h"
+#include "nbl/core/alloc/BuddyAddressAllocator.h"
 #include "nbl/core/alloc/PoolAddressAllocator.h"
 #include "nbl/core/alloc/address_allocator_traits.h"
 
@@ -412,7 +412,8 @@ protected:
     mutable core::smart_refctd_ptr<sampler_t> m_physicalStorageFloatSampler;
     mutable core::smart_refctd_ptr<sampler_t> m_physicalStorageNonFloatSampler;
 
-    using pg_tab_addr_alctr_t = core::GeneralpurposeAddressAllocator<uint32_t>;
+    // page table allocations are always PoT squares aligned to their own size, so a buddy allocator never fragments internally
+    using pg_tab_addr_alctr_t = core::BuddyAddressAllocator<uint32_t>;
     std::array<pg_tab_addr_alctr_t, MAX_PAGE_TABLE_LAYERS> m_pageTableLayerAllocators;
     uint8_t* m_pgTabAddrAlctr_reservedSpc = nullptr;
 
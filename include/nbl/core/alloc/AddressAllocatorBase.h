@@ -7,6 +7,7 @@
 
 #include "nbl/core/memory/memory.h"
 #include "nbl/core/alloc/address_allocator_traits.h"
+#include "nbl/core/alloc/AddressAllocatorTelemetry.h"
 
 namespace nbl
 {
@@ -20,7 +21,7 @@ namespace core
             static constexpr size_type                          invalid_address = nbl::core::address_type_traits<size_type>::invalid_address
 
     template<typename CRTP, typename _size_type>
-    class AddressAllocatorBase
+    class AddressAllocatorBase : public IAddressAllocatorTelemetrySource
     {
         public:
             _NBL_DECLARE_ADDRESS_ALLOCATOR_TYPEDEFS(_size_type);
@@ -128,9 +129,53 @@ namespace core
                 std::swap(alignOffset,other.alignOffset);
                 std::swap(maxRequestableAlignment,other.maxRequestableAlignment);
                 std::swap(combinedOffset,other.combinedOffset);
+                #ifdef _NBL_ALLOCATOR_TELEMETRY_
+                    std::swap(telemetryLabel,other.telemetryLabel);
+                    std::swap(telemetryCounters,other.telemetryCounters);
+                #endif // _NBL_ALLOCATOR_TELEMETRY_
                 return *this;
             }
 
+            #ifdef _NBL_ALLOCATOR_TELEMETRY_
+            inline _size_type           recordAlloc(_size_type addr, _size_type bytes, _size_type allocatedSize) noexcept
+            {
+                if (addr!=invalid_address)
+                {
+                    telemetryCounters.allocCount++;
+                    telemetryCounters.peakAllocatedSize = std::max<uint64_t>(telemetryCounters.peakAllocatedSize,allocatedSize);
+                }
+                else
+                    telemetryCounters.failedAllocCount++;
+                return addr;
+            }
+            inline void                 recordFree(_size_type bytes) noexcept
+            {
+                telemetryCounters.freeCount++;
+            }
+
+            //! Fills in everything common to all allocators, the derived classes need to add the sizes and the free block histogram
+            inline bool                 getTelemetryCommon(SAddressAllocatorTelemetry& out, const char* type) const
+            {
+                if (maxRequestableAlignment==invalid_address)
+                    return false;
+                out.type = type;
+                out.label = telemetryLabel;
+                out.peakAllocatedSize = telemetryCounters.peakAllocatedSize;
+                out.allocCount = telemetryCounters.allocCount;
+                out.freeCount = telemetryCounters.freeCount;
+                out.failedAllocCount = telemetryCounters.failedAllocCount;
+                return true;
+            }
+
+            struct STelemetryCounters
+            {
+                uint64_t allocCount = 0ull;
+                uint64_t freeCount = 0ull;
+                uint64_t failedAllocCount = 0ull;
+                uint64_t peakAllocatedSize = 0ull;
+            } telemetryCounters;
+            #endif // _NBL_ALLOCATOR_TELEMETRY_
+
             // pointer to allocator specific state-keeping data, please note that irrBaW address allocators were designed to allocate memory they can't actually access
             void*           reservedSpace;
             // automatic offset to be added to generated addresses
@@ -6,6 +6,7 @@
 #define __NBL_CORE_ADDRESS_ALLOCATOR_CONCURRENCY_ADAPTORS_H_INCLUDED__
 
 #include "nbl/core/alloc/address_allocator_traits.h"
+#include "nbl/core/alloc/AddressAllocatorTelemetry.h"
 
 namespace nbl
 {
@@ -28,8 +29,30 @@ class AddressAllocatorBasicConcurrencyAdaptor : private AddressAllocator
         static_assert(address_allocator_traits<AddressAllocator>::supportsArbitraryOrderFrees,"AddressAllocator does not support arbitrary order frees!");
 
 
-        using AddressAllocator::AddressAllocator;
-        virtual ~AddressAllocatorBasicConcurrencyAdaptor() {}
+        // registers again after the allocator did, so that the telemetry snapshots take the lock
+        template<typename... Args>
+        AddressAllocatorBasicConcurrencyAdaptor(Args&&... args) : AddressAllocator(std::forward<Args>(args)...)
+        {
+            AddressAllocator::registerTelemetry(this);
+        }
+        virtual ~AddressAllocatorBasicConcurrencyAdaptor()
+        {
+            // before the lock goes away
+            AddressAllocator::unregisterTelemetry();
+        }
+
+        using AddressAllocator::setTelemetryLabel;
+
+        #ifdef _NBL_ALLOCATOR_TELEMETRY_
+        //! Same as the allocator's, under the lock so `CAddressAllocatorTelemetryRegistry::snapshot()` doesn't race the threads using it
+        inline bool         getTelemetry(SAddressAllocatorTelemetry& out) const
+        {
+            lock.lock();
+            auto retval = AddressAllocator::getTelemetry(out);
+            lock.unlock();
+            return retval;
+        }
+        #endif // _NBL_ALLOCATOR_TELEMETRY_
 
         inline size_type    get_real_addr(size_type allocated_addr) const noexcept
         {
@@ -104,6 +127,7 @@ class AddressAllocatorBasicConcurrencyAdaptor : private AddressAllocator
 
 
         //! Extra == USE WITH EXTREME CAUTION
+        /** Don't create or destroy address allocators while holding it, telemetry snapshots take it while holding the registry's lock. */
         inline RecursiveLockable&   get_lock() noexcept
         {
             // TODO: Some static assert to check that lock type is recursive
@@ -0,0 +1,144 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef __NBL_CORE_ADDRESS_ALLOCATOR_TELEMETRY_H_INCLUDED__
+#define __NBL_CORE_ADDRESS_ALLOCATOR_TELEMETRY_H_INCLUDED__
+
+#include "BuildConfigOptions.h"
+
+#include "nbl/macros.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#ifdef _NBL_ALLOCATOR_TELEMETRY_
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#endif // _NBL_ALLOCATOR_TELEMETRY_
+
+//! Hooks for the `alloc_addr` and `free_addr` methods of address allocators, they compile to nothing without `_NBL_ALLOCATOR_TELEMETRY_`
+#ifdef _NBL_ALLOCATOR_TELEMETRY_
+    #define _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(ADDR,BYTES) Base::recordAlloc(ADDR,BYTES,get_allocated_size())
+    #define _NBL_ADDRESS_ALLOCATOR_RECORD_FREE(BYTES) Base::recordFree(BYTES)
+#else
+    #define _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(ADDR,BYTES) (ADDR)
+    #define _NBL_ADDRESS_ALLOCATOR_RECORD_FREE(BYTES)
+#endif // _NBL_ALLOCATOR_TELEMETRY_
+
+namespace nbl::core
+{
+
+#ifdef _NBL_ALLOCATOR_TELEMETRY_
+//! Point in time statistics of a single address allocator, all sizes are in bytes (or whatever unit the allocator works in)
+struct SAddressAllocatorTelemetry
+{
+    _NBL_STATIC_INLINE_CONSTEXPR uint32_t HistogramBuckets = 64u;
+
+    const char* type = "";
+    const char* label = nullptr;
+
+    uint64_t totalSize = 0ull;
+    uint64_t allocatedSize = 0ull;
+    uint64_t peakAllocatedSize = 0ull;
+    uint64_t freeSize = 0ull;
+    uint64_t largestFreeBlock = 0ull;
+
+    uint64_t allocCount = 0ull;
+    uint64_t freeCount = 0ull;
+    uint64_t failedAllocCount = 0ull;
+
+    //! bucket `i` counts the free blocks with sizes in `[1<<i,2<<i)`
+    uint64_t freeBlockHistogram[HistogramBuckets] = {};
+
+    inline void addFreeBlocks(const uint64_t size, const uint64_t count=1ull)
+    {
+        if (!size || !count)
+            return;
+        freeBlockHistogram[std::bit_width(size)-1u] += count;
+        largestFreeBlock = std::max(largestFreeBlock,size);
+    }
+};
+
+//! Base of every address allocator, the ones which can report telemetry register themselves with `CAddressAllocatorTelemetryRegistry`
+/** Registration has to be done by the class defining `getTelemetry`, at the end of each of its constructors, and undone at the start
+of its destructor. Then a concurrent `snapshot()` never sees a partially constructed or destructed allocator. `getTelemetry` is not
+virtual, the registry calls the one of the class that registered. */
+class NBL_API2 IAddressAllocatorTelemetrySource
+{
+    public:
+        using telemetry_getter_t = bool(*)(const void*,SAddressAllocatorTelemetry&);
+
+        //! The label is not copied, so it needs to outlive the allocator (string literals are ideal)
+        inline void setTelemetryLabel(const char* label) {telemetryLabel = label;}
+
+    protected:
+        IAddressAllocatorTelemetrySource() = default;
+        IAddressAllocatorTelemetrySource(const IAddressAllocatorTelemetrySource& other) = default;
+        //! Only unregisters in case the derived class forgot to
+        virtual ~IAddressAllocatorTelemetrySource();
+
+        IAddressAllocatorTelemetrySource& operator=(const IAddressAllocatorTelemetrySource& other) = delete;
+
+        //! Registering again replaces the getter, so a derived class overriding `getTelemetry` can register after its base did
+        template<class Derived>
+        inline void registerTelemetry(const Derived* self)
+        {
+            registerTelemetry(self,[](const void* object, SAddressAllocatorTelemetry& out) -> bool
+            {
+                return static_cast<const Derived*>(object)->getTelemetry(out);
+            });
+        }
+        void registerTelemetry(const void* object, telemetry_getter_t getter);
+        void unregisterTelemetry();
+
+        const char* telemetryLabel = nullptr;
+};
+
+//! Keeps track of all live address allocators so their statistics can be dumped all at once
+/** Snapshots are synchronized with the creation and destruction of the allocators, and the ones wrapped in
+`AddressAllocatorBasicConcurrencyAdaptor` get read under their lock. The others aren't thread-safe to begin with,
+so only take a snapshot on another thread while nothing is using them, reading their free lists would be a data race. */
+class NBL_API2 CAddressAllocatorTelemetryRegistry final
+{
+    public:
+        static CAddressAllocatorTelemetryRegistry& get();
+
+        std::vector<SAddressAllocatorTelemetry> snapshot() const;
+        //! `{"allocators":[{...},...]}`, histograms are cut off after the last non-empty bucket
+        std::string dumpJSON() const;
+
+    private:
+        friend class IAddressAllocatorTelemetrySource;
+
+        CAddressAllocatorTelemetryRegistry() = default;
+
+        struct SSource
+        {
+            const void* object;
+            IAddressAllocatorTelemetrySource::telemetry_getter_t getter;
+        };
+
+        mutable std::mutex mutex;
+        std::unordered_map<const IAddressAllocatorTelemetrySource*,SSource> sources;
+};
+#else
+//! Empty stand-in, so code can label and register allocators regardless of the build configuration
+class IAddressAllocatorTelemetrySource
+{
+    public:
+        inline void setTelemetryLabel(const char* label) {}
+
+    protected:
+        template<class Derived>
+        inline void registerTelemetry(const Derived* self) {}
+        inline void unregisterTelemetry() {}
+};
+#endif // _NBL_ALLOCATOR_TELEMETRY_
+
+}
+
+#endif
@@ -0,0 +1,503 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef __NBL_CORE_BUDDY_ADDRESS_ALLOCATOR_H_INCLUDED__
+#define __NBL_CORE_BUDDY_ADDRESS_ALLOCATOR_H_INCLUDED__
+
+#include "BuildConfigOptions.h"
+
+#include <bit>
+#include <cstring>
+
+#include "nbl/core/math/intutil.h"
+
+#include "nbl/core/alloc/AddressAllocatorBase.h"
+
+namespace nbl
+{
+namespace core
+{
+
+
+//! Binary buddy allocator, every allocation gets rounded up to `minBlockSize<<level` and is aligned to its own (rounded) size.
+/** The reserved space holds one bitmap per level, a set bit marks a free block of that level. Splitting and merging
+is therefore just a matter of flipping the bit of the buddy (`index^1`), no free-list memory has to be moved around.
+The buffer does not need to be a Power-of-Two multiple of `minBlockSize`, the trailing blocks simply never get a buddy.
+`minBlockSize` must be a Power-of-Two, so that all blocks on a level are aligned to that level's block size.
+It can back a `CMemoryPool` or `SimpleBlockBasedAllocator` with `minBlockSize` as the extra block creation argument. */
+template<typename _size_type>
+class BuddyAddressAllocator : public AddressAllocatorBase<BuddyAddressAllocator<_size_type>,_size_type>
+{
+    private:
+        typedef AddressAllocatorBase<BuddyAddressAllocator<_size_type>,_size_type> Base;
+        typedef uint64_t                                                            bitmap_word_t;
+        _NBL_STATIC_INLINE_CONSTEXPR uint32_t                                       wordBitsLog2 = 6u;
+        _NBL_STATIC_INLINE_CONSTEXPR uint32_t                                       wordBits = 0x1u<<wordBitsLog2;
+
+    public:
+        _NBL_DECLARE_ADDRESS_ALLOCATOR_TYPEDEFS(_size_type);
+
+        static constexpr bool supportsNullBuffer = true;
+        static constexpr uint32_t maxLevels = sizeof(size_type)*8u;
+
+        BuddyAddressAllocator() noexcept : minBlockSize(invalid_address), blockCount(0u), levelCount(0u), freeSize(0u), requestedSize(0u)
+        {
+            Base::registerTelemetry(this);
+        }
+
+        virtual ~BuddyAddressAllocator()
+        {
+            Base::unregisterTelemetry();
+        }
+
+        // `reservedSpc` param for BuddyAddressAllocator cannot be nullptr because it needs to store the bitmaps. Get the exact amount of memory from the `reserved_size` method below.
+        BuddyAddressAllocator(void* reservedSpc, size_type addressOffsetToApply, size_type alignOffsetNeeded, size_type maxAllocatableAlignment, size_type bufSz, size_type minBlockSz) noexcept :
+                    Base(reservedSpc,addressOffsetToApply,alignOffsetNeeded,maxAllocatableAlignment), minBlockSize(minBlockSz),
+                    blockCount((bufSz-Base::alignOffset)/minBlockSz), levelCount(0u), freeSize(0u), requestedSize(0u)
+        {
+            // buffer has to be large enough for at least one block of minimum size
+            assert(bufSz>=Base::alignOffset+minBlockSize && blockCount);
+            // otherwise block alignment could not be reasoned about
+            assert(core::isPoT(minBlockSize));
+
+            initLevels();
+            reset();
+            Base::registerTelemetry(this);
+        }
+
+        template<typename... Args>
+        BuddyAddressAllocator(size_type newBuffSz, const BuddyAddressAllocator& other, void* newReservedSpc, Args&&... args) noexcept :
+                    Base(other,newReservedSpc,std::forward<Args>(args)...), minBlockSize(other.minBlockSize),
+                    blockCount((newBuffSz-Base::alignOffset)/other.minBlockSize), levelCount(0u), freeSize(0u), requestedSize(other.requestedSize)
+        {
+            copyState(other,other.getBitmap(0u));
+            Base::registerTelemetry(this);
+        }
+        //! When resizing we require that the copying of data buffer has already been handled by the user of the address allocator
+        /** `newReservedSpc` may be the reserved space of `other`, the bitmaps then get moved in place. */
+        template<typename... Args>
+        BuddyAddressAllocator(size_type newBuffSz, BuddyAddressAllocator&& other, void* newReservedSpc, Args&&... args) noexcept :
+                    // the move of the base takes the reserved space away from `other`, so grab its bitmaps first
+                    BuddyAddressAllocator(other.getBitmap(0u),newBuffSz,std::move(other),newReservedSpc,std::forward<Args>(args)...) {}
+
+        BuddyAddressAllocator& operator=(BuddyAddressAllocator&& other)
+        {
+            Base::operator=(std::move(other));
+            std::swap(minBlockSize,other.minBlockSize);
+            std::swap(blockCount,other.blockCount);
+            std::swap(levelCount,other.levelCount);
+            std::swap(freeSize,other.freeSize);
+            std::swap(requestedSize,other.requestedSize);
+            std::swap(bitmapOffset,other.bitmapOffset);
+            std::swap(freeBlockCount,other.freeBlockCount);
+            std::swap(searchHint,other.searchHint);
+            return *this;
+        }
+
+        //! non-PoT alignments get rounded up to the next PoT
+        inline size_type        alloc_addr(size_type bytes, size_type alignment, size_type hint=0ull) noexcept
+        {
+            if (alignment>Base::maxRequestableAlignment || bytes==0u || bytes>freeSize)
+                return _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(invalid_address,bytes);
+
+            const uint32_t level = sizeToLevel(bytes);
+            if (level>=levelCount)
+                return _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(invalid_address,bytes);
+            const uint32_t alignLevel = alignment>minBlockSize ? hlsl::findMSB(core::roundUpToPoT(alignment)/minBlockSize):0u;
+
+            for (uint32_t l=level; l<levelCount; l++)
+            {
+                if (!freeBlockCount[l])
+                    continue;
+
+                // blocks of higher levels are always aligned enough, lower ones need every N-th block
+                const uint32_t strideLog2 = alignLevel>l ? (alignLevel-l):0u;
+                size_type index = findFreeBlock(l,strideLog2);
+                if (index==invalid_address)
+                    continue;
+                if (!strideLog2)
+                    searchHint[l] = index>>wordBitsLog2;
+                clearFree(l,index);
+
+                // split down, always keeping the left child so alignment is preserved, and release the right buddy
+                for (; l>level; l--)
+                {
+                    index <<= 1u;
+                    setFree(l-1u,index|size_type(1u));
+                }
+
+                freeSize -= levelToSize(level);
+                requestedSize += bytes;
+                return _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(levelToSize(level)*index+Base::combinedOffset,bytes);
+            }
+
+            return _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(invalid_address,bytes);
+        }
+
+        inline void             free_addr(size_type addr, size_type bytes) noexcept
+        {
+            const uint32_t level = sizeToLevel(bytes);
+#ifdef _NBL_DEBUG
+            // address must have had combinedOffset already applied to it, and allocation must not be outside the buffer
+            assert(addr>=Base::combinedOffset && addr-Base::combinedOffset+levelToSize(level)<=blockCount*minBlockSize);
+            // address must be aligned to the size of its block
+            assert(((addr-Base::combinedOffset)&(levelToSize(level)-1u))==0u);
+#endif // _NBL_DEBUG
+            const size_type index = (addr-Base::combinedOffset)/levelToSize(level);
+#ifdef _NBL_DEBUG
+            // double free protection, neither the block nor any of its ancestors can be free
+            for (uint32_t l=level; l<levelCount && (index>>(l-level))<(blockCount>>l); l++)
+                assert(!isFree(l,index>>(l-level)));
+#endif // _NBL_DEBUG
+            freeBlock(level,index);
+
+            freeSize += levelToSize(level);
+            requestedSize -= bytes;
+            _NBL_ADDRESS_ALLOCATOR_RECORD_FREE(bytes);
+        }
+
+        inline void             reset()
+        {
+            std::fill_n(getBitmap(0u),bitmapOffset[levelCount],bitmap_word_t(0u));
+            std::fill_n(freeBlockCount,levelCount,size_type(0u));
+            std::fill_n(searchHint,levelCount,size_type(0u));
+            freeSize = 0u;
+            requestedSize = 0u;
+
+            freeRange(0u,blockCount);
+        }
+
+        //! Conservative estimate, max_size() gives largest size we are sure to be able to allocate
+        inline size_type        max_size() const noexcept
+        {
+            const uint32_t alignLevel = Base::maxRequestableAlignment>minBlockSize ? hlsl::findMSB(Base::maxRequestableAlignment/minBlockSize):0u;
+            for (uint32_t l=levelCount; l>0u; l--)
+            {
+                const uint32_t level = l-1u;
+                if (freeBlockCount[level] && findFreeBlock(level,alignLevel>level ? (alignLevel-level):0u)!=invalid_address)
+                    return levelToSize(level);
+            }
+            return 0u;
+        }
+
+        //! Most allocators do not support e.g. 1-byte allocations
+        inline size_type        min_size() const noexcept
+        {
+            return minBlockSize;
+        }
+
+        inline size_type        safe_shrink_size(size_type sizeBound, size_type newBuffAlignmentWeCanGuarantee=1u) const noexcept
+        {
+            if (sizeBound>=blockCount*minBlockSize)
+                return Base::safe_shrink_size(sizeBound,newBuffAlignmentWeCanGuarantee);
+
+            // peel free blocks off the end of the buffer, biggest first
+            size_type tail = blockCount;
+            for (bool peeled=true; peeled && tail; )
+            {
+                peeled = false;
+                for (uint32_t l=levelCount; l>0u; l--)
+                {
+                    const uint32_t level = l-1u;
+                    const size_type levelBlockSz = size_type(1u)<<level;
+                    if ((tail&(levelBlockSz-1u)) || tail<levelBlockSz || !isFree(level,(tail>>level)-1u))
+                        continue;
+
+                    tail -= levelBlockSz;
+                    peeled = true;
+                    break;
+                }
+            }
+
+            return Base::safe_shrink_size(std::max(tail*minBlockSize,sizeBound),newBuffAlignmentWeCanGuarantee);
+        }
+
+
+        static inline size_type reserved_size(size_type maxAlignment, size_type bufSz, size_type minBlockSz) noexcept
+        {
+            const size_type blocks = bufSz/minBlockSz;
+            if (!blocks)
+                return 0u;
+            size_type words = 0u;
+            for (uint32_t level=0u; level<=uint32_t(hlsl::findMSB(blocks)); level++)
+                words += wordCount(blocks>>level);
+            return words*sizeof(bitmap_word_t);
+        }
+        static inline size_type reserved_size(size_type bufSz, const BuddyAddressAllocator<_size_type>& other) noexcept
+        {
+            return reserved_size(other.maxRequestableAlignment,bufSz,other.minBlockSize);
+        }
+        static inline size_type reserved_size(const BuddyAddressAllocator<_size_type>& other, size_type bufSz) noexcept
+        {
+            return reserved_size(bufSz,other);
+        }
+
+        inline size_type        get_free_size() const noexcept
+        {
+            return freeSize;
+        }
+        inline size_type        get_allocated_size() const noexcept
+        {
+            return blockCount*minBlockSize-freeSize;
+        }
+        inline size_type        get_total_size() const noexcept
+        {
+            return blockCount*minBlockSize+Base::alignOffset;
+        }
+
+        //! Fragmentation statistics
+        inline uint32_t         get_level_count() const noexcept
+        {
+            return levelCount;
+        }
+        inline size_type        get_block_size(uint32_t level) const noexcept
+        {
+            return levelToSize(level);
+        }
+        inline size_type        get_free_block_count(uint32_t level) const noexcept
+        {
+            return level<levelCount ? freeBlockCount[level]:size_type(0u);
+        }
+        //! Ignores alignment, unlike `max_size()`
+        inline size_type        get_largest_free_block_size() const noexcept
+        {
+            for (uint32_t l=levelCount; l>0u; l--)
+            if (freeBlockCount[l-1u])
+                return levelToSize(l-1u);
+            return 0u;
+        }
+        //! Bytes lost to rounding the live allocations up to their buddy block sizes
+        inline size_type        get_internal_fragmentation() const noexcept
+        {
+            return get_allocated_size()-requestedSize;
+        }
+        //! 0 when all the free space is in one block, approaches 1 when it's scattered among many small blocks
+        inline double           get_external_fragmentation() const noexcept
+        {
+            if (freeSize==0u)
+                return 0.0;
+            return 1.0-double(get_largest_free_block_size())/double(freeSize);
+        }
+
+        #ifdef _NBL_ALLOCATOR_TELEMETRY_
+        bool                    getTelemetry(SAddressAllocatorTelemetry& out) const
+        {
+            if (!Base::getTelemetryCommon(out,"BuddyAddressAllocator"))
+                return false;
+            out.totalSize = get_total_size();
+            out.allocatedSize = get_allocated_size();
+            out.freeSize = get_free_size();
+            for (uint32_t level=0u; level<levelCount; level++)
+                out.addFreeBlocks(levelToSize(level),freeBlockCount[level]);
+            return true;
+        }
+        #endif // _NBL_ALLOCATOR_TELEMETRY_
+
+    protected:
+        template<typename... Args>
+        BuddyAddressAllocator(const bitmap_word_t* oldBitmaps, size_type newBuffSz, BuddyAddressAllocator&& other, void* newReservedSpc, Args&&... args) noexcept :
+                    Base(std::move(other),newReservedSpc,std::forward<Args>(args)...), minBlockSize(other.minBlockSize),
+                    blockCount((newBuffSz-Base::alignOffset)/other.minBlockSize), levelCount(0u), freeSize(0u), requestedSize(other.requestedSize)
+        {
+            copyState(other,oldBitmaps);
+
+            other.minBlockSize = invalid_address;
+            other.blockCount = 0u;
+            other.levelCount = 0u;
+            other.freeSize = 0u;
+            other.requestedSize = 0u;
+            Base::registerTelemetry(this);
+        }
+
+        size_type       minBlockSize;
+        // in units of `minBlockSize`
+        size_type       blockCount;
+        uint32_t        levelCount;
+        size_type       freeSize;
+        size_type       requestedSize;
+        // in `bitmap_word_t` units, one extra entry so we know the total bitmap size
+        size_type       bitmapOffset[maxLevels+1u];
+        size_type       freeBlockCount[maxLevels];
+        // no bits are set in words below the hint
+        size_type       searchHint[maxLevels];
+
+        static inline size_type         wordCount(size_type bitCount) noexcept
+        {
+            return (bitCount+wordBits-1u)>>wordBitsLog2;
+        }
+
+        inline bitmap_word_t*           getBitmap(uint32_t level) noexcept {return reinterpret_cast<bitmap_word_t*>(Base::reservedSpace)+bitmapOffset[level];}
+        inline const bitmap_word_t*     getBitmap(uint32_t level) const noexcept {return reinterpret_cast<const bitmap_word_t*>(Base::reservedSpace)+bitmapOffset[level];}
+
+        inline bool                     isFree(uint32_t level, size_type index) const noexcept
+        {
+            return (getBitmap(level)[index>>wordBitsLog2]>>(index&(wordBits-1u)))&0x1u;
+        }
+        inline void                     setFree(uint32_t level, size_type index) noexcept
+        {
+            const size_type word = index>>wordBitsLog2;
+            getBitmap(level)[word] |= bitmap_word_t(0x1u)<<(index&(wordBits-1u));
+            freeBlockCount[level]++;
+            searchHint[level] = std::min(searchHint[level],word);
+        }
+        inline void                     clearFree(uint32_t level, size_type index) noexcept
+        {
+            getBitmap(level)[index>>wordBitsLog2] &= ~(bitmap_word_t(0x1u)<<(index&(wordBits-1u)));
+            freeBlockCount[level]--;
+        }
+
+        inline size_type                levelToSize(uint32_t level) const noexcept
+        {
+            return minBlockSize<<size_type(level);
+        }
+        inline uint32_t                 sizeToLevel(size_type bytes) const noexcept
+        {
+            const size_type blocks = (bytes+minBlockSize-1u)/minBlockSize;
+            return blocks>1u ? uint32_t(hlsl::findMSB(blocks-1u)+1):0u;
+        }
+
+        //! Returns the index of the lowest free block at `level` which is a multiple of `1<<strideLog2`
+        inline size_type                findFreeBlock(uint32_t level, uint32_t strideLog2) const noexcept
+        {
+            const bitmap_word_t* bitmap = getBitmap(level);
+            const size_type words = bitmapOffset[level+1u]-bitmapOffset[level];
+            if (strideLog2<wordBitsLog2)
+            {
+                // every `1<<strideLog2`-th bit set
+                const bitmap_word_t mask = (~bitmap_word_t(0u))/((bitmap_word_t(0x1u)<<(0x1u<<strideLog2))-1u);
+                for (size_type w=strideLog2 ? 0u:searchHint[level]; w<words; w++)
+                {
+                    const bitmap_word_t candidates = bitmap[w]&mask;
+                    if (candidates)
+                        return (w<<wordBitsLog2)+hlsl::findLSB(candidates);
+                }
+            }
+            else for (size_type w=0u; w<words; w+=size_type(1u)<<(strideLog2-wordBitsLog2))
+            {
+                if (bitmap[w]&0x1u)
+                    return w<<wordBitsLog2;
+            }
+            return invalid_address;
+        }
+
+        inline void                     freeBlock(uint32_t level, size_type index) noexcept
+        {
+            // merge with the buddy for as long as its free
+            for (; level+1u<levelCount; level++,index>>=1u)
+            {
+                const size_type buddy = index^size_type(1u);
+                if (buddy>=(blockCount>>level) || !isFree(level,buddy))
+                    break;
+                clearFree(level,buddy);
+            }
+            setFree(level,index);
+        }
+
+        //! Frees a range of `minBlockSize` units by decomposing it into the largest possible aligned blocks
+        inline void                     freeRange(size_type start, size_type end) noexcept
+        {
+            while (start<end)
+            {
+                uint32_t level = start ? std::min<uint32_t>(hlsl::findLSB(start),levelCount-1u):(levelCount-1u);
+                while (start+(size_type(1u)<<level)>end)
+                    level--;
+                freeBlock(level,start>>level);
+                freeSize += levelToSize(level);
+                start += size_type(1u)<<level;
+            }
+        }
+
+        inline void                     initLevels() noexcept
+        {
+            levelCount = hlsl::findMSB(blockCount)+1u;
+            bitmapOffset[0] = 0u;
+            for (uint32_t level=0u; level<levelCount; level++)
+                bitmapOffset[level+1u] = bitmapOffset[level]+wordCount(blockCount>>level);
+        }
+
+        //! `oldBitmaps` may alias the new reserved space, so every level is read before anything overlapping it gets written
+        void                            copyState(const BuddyAddressAllocator& other, const bitmap_word_t* oldBitmaps)
+        {
+            initLevels();
+
+            // on a shrink at most one free block can straddle the new end, remember it before its bits get overwritten
+            size_type straddleStart = blockCount;
+            for (uint32_t level=0u; level<other.levelCount; level++)
+            {
+                const size_type index = blockCount>>level;
+                if ((index<<level)==blockCount || index>=(other.blockCount>>level))
+                    continue;
+                const bitmap_word_t* bitmap = oldBitmaps+other.bitmapOffset[level];
+                if ((bitmap[index>>wordBitsLog2]>>(index&(wordBits-1u)))&0x1u)
+                {
+                    straddleStart = index<<level;
+                    break;
+                }
+            }
+
+            // levels only ever move up on a grow and down on a shrink, so walk them in the order which never overwrites unread ones
+            const bool grow = blockCount>=other.blockCount;
+            for (uint32_t i=0u; i<levelCount; i++)
+            {
+                const uint32_t level = grow ? (levelCount-1u-i):i;
+                bitmap_word_t* bitmap = getBitmap(level);
+                const size_type words = bitmapOffset[level+1u]-bitmapOffset[level];
+                size_type copied = 0u;
+                if (level<other.levelCount)
+                {
+                    copied = std::min(words,other.bitmapOffset[level+1u]-other.bitmapOffset[level]);
+                    std::memmove(bitmap,oldBitmaps+other.bitmapOffset[level],copied*sizeof(bitmap_word_t));
+                }
+                std::fill_n(bitmap+copied,words-copied,bitmap_word_t(0u));
+                // drop the blocks which don't fit anymore
+                const size_type levelBlocks = blockCount>>level;
+                if (levelBlocks&(wordBits-1u))
+                    bitmap[words-1u] &= (bitmap_word_t(0x1u)<<(levelBlocks&(wordBits-1u)))-1u;
+            }
+
+            freeSize = 0u;
+            for (uint32_t level=0u; level<levelCount; level++)
+            {
+                const bitmap_word_t* bitmap = getBitmap(level);
+                freeBlockCount[level] = 0u;
+                for (size_type w=0u; w<bitmapOffset[level+1u]-bitmapOffset[level]; w++)
+                    freeBlockCount[level] += std::popcount(bitmap[w]);
+                freeSize += freeBlockCount[level]*levelToSize(level);
+                searchHint[level] = 0u;
+            }
+
+            // what's left of the straddling block in case of a shrink, and the new space in case of a grow
+            if (straddleStart<blockCount)
+                freeRange(straddleStart,blockCount);
+            else if (blockCount>other.blockCount)
+                freeRange(other.blockCount,blockCount);
+            #ifdef _NBL_DEBUG
+                // cannot shrink below the live allocations
+                assert(get_allocated_size()==other.blockCount*other.minBlockSize-other.freeSize);
+            #endif // _NBL_DEBUG
+        }
+};
+
+
+}
+}
+
+#include "nbl/core/alloc/AddressAllocatorConcurrencyAdaptors.h"
+
+namespace nbl
+{
+namespace core
+{
+
+// aliases
+template<typename size_type>
+using BuddyAddressAllocatorST = BuddyAddressAllocator<size_type>;
+
+template<typename size_type, class RecursiveLockable>
+using BuddyAddressAllocatorMT = AddressAllocatorBasicConcurrencyAdaptor<BuddyAddressAllocator<size_type>,RecursiveLockable>;
+
+}
+}
+
+#endif
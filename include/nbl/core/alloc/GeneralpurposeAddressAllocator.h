@@ -444,9 +444,15 @@ class GeneralpurposeAddressAllocator : public AddressAllocatorBase<Generalpurpos
 
         static constexpr bool supportsNullBuffer = true;
 
-        GeneralpurposeAddressAllocator() noexcept : AllocStrategy(invalid_address,invalid_address) {}
+        GeneralpurposeAddressAllocator() noexcept : AllocStrategy(invalid_address,invalid_address)
+        {
+            Base::registerTelemetry(this);
+        }
 
-        virtual ~GeneralpurposeAddressAllocator() {}
+        virtual ~GeneralpurposeAddressAllocator()
+        {
+            Base::unregisterTelemetry();
+        }
 
         // `reservedSpc` param for GeneralpurposeAddressAllocator cannot be nullptr because it needs some memory to operate. Get the exact amount of memory from the `reserved_size`
         // method below.
@@ -459,6 +465,7 @@ class GeneralpurposeAddressAllocator : public AddressAllocatorBase<Generalpurpos
             assert(AllocStrategy::findFreeListInsertIndex(AllocStrategy::bufferSize) < AllocStrategy::maxListLevels);
 
             reset();
+            Base::registerTelemetry(this);
         }
 
         template<typename... Args>
@@ -466,6 +473,7 @@ class GeneralpurposeAddressAllocator : public AddressAllocatorBase<Generalpurpos
                     Base(other,newReservedSpc,std::forward<Args>(args)...),
                     AllocStrategy(newBuffSz-Base::alignOffset,std::move(other),newReservedSpc)
         {
+            Base::registerTelemetry(this);
         }
         //! When resizing we require that the copying of data buffer has already been handled by the user of the address allocator
         template<typename... Args>
@@ -473,6 +481,7 @@ class GeneralpurposeAddressAllocator : public AddressAllocatorBase<Generalpurpos
                     Base(std::move(other),newReservedSpc,std::forward<Args>(args)...),
                     AllocStrategy(newBuffSz-Base::alignOffset,std::move(other),newReservedSpc)
         {
+            Base::registerTelemetry(this);
         }
 
         GeneralpurposeAddressAllocator& operator=(GeneralpurposeAddressAllocator&& other)
@@ -486,11 +495,11 @@ class GeneralpurposeAddressAllocator : public AddressAllocatorBase<Generalpurpos
         inline size_type        alloc_addr( size_type bytes, size_type alignment, size_type hint=0ull) noexcept
         {
             if (alignment>Base::maxRequestableAlignment || bytes==0u)
-                return invalid_address;
+                return _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(invalid_address,bytes);
 
             bytes = std::max(bytes,AllocStrategy::minBlockSize);
             if (bytes>AllocStrategy::freeSize)
-                return invalid_address;
+                return _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(invalid_address,bytes);
 
             std::pair<Block,Block> found;
             for (auto i=0u; i<2u; i++)
@@ -506,7 +515,7 @@ class GeneralpurposeAddressAllocator : public AddressAllocatorBase<Generalpurpos
 
             // not found anything
             if (found.first.startOffset==invalid_address)
-                return invalid_address;
+                return _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(invalid_address,bytes);
 
             // splice block and insert parts onto free list
             if (found.first.endOffset!=found.second.endOffset)
@@ -520,7 +529,7 @@ class GeneralpurposeAddressAllocator : public AddressAllocatorBase<Generalpurpos
             // sanity check
             assert(AllocStrategy::freeSize+bytes<=AllocStrategy::bufferSize);
 #endif // _NBL_DEBUG
-            return found.first.startOffset+Base::combinedOffset;
+            return _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(found.first.startOffset+Base::combinedOffset,bytes);
         }
 
         inline void             free_addr(size_type addr, size_type bytes) noexcept
@@ -539,6 +548,7 @@ class GeneralpurposeAddressAllocator : public AddressAllocatorBase<Generalpurpos
             assert(!AllocStrategy::is_double_free(addr,bytes));
 #endif // _EXTREME_DEBUG
             AllocStrategy::insertFreeBlock(Block{addr,addr+bytes});
+            _NBL_ADDRESS_ALLOCATOR_RECORD_FREE(bytes);
         }
 
         inline void             reset()
@@ -635,6 +645,27 @@ class GeneralpurposeAddressAllocator : public AddressAllocatorBase<Generalpurpos
             return AllocStrategy::is_double_free(addr-Base::combinedOffset,bytes);
         }
 
+        #ifdef _NBL_ALLOCATOR_TELEMETRY_
+        bool                    getTelemetry(SAddressAllocatorTelemetry& out) const
+        {
+            if (!Base::getTelemetryCommon(out,"GeneralpurposeAddressAllocator"))
+                return false;
+            out.totalSize = get_total_size();
+            out.allocatedSize = get_allocated_size();
+            out.freeSize = get_free_size();
+            // free lists are only binned by size, so go over all the blocks for an exact histogram
+            for (decltype(AllocStrategy::freeListCount) level=0u; level<AllocStrategy::freeListCount; level++)
+            {
+                // moved-from allocators keep their list count but lose the lists
+                if (!AllocStrategy::freeListStack[level])
+                    continue;
+                for (size_type i=0u; i<AllocStrategy::freeListStackCtr[level]; i++)
+                    out.addFreeBlocks(AllocStrategy::freeListStack[level][i].getLength());
+            }
+            return true;
+        }
+        #endif // _NBL_ALLOCATOR_TELEMETRY_
+
     protected:
         inline size_type        defragment() noexcept
         {
@@ -20,16 +20,20 @@ class LinearAddressAllocator : public AddressAllocatorBase<LinearAddressAllocato
     public:
         _NBL_DECLARE_ADDRESS_ALLOCATOR_TYPEDEFS(_size_type);
 
-        #define DUMMY_DEFAULT_CONSTRUCTOR LinearAddressAllocator() : bufferSize(invalid_address), cursor(invalid_address) {}
+        #define DUMMY_DEFAULT_CONSTRUCTOR LinearAddressAllocator() : bufferSize(invalid_address), cursor(invalid_address) {Base::registerTelemetry(this);}
         GCC_CONSTRUCTOR_INHERITANCE_BUG_WORKAROUND(DUMMY_DEFAULT_CONSTRUCTOR)
         #undef DUMMY_DEFAULT_CONSTRUCTOR
 
-        virtual ~LinearAddressAllocator() {}
+        virtual ~LinearAddressAllocator()
+        {
+            Base::unregisterTelemetry();
+        }
 
         LinearAddressAllocator(void* reservedSpc, _size_type addressOffsetToApply, _size_type alignOffsetNeeded, _size_type maxAllocatableAlignment, size_type bufSz) noexcept :
                     Base(reservedSpc,addressOffsetToApply,alignOffsetNeeded,maxAllocatableAlignment), bufferSize(bufSz-Base::alignOffset)
         {
             reset();
+            Base::registerTelemetry(this);
         }
 
         //! When resizing we require that the copying of data buffer has already been handled by the user of the address allocator
@@ -40,12 +44,14 @@ class LinearAddressAllocator : public AddressAllocatorBase<LinearAddressAllocato
             std::swap(bufferSize,other.bufferSize);
             bufferSize = newBuffSz-Base::alignOffset;
             std::swap(cursor,other.cursor);
+            Base::registerTelemetry(this);
         }
         template<typename... Args>
         LinearAddressAllocator(_size_type newBuffSz, const LinearAddressAllocator& other, Args&&... args) :
             Base(other,std::forward<Args>(args)...), bufferSize(invalid_address), cursor(other.cursor)
         {
             bufferSize = newBuffSz-Base::alignOffset;
+            Base::registerTelemetry(this);
         }
 
         LinearAddressAllocator& operator=(LinearAddressAllocator&& other)
@@ -60,20 +66,21 @@ class LinearAddressAllocator : public AddressAllocatorBase<LinearAddressAllocato
         inline size_type    alloc_addr( size_type bytes, size_type alignment, size_type hint=0ull) noexcept
         {
             if (bytes==0 || alignment>Base::maxRequestableAlignment)
-                return invalid_address;
+                return _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(invalid_address,bytes);
 
             size_type result = core::roundUp(cursor,alignment);
             size_type newCursor = result+bytes;
             if (newCursor>bufferSize || newCursor<cursor) // the extra OR checks for wraparound
-                return invalid_address;
+                return _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(invalid_address,bytes);
 
             cursor = newCursor;
-            return result+Base::combinedOffset;
+            return _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(result+Base::combinedOffset,bytes);
         }
 
         // free is a No-OP, only reset can actually reclaim memory
         inline void         free_addr(size_type addr, size_type bytes) noexcept
         {
+            _NBL_ADDRESS_ALLOCATOR_RECORD_FREE(bytes);
             return;
         }
 
@@ -125,6 +132,19 @@ class LinearAddressAllocator : public AddressAllocatorBase<LinearAddressAllocato
         {
             return bufferSize+Base::alignOffset;
         }
+
+        #ifdef _NBL_ALLOCATOR_TELEMETRY_
+        bool                    getTelemetry(SAddressAllocatorTelemetry& out) const
+        {
+            if (!Base::getTelemetryCommon(out,"LinearAddressAllocator"))
+                return false;
+            out.totalSize = get_total_size();
+            out.allocatedSize = get_allocated_size();
+            out.freeSize = get_free_size();
+            out.addFreeBlocks(out.freeSize);
+            return true;
+        }
+        #endif // _NBL_ALLOCATOR_TELEMETRY_
     protected:
         size_type bufferSize;
         size_type       cursor;
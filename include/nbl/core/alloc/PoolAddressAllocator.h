@@ -66,15 +66,22 @@ class PoolAddressAllocator : public AddressAllocatorBase<PoolAddressAllocator<_s
 
         static constexpr bool supportsNullBuffer = true;
 
-        PoolAddressAllocator() : blockSize(1u), blockCount(0u) {}
+        PoolAddressAllocator() : blockSize(1u), blockCount(0u)
+        {
+            Base::registerTelemetry(this);
+        }
 
-        virtual ~PoolAddressAllocator() {}
+        virtual ~PoolAddressAllocator()
+        {
+            Base::unregisterTelemetry();
+        }
 
         PoolAddressAllocator(void* reservedSpc, _size_type addressOffsetToApply, _size_type alignOffsetNeeded, _size_type maxAllocatableAlignment, size_type bufSz, size_type blockSz) noexcept :
 					Base(reservedSpc,addressOffsetToApply,alignOffsetNeeded,maxAllocatableAlignment),
 						blockCount((bufSz-alignOffsetNeeded)/blockSz), blockSize(blockSz), freeStackCtr(0u)
         {
             reset();
+            Base::registerTelemetry(this);
         }
 
         //! When resizing we require that the copying of data buffer has already been handled by the user of the address allocator
@@ -88,6 +95,7 @@ class PoolAddressAllocator : public AddressAllocatorBase<PoolAddressAllocator<_s
             other.blockCount = invalid_address;
 			other.blockSize = invalid_address;
             other.freeStackCtr = invalid_address;
+            Base::registerTelemetry(this);
         }
         template<typename... Args>
         PoolAddressAllocator(_size_type newBuffSz, const PoolAddressAllocator& other, Args&&... args) noexcept :
@@ -95,6 +103,7 @@ class PoolAddressAllocator : public AddressAllocatorBase<PoolAddressAllocator<_s
             blockCount((newBuffSz-Base::alignOffset)/other.blockSize), blockSize(other.blockSize), freeStackCtr(0u)
         {
             copyState(other, newBuffSz);
+            Base::registerTelemetry(this);
         }
 
         PoolAddressAllocator& operator=(PoolAddressAllocator&& other)
@@ -110,9 +119,10 @@ class PoolAddressAllocator : public AddressAllocatorBase<PoolAddressAllocator<_s
         inline size_type        alloc_addr( size_type bytes, size_type alignment, size_type hint=0ull) noexcept
         {
             if (freeStackCtr==0u || (blockSize%alignment)!=0u || bytes==0u || bytes>blockSize)
-                return invalid_address;
+                return _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(invalid_address,bytes);
 
-            return getFreeStack(--freeStackCtr);
+            freeStackCtr--;
+            return _NBL_ADDRESS_ALLOCATOR_RECORD_ALLOC(getFreeStack(freeStackCtr),bytes);
         }
 
         inline void             free_addr(size_type addr, size_type bytes) noexcept
@@ -121,6 +131,7 @@ class PoolAddressAllocator : public AddressAllocatorBase<PoolAddressAllocator<_s
                 assert(addr>=Base::combinedOffset && (addr-Base::combinedOffset)%blockSize==0 && freeStackCtr<blockCount);
             #endif // _NBL_DEBUG
 			getFreeStack(freeStackCtr++) = addr;
+            _NBL_ADDRESS_ALLOCATOR_RECORD_FREE(bytes);
         }
 
         inline void             reset()
@@ -200,6 +211,19 @@ class PoolAddressAllocator : public AddressAllocatorBase<PoolAddressAllocator<_s
             return blockCount*blockSize+Base::alignOffset;
         }
 
+        #ifdef _NBL_ALLOCATOR_TELEMETRY_
+        bool                    getTelemetry(SAddressAllocatorTelemetry& out) const
+        {
+            if (!Base::getTelemetryCommon(out,"PoolAddressAllocator"))
+                return false;
+            out.totalSize = get_total_size();
+            out.allocatedSize = get_allocated_size();
+            out.freeSize = get_free_size();
+            out.addFreeBlocks(blockSize,freeStackCtr);
+            return true;
+        }
+        #endif // _NBL_ALLOCATOR_TELEMETRY_
+
 
 
         inline size_type addressToBlockID(size_type addr) const noexcept
@@ -24,14 +24,22 @@ class StackAddressAllocator  : protected LinearAddressAllocator<_size_type>
 
         _NBL_DECLARE_ADDRESS_ALLOCATOR_TYPEDEFS(_size_type);
 
-        #define DUMMY_DEFAULT_CONSTRUCTOR StackAddressAllocator() : minimumAllocSize(invalid_address), allocStackPtr(invalid_address) {}
+        using Base::setTelemetryLabel;
+
+        #define DUMMY_DEFAULT_CONSTRUCTOR StackAddressAllocator() : minimumAllocSize(invalid_address), allocStackPtr(invalid_address) {Base::registerTelemetry(this);}
         GCC_CONSTRUCTOR_INHERITANCE_BUG_WORKAROUND(DUMMY_DEFAULT_CONSTRUCTOR)
         #undef DUMMY_DEFAULT_CONSTRUCTOR
 
-        virtual ~StackAddressAllocator() {}
+        virtual ~StackAddressAllocator()
+        {
+            Base::unregisterTelemetry();
+        }
 
         StackAddressAllocator(void* reservedSpc, _size_type addressOffsetToApply, _size_type alignOffsetNeeded, _size_type maxAllocatableAlignment, size_type bufSz, size_type minAllocSize) noexcept :
-                    Base(reservedSpc,addressOffsetToApply,alignOffsetNeeded,maxAllocatableAlignment,bufSz), minimumAllocSize(minAllocSize), allocStackPtr(0u) {}
+                    Base(reservedSpc,addressOffsetToApply,alignOffsetNeeded,maxAllocatableAlignment,bufSz), minimumAllocSize(minAllocSize), allocStackPtr(0u)
+        {
+            Base::registerTelemetry(this);
+        }
 
         //! When resizing we require that the copying of data buffer has already been handled by the user of the address allocator
         template<typename... Args>
@@ -40,6 +48,7 @@ class StackAddressAllocator  : protected LinearAddressAllocator<_size_type>
         {
             std::swap(minimumAllocSize,other.minimumAllocSize);
             std::swap(allocStackPtr,other.allocStackPtr);
+            Base::registerTelemetry(this);
         }
 
         template<typename... Args>
@@ -47,6 +56,7 @@ class StackAddressAllocator  : protected LinearAddressAllocator<_size_type>
             Base(newBuffSz, other, std::forward<Args>(args)...),
             minimumAllocSize(other.minimumAllocSize), allocStackPtr(other.allocStackPtr)
         {
+            Base::registerTelemetry(this);
         }
 
         StackAddressAllocator& operator=(StackAddressAllocator&& other)
@@ -79,6 +89,7 @@ class StackAddressAllocator  : protected LinearAddressAllocator<_size_type>
             #ifdef _NBL_DEBUG
                 assert(Base::cursor+Base::alignOffset<=addr);
             #endif // _NBL_DEBUG
+            _NBL_ADDRESS_ALLOCATOR_RECORD_FREE(bytes);
         }
 
         inline void         reset()
@@ -121,6 +132,16 @@ class StackAddressAllocator  : protected LinearAddressAllocator<_size_type>
         {
             return Base::get_total_size();
         }
+
+        #ifdef _NBL_ALLOCATOR_TELEMETRY_
+        bool                    getTelemetry(SAddressAllocatorTelemetry& out) const
+        {
+            if (!Base::getTelemetry(out))
+                return false;
+            out.type = "StackAddressAllocator";
+            return true;
+        }
+        #endif // _NBL_ALLOCATOR_TELEMETRY_
     protected:
         size_type minimumAllocSize;
         size_type allocStackPtr;
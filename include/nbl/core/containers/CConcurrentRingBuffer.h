@@ -0,0 +1,360 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef __NBL_C_CONCURRENT_RING_BUFFER_H_INCLUDED__
+#define __NBL_C_CONCURRENT_RING_BUFFER_H_INCLUDED__
+
+#include "nbl/core/decl/Types.h"
+#include "nbl/core/memory/memory.h"
+#include "nbl/core/math/intutil.h"
+
+#include <atomic>
+#include <new>
+
+namespace nbl::core
+{
+
+namespace impl
+{
+
+class CConcurrentRingBufferCommonBase
+{
+public:
+    // not using `std::hardware_destructive_interference_size` because it makes the layout depend on compiler flags
+    static constexpr inline size_t CacheLineSize = 64ull;
+
+protected:
+    using counter_t = uint64_t;
+    using atomic_counter_t = std::atomic<counter_t>;
+
+    // own cache line, so that the producer and consumer side don't false-share
+    struct alignas(CacheLineSize) SPaddedCounter
+    {
+        atomic_counter_t value = 0u;
+    };
+
+    //! Blocks until `atom` stops being `old`, while registered as a waiter so `notify` knows to wake us up
+    template <typename U>
+    inline void wait(const std::atomic<U>& atom, const U old)
+    {
+        m_waiters.count.fetch_add(1u,std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        atom.wait(old,std::memory_order_acquire);
+        m_waiters.count.fetch_sub(1u,std::memory_order_relaxed);
+    }
+    //! For when only one thread can ever be blocked, and only on the `atom` the other thread publishes to
+    /** The waker takes the registration away, so publishing many times before the waiter gets to run costs one wake-up, not one each. */
+    template <typename U>
+    inline void waitSingle(const std::atomic<U>& atom, const U old)
+    {
+        m_waiters.count.store(1u,std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        atom.wait(old,std::memory_order_acquire);
+    }
+    template <typename U>
+    inline void notifySingle(std::atomic<U>& atom)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.count.load(std::memory_order_relaxed)==0u || m_waiters.count.exchange(0u,std::memory_order_relaxed)==0u)
+            return;
+        atom.notify_one();
+    }
+    //! To be called after storing to `atom`, skips the (potential) syscall when nobody is blocked in `wait`
+    template <typename U>
+    inline void notify(std::atomic<U>& atom, const bool all)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.count.load(std::memory_order_relaxed)==0u)
+            return;
+        if (all)
+            atom.notify_all();
+        else
+            atom.notify_one();
+    }
+
+private:
+    struct alignas(CacheLineSize) SWaiters
+    {
+        std::atomic_uint32_t count = 0u;
+    } m_waiters;
+};
+
+}
+
+//! Bounded lock-free ring for exactly one producer thread and exactly one consumer thread.
+/** Capacity must be a power of two. Each side keeps a cached copy of the other side's index,
+so the shared cache lines only get touched when the ring looks full (or empty).
+The blocking `push`/`pop` use C++20 atomic waits, the `try_` variants never block. */
+template <typename T>
+class CSPSCRingBuffer : public impl::CConcurrentRingBufferCommonBase
+{
+public:
+    using type = T;
+
+    explicit CSPSCRingBuffer(size_t cap) : m_mask(cap-1ull)
+    {
+        assert(core::isPoT(cap));
+        m_mem = reinterpret_cast<T*>(_NBL_ALIGNED_MALLOC(sizeof(T)*cap,std::max(alignof(T),CacheLineSize)));
+    }
+    CSPSCRingBuffer(const CSPSCRingBuffer&) = delete;
+    CSPSCRingBuffer& operator=(const CSPSCRingBuffer&) = delete;
+    ~CSPSCRingBuffer()
+    {
+        const counter_t end = m_tail.value.load(std::memory_order_relaxed);
+        for (counter_t i=m_head.value.load(std::memory_order_relaxed); i!=end; i++)
+            m_mem[i&m_mask].~T();
+        _NBL_ALIGNED_FREE(m_mem);
+    }
+
+    inline size_t capacity() const {return m_mask+1ull;}
+    //! Only exact when called from the producer or consumer thread while the other side is idle
+    inline size_t size() const
+    {
+        const counter_t tail = m_tail.value.load(std::memory_order_acquire);
+        return tail-m_head.value.load(std::memory_order_acquire);
+    }
+
+    //! Producer side, returns false if the ring is full
+    template <typename... Args>
+    inline bool try_emplace(Args&&... args)
+    {
+        const counter_t tail = m_tail.value.load(std::memory_order_relaxed);
+        if (tail-m_producer.cachedHead>m_mask)
+        {
+            m_producer.cachedHead = m_head.value.load(std::memory_order_acquire);
+            if (tail-m_producer.cachedHead>m_mask)
+                return false;
+        }
+        new (m_mem+(tail&m_mask)) T(std::forward<Args>(args)...);
+        publishTail(tail+1u);
+        return true;
+    }
+    inline bool try_push(const T& val) {return try_emplace(val);}
+    inline bool try_push(T&& val) {return try_emplace(std::move(val));}
+
+    //! Producer side, waits for the consumer to make space if the ring is full
+    template <typename... Args>
+    inline void emplace(Args&&... args)
+    {
+        const counter_t tail = m_tail.value.load(std::memory_order_relaxed);
+        while (tail-m_producer.cachedHead>m_mask)
+        {
+            m_producer.cachedHead = m_head.value.load(std::memory_order_acquire);
+            if (tail-m_producer.cachedHead>m_mask)
+                waitSingle(m_head.value,m_producer.cachedHead);
+        }
+        new (m_mem+(tail&m_mask)) T(std::forward<Args>(args)...);
+        publishTail(tail+1u);
+    }
+    inline void push(const T& val) {emplace(val);}
+    inline void push(T&& val) {emplace(std::move(val));}
+
+    //! Consumer side, returns false if the ring is empty
+    inline bool try_pop(T& out)
+    {
+        const counter_t head = m_head.value.load(std::memory_order_relaxed);
+        if (head==m_consumer.cachedTail)
+        {
+            m_consumer.cachedTail = m_tail.value.load(std::memory_order_acquire);
+            if (head==m_consumer.cachedTail)
+                return false;
+        }
+        consume(head,out);
+        return true;
+    }
+
+    //! Consumer side, waits for the producer if the ring is empty
+    inline T pop()
+    {
+        const counter_t head = m_head.value.load(std::memory_order_relaxed);
+        while (head==m_consumer.cachedTail)
+        {
+            m_consumer.cachedTail = m_tail.value.load(std::memory_order_acquire);
+            if (head==m_consumer.cachedTail)
+                waitSingle(m_tail.value,m_consumer.cachedTail);
+        }
+        T retval = std::move(m_mem[head&m_mask]);
+        m_mem[head&m_mask].~T();
+        publishHead(head+1u);
+        return retval;
+    }
+
+private:
+    inline void consume(const counter_t head, T& out)
+    {
+        T* storage = m_mem+(head&m_mask);
+        out = std::move(*storage);
+        storage->~T();
+        publishHead(head+1u);
+    }
+    inline void publishTail(const counter_t tail)
+    {
+        m_tail.value.store(tail,std::memory_order_release);
+        notifySingle(m_tail.value);
+    }
+    inline void publishHead(const counter_t head)
+    {
+        m_head.value.store(head,std::memory_order_release);
+        notifySingle(m_head.value);
+    }
+
+    // written by the consumer
+    SPaddedCounter m_head;
+    // written by the producer
+    SPaddedCounter m_tail;
+    struct alignas(CacheLineSize) SProducerState
+    {
+        counter_t cachedHead = 0u;
+    } m_producer;
+    struct alignas(CacheLineSize) SConsumerState
+    {
+        counter_t cachedTail = 0u;
+    } m_consumer;
+
+    T* m_mem;
+    const counter_t m_mask;
+};
+
+//! Bounded lock-free ring for any number of producers and consumers (Dmitry Vyukov's design).
+/** Capacity must be a power of two. Every cell carries a sequence number telling whether it is ready to be
+written or read for a given lap around the ring, so producers and consumers only contend on their own index.
+The blocking `push`/`pop` wait on the sequence number of the cell they're stuck on, the `try_` variants never block.
+The ring is not linearizable as a whole (a `try_pop` can fail while another producer is mid-way through a push). */
+template <typename T>
+class CMPMCRingBuffer : public impl::CConcurrentRingBufferCommonBase
+{
+    struct SCell
+    {
+        atomic_counter_t sequence;
+        alignas(T) uint8_t storage[sizeof(T)];
+
+        inline T* get() {return std::launder(reinterpret_cast<T*>(storage));}
+    };
+
+public:
+    using type = T;
+
+    explicit CMPMCRingBuffer(size_t cap) : m_mask(cap-1ull)
+    {
+        assert(core::isPoT(cap));
+        m_cells = reinterpret_cast<SCell*>(_NBL_ALIGNED_MALLOC(sizeof(SCell)*cap,std::max(alignof(SCell),CacheLineSize)));
+        for (size_t i=0ull; i<cap; i++)
+            new (&m_cells[i].sequence) atomic_counter_t(i);
+    }
+    CMPMCRingBuffer(const CMPMCRingBuffer&) = delete;
+    CMPMCRingBuffer& operator=(const CMPMCRingBuffer&) = delete;
+    ~CMPMCRingBuffer()
+    {
+        const counter_t end = m_enqueuePos.value.load(std::memory_order_relaxed);
+        for (counter_t i=m_dequeuePos.value.load(std::memory_order_relaxed); i!=end; i++)
+            m_cells[i&m_mask].get()->~T();
+        for (size_t i=0ull; i<capacity(); i++)
+            m_cells[i].sequence.~atomic_counter_t();
+        _NBL_ALIGNED_FREE(m_cells);
+    }
+
+    inline size_t capacity() const {return m_mask+1ull;}
+    //! Approximate while other threads are pushing or popping
+    inline size_t size() const
+    {
+        const counter_t dequeuePos = m_dequeuePos.value.load(std::memory_order_relaxed);
+        const counter_t enqueuePos = m_enqueuePos.value.load(std::memory_order_relaxed);
+        return enqueuePos>dequeuePos ? (enqueuePos-dequeuePos):0ull;
+    }
+
+    template <typename... Args>
+    inline bool try_emplace(Args&&... args)
+    {
+        SCell* cell;
+        counter_t pos;
+        if (!claim<false>(m_enqueuePos,0u,cell,pos))
+            return false;
+        new (cell->storage) T(std::forward<Args>(args)...);
+        publish(cell,pos+1u);
+        return true;
+    }
+    inline bool try_push(const T& val) {return try_emplace(val);}
+    inline bool try_push(T&& val) {return try_emplace(std::move(val));}
+
+    template <typename... Args>
+    inline void emplace(Args&&... args)
+    {
+        SCell* cell;
+        counter_t pos;
+        claim<true>(m_enqueuePos,0u,cell,pos);
+        new (cell->storage) T(std::forward<Args>(args)...);
+        publish(cell,pos+1u);
+    }
+    inline void push(const T& val) {emplace(val);}
+    inline void push(T&& val) {emplace(std::move(val));}
+
+    inline bool try_pop(T& out)
+    {
+        SCell* cell;
+        counter_t pos;
+        if (!claim<false>(m_dequeuePos,1u,cell,pos))
+            return false;
+        T* storage = cell->get();
+        out = std::move(*storage);
+        storage->~T();
+        publish(cell,pos+capacity());
+        return true;
+    }
+
+    inline T pop()
+    {
+        SCell* cell;
+        counter_t pos;
+        claim<true>(m_dequeuePos,1u,cell,pos);
+        T* storage = cell->get();
+        T retval = std::move(*storage);
+        storage->~T();
+        publish(cell,pos+capacity());
+        return retval;
+    }
+
+private:
+    //! A cell is ready for the claimant at `pos` when its sequence number equals `pos+readyOffset`
+    template <bool Blocking>
+    inline bool claim(SPaddedCounter& position, const counter_t readyOffset, SCell*& cell, counter_t& pos)
+    {
+        pos = position.value.load(std::memory_order_relaxed);
+        while (true)
+        {
+            cell = m_cells+(pos&m_mask);
+            const counter_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto dif = static_cast<int64_t>(sequence-(pos+readyOffset));
+            if (dif==0)
+            {
+                if (position.value.compare_exchange_weak(pos,pos+1u,std::memory_order_relaxed))
+                    return true;
+            }
+            else if (dif<0)
+            {
+                // cell still holds the previous lap's element (when pushing) or hasn't been written yet (when popping)
+                if constexpr (!Blocking)
+                    return false;
+                wait(cell->sequence,sequence);
+                pos = position.value.load(std::memory_order_relaxed);
+            }
+            else // someone else claimed `pos` already
+                pos = position.value.load(std::memory_order_relaxed);
+        }
+    }
+    inline void publish(SCell* cell, const counter_t sequence)
+    {
+        cell->sequence.store(sequence,std::memory_order_release);
+        // different laps of producers or consumers can be waiting on the same cell
+        notify(cell->sequence,true);
+    }
+
+    SPaddedCounter m_enqueuePos;
+    SPaddedCounter m_dequeuePos;
+    alignas(CacheLineSize) SCell* m_cells;
+    const counter_t m_mask;
+};
+
+}
+
+#endif
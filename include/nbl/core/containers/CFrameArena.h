@@ -0,0 +1,248 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef __NBL_CORE_C_FRAME_ARENA_H_INCLUDED__
+#define __NBL_CORE_C_FRAME_ARENA_H_INCLUDED__
+
+#include "nbl/core/decl/Types.h"
+#include "nbl/core/decl/BaseClasses.h"
+#include "nbl/core/memory/memory.h"
+#include "nbl/core/alloc/LinearAddressAllocator.h"
+
+#include <memory_resource>
+
+namespace nbl::core
+{
+
+//! Bump allocator for short-lived scratch memory, meant to be used from a single thread (see `getThreadLocal()`).
+/** Memory comes in blocks, each bump-allocated with a `LinearAddressAllocator`, individual frees are no-ops.
+Memory is reclaimed either in bulk via `reset()` or by rewinding to a `SMarker` taken earlier (`SScope` does it for you).
+Blocks are never returned to the system until `trim()` or destruction, so a warmed-up arena allocates nothing.
+Big one-off scratch should use `SScratch`, so that the thread doesn't keep a block that size for the rest of its life. */
+class CFrameArena final : public Uncopyable
+{
+    public:
+        using size_type = uint32_t;
+        using addr_allocator_type = LinearAddressAllocator<size_type>;
+        _NBL_STATIC_INLINE_CONSTEXPR size_type default_block_size = 0x1u<<20u;
+        _NBL_STATIC_INLINE_CONSTEXPR size_type max_alignment = 0x1u<<12u;
+
+        struct SMarker
+        {
+            uint32_t blockIx;
+            size_type cursor;
+        };
+        //! RAII helper, everything allocated from the arena during its lifetime gets released when it goes out of scope
+        /** With `_trim` the blocks it leaves unused get returned to the system too, for scopes which allocate a lot once. */
+        class SScope final : public Uncopyable
+        {
+            public:
+                SScope(CFrameArena& _arena, const bool _trim=false) : arena(_arena), marker(_arena.getMarker()), trim(_trim) {}
+                ~SScope()
+                {
+                    arena.rewind(marker);
+                    if (trim)
+                        arena.trim();
+                }
+
+            private:
+                CFrameArena& arena;
+                const SMarker marker;
+                const bool trim;
+        };
+        //! Scratch which comes from the arena when it can, and from the heap when it's over what a block can hold or the arena is out of memory
+        /** The arena gets rewound and trimmed when it goes out of scope, so it's meant for big allocations done once per call. */
+        class SScratch final : public Uncopyable
+        {
+            public:
+                SScratch(CFrameArena& _arena, const size_t _bytes, const size_t _alignment=_NBL_SIMD_ALIGNMENT) : scope(_arena,true)
+                {
+                    data = _arena.allocate(_bytes,_alignment);
+                    if (!data)
+                    {
+                        data = _NBL_ALIGNED_MALLOC(_bytes,_alignment);
+                        onHeap = true;
+                    }
+                }
+                ~SScratch()
+                {
+                    if (onHeap)
+                        _NBL_ALIGNED_FREE(data);
+                }
+
+                //! Can only be nullptr if the heap allocation failed too
+                inline void* get() const {return data;}
+
+            private:
+                SScope scope;
+                void* data;
+                bool onHeap = false;
+        };
+
+        CFrameArena(const size_type _blockSize=default_block_size) : blockSize(_blockSize), currentBlock(0u) {}
+
+        //! The arena used by the calling thread, created on first use
+        NBL_API2 static CFrameArena& getThreadLocal();
+
+        //! Returns nullptr if `alignment` is over `max_alignment` or `bytes` can't fit in a block
+        /** Can throw `std::bad_alloc` when the list of blocks fails to grow. */
+        inline void* allocate(size_t bytes, size_t alignment=_NBL_SIMD_ALIGNMENT)
+        {
+            if (alignment>max_alignment || bytes>~size_type(0u)-max_alignment)
+                return nullptr;
+            bytes = std::max<size_t>(bytes,1ull);
+
+            // move onto the blocks retained from before a `rewind` or `reset` before making new ones
+            for (; currentBlock<blocks.size(); switchToBlock(currentBlock+1u,0u))
+            {
+                auto& block = blocks[currentBlock];
+                const size_type addr = block.addrAlloc.alloc_addr(bytes,alignment);
+                if (addr!=addr_allocator_type::invalid_address)
+                    return block.data+addr;
+                if (currentBlock+1u>=blocks.size())
+                    break;
+            }
+
+            // out of space in all existing blocks, make a new one big enough for the request
+            auto& block = blocks.emplace_back(std::max<size_type>(blockSize,core::roundUp<size_type>(bytes,max_alignment)));
+            if (!block.data)
+            {
+                blocks.pop_back();
+                return nullptr;
+            }
+            switchToBlock(blocks.size()-1u,0u);
+            return block.data+block.addrAlloc.alloc_addr(bytes,alignment);
+        }
+        //! No-op, memory only gets reclaimed by `rewind` and `reset`
+        inline void deallocate(void* ptr, size_t bytes) noexcept {}
+
+        template<typename T>
+        inline T* allocate_n(size_t n)
+        {
+            return reinterpret_cast<T*>(allocate(sizeof(T)*n,alignof(T)));
+        }
+
+        inline SMarker getMarker() const
+        {
+            if (blocks.empty())
+                return {0u,0u};
+            return {currentBlock,blocks[currentBlock].addrAlloc.get_allocated_size()};
+        }
+        //! Invalidates everything allocated after the marker was taken
+        inline void rewind(const SMarker& marker)
+        {
+            if (marker.blockIx<blocks.size())
+                switchToBlock(marker.blockIx,marker.cursor);
+            // `trim` released the block the marker is in, everything left is from before it
+            else if (!blocks.empty())
+                currentBlock = blocks.size()-1u;
+        }
+        //! Invalidates every allocation made so far, but keeps the blocks around
+        inline void reset()
+        {
+            rewind({0u,0u});
+        }
+        //! Releases all blocks the arena is not currently using
+        inline void trim()
+        {
+            while (blocks.size()>currentBlock+1u)
+                blocks.pop_back();
+            // the current one too if nothing is allocated from it, else a rewound arena would keep its biggest block
+            if (!blocks.empty() && blocks[currentBlock].addrAlloc.get_allocated_size()==0u)
+            {
+                blocks.pop_back();
+                currentBlock = blocks.empty() ? 0u:(blocks.size()-1u);
+            }
+        }
+        //! Whether `ptr` points into one of the blocks
+        inline bool owns(const void* ptr) const
+        {
+            for (const auto& block : blocks)
+            if (ptr>=block.data && ptr<block.data+block.size)
+                return true;
+            return false;
+        }
+
+        inline size_type getBlockSize() const {return blockSize;}
+        inline size_t getBlockCount() const {return blocks.size();}
+        //! Total bytes in use, including padding lost to alignment and the unused tails of skipped blocks
+        inline size_t getAllocatedSize() const
+        {
+            if (blocks.empty())
+                return 0ull;
+            size_t retval = blocks[currentBlock].addrAlloc.get_allocated_size();
+            for (auto i=0u; i<currentBlock; i++)
+                retval += blocks[i].size;
+            return retval;
+        }
+
+    private:
+        // every block keeps its own address allocator for its whole lifetime, so switching blocks only moves a cursor
+        struct SBlock final : public Uncopyable
+        {
+            SBlock(const size_type _size) : data(aligned_allocator<uint8_t,max_alignment>().allocate(_size,max_alignment)), size(_size),
+                addrAlloc(nullptr,0u,0u,max_alignment,_size)
+            {
+                addrAlloc.setTelemetryLabel("CFrameArena");
+            }
+            ~SBlock()
+            {
+                if (data)
+                    aligned_allocator<uint8_t,max_alignment>().deallocate(data,size);
+            }
+
+            uint8_t* const data;
+            const size_type size;
+            addr_allocator_type addrAlloc;
+        };
+
+        inline void switchToBlock(uint32_t blockIx, size_type cursor)
+        {
+            currentBlock = blockIx;
+            if (currentBlock<blocks.size())
+                blocks[currentBlock].addrAlloc.reset(cursor);
+        }
+
+        const size_type blockSize;
+        uint32_t currentBlock;
+        // a deque never moves its elements, address allocators can't be moved without their reserved space
+        core::deque<SBlock> blocks;
+};
+
+//! `std::pmr` adaptor so that `std::pmr` containers can put their temporaries in a `CFrameArena`
+/** What the arena can't provide comes from `std::pmr::new_delete_resource()` instead. */
+class CFrameArenaMemoryResource final : public std::pmr::memory_resource
+{
+    public:
+        CFrameArenaMemoryResource(CFrameArena& _arena=CFrameArena::getThreadLocal()) : arena(_arena) {}
+
+        inline CFrameArena& getArena() {return arena;}
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            if (void* retval=arena.allocate(bytes,alignment))
+                return retval;
+            // throws `std::bad_alloc` itself
+            return std::pmr::new_delete_resource()->allocate(bytes,alignment);
+        }
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+        {
+            if (arena.owns(ptr))
+                arena.deallocate(ptr,bytes);
+            else
+                std::pmr::new_delete_resource()->deallocate(ptr,bytes,alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this==&other;
+        }
+
+    private:
+        CFrameArena& arena;
+};
+
+}
+
+#endif
@@ -0,0 +1,192 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_CORE_SMALL_DYNAMIC_ARRAY_H_INCLUDED_
+#define _NBL_CORE_SMALL_DYNAMIC_ARRAY_H_INCLUDED_
+
+#include "nbl/macros.h"
+#include "nbl/core/decl/Types.h" //for core::allocator
+
+#include <initializer_list>
+#include <iterator>
+
+namespace nbl::core
+{
+
+//! Array with its length fixed at construction like core::dynamic_array, which keeps up to `InlineCapacity` elements in place
+/**
+	Most arrays of this kind hold 1 to a handful of elements (asset bundle contents, descriptor bindings, meshbuffer lists),
+	so these don't touch the heap at all, longer ones do a single allocation with the allocator.
+
+	Unlike core::dynamic_array this is a regular value type, it can live on the stack or as a member and it can be copied and moved,
+	the read API (iterators, `size`, `data`, `operator[]`, comparisons) is the same. Note that moving an inline array moves the elements one by one.
+
+	@see core::dynamic_array
+*/
+template<typename T, size_t InlineCapacity, class allocator=core::allocator<T> >
+class small_dynamic_array
+{
+		static_assert(InlineCapacity>0ull, "Use core::dynamic_array or core::vector for arrays without inline storage");
+
+	public:
+		using allocator_type = allocator;
+		using value_type = T;
+		using pointer = typename std::allocator_traits<allocator_type>::pointer;
+		using const_pointer = typename std::allocator_traits<allocator_type>::const_pointer;
+		using iterator = T*;
+		using const_iterator = const T*;
+
+		_NBL_STATIC_INLINE_CONSTEXPR size_t inline_capacity = InlineCapacity;
+
+		inline small_dynamic_array(const allocator& _alctr = allocator()) : alctr(_alctr), item_count(0ull), m_data(inlineStorage()) {}
+		explicit inline small_dynamic_array(size_t _length, const allocator& _alctr = allocator()) : alctr(_alctr), item_count(_length), m_data(acquireStorage())
+		{
+			for (size_t i=0ull; i<item_count; ++i)
+				std::allocator_traits<allocator>::construct(alctr,m_data+i);
+		}
+		inline small_dynamic_array(size_t _length, const T& _val, const allocator& _alctr = allocator()) : alctr(_alctr), item_count(_length), m_data(acquireStorage())
+		{
+			for (size_t i=0ull; i<item_count; ++i)
+				std::allocator_traits<allocator>::construct(alctr,m_data+i,_val);
+		}
+		inline small_dynamic_array(std::initializer_list<T> _contents, const allocator& _alctr = allocator()) : alctr(_alctr), item_count(_contents.size()), m_data(acquireStorage())
+		{
+			constructFrom(_contents.begin());
+		}
+		//! Copies or moves (if passed as an rvalue) the elements out of any container with `begin()` and `size()`
+		template<typename container_t> requires (!std::is_same_v<std::remove_cvref_t<container_t>,small_dynamic_array> && requires(container_t& c) {std::begin(c); std::size(c);})
+		explicit inline small_dynamic_array(container_t&& _container, const allocator& _alctr = allocator()) : alctr(_alctr), item_count(std::size(_container)), m_data(acquireStorage())
+		{
+			if constexpr (std::is_rvalue_reference_v<container_t&&>)
+				constructFrom(std::make_move_iterator(std::begin(_container)));
+			else
+				constructFrom(std::begin(_container));
+		}
+
+		inline small_dynamic_array(const small_dynamic_array& other) : alctr(other.alctr), item_count(other.item_count), m_data(acquireStorage())
+		{
+			constructFrom(other.begin());
+		}
+		inline small_dynamic_array(small_dynamic_array&& other) noexcept : alctr(other.alctr), item_count(other.item_count), m_data(inlineStorage())
+		{
+			if (other.is_inline())
+				constructFrom(std::make_move_iterator(other.begin()));
+			else
+			{
+				// steal the heap storage
+				m_data = other.m_data;
+				other.m_data = other.inlineStorage();
+				other.item_count = 0ull;
+			}
+		}
+
+		inline ~small_dynamic_array()
+		{
+			release();
+		}
+
+		inline small_dynamic_array& operator=(const small_dynamic_array& other)
+		{
+			if (this!=&other)
+			{
+				release();
+				item_count = other.item_count;
+				m_data = acquireStorage();
+				constructFrom(other.begin());
+			}
+			return *this;
+		}
+		inline small_dynamic_array& operator=(small_dynamic_array&& other) noexcept
+		{
+			if (this!=&other)
+			{
+				release();
+				item_count = other.item_count;
+				if (other.is_inline())
+					constructFrom(std::make_move_iterator(other.begin()));
+				else
+				{
+					m_data = other.m_data;
+					other.m_data = other.inlineStorage();
+					other.item_count = 0ull;
+				}
+			}
+			return *this;
+		}
+
+		//! Whether the elements are stored in place, always the case for arrays no longer than `inline_capacity`
+		inline bool is_inline() const noexcept { return m_data==inlineStorage(); }
+
+		inline bool operator!=(const small_dynamic_array& _other) const
+		{
+			if (size() != _other.size())
+				return true;
+			for (size_t i = 0u; i < size(); ++i)
+				if ((*this)[i] != _other[i])
+					return true;
+			return false;
+		}
+		inline bool operator==(const small_dynamic_array& _other) const
+		{
+			return !((*this) != _other);
+		}
+
+		inline iterator			begin() noexcept { return data(); }
+		inline const_iterator	begin() const noexcept { return data(); }
+		inline iterator			end() noexcept { return data()+size(); }
+		inline const_iterator	end() const noexcept { return data()+size(); }
+		inline const_iterator	cend() const noexcept { return data()+size(); }
+		inline const_iterator	cbegin() const noexcept { return data(); }
+
+		inline size_t			size() const noexcept { return item_count; }
+		inline bool				empty() const noexcept { return !size(); }
+
+		inline size_t			bytesize() const noexcept { return item_count*sizeof(T); }
+
+		inline const T&			operator[](size_t ix) const noexcept { return data()[ix]; }
+		inline T&				operator[](size_t ix) noexcept { return data()[ix]; }
+
+		inline T&				front() noexcept { return *begin(); }
+		inline const T&			front() const noexcept { return *begin(); }
+		inline T&				back() noexcept { return *(end()-1); }
+		inline const T&			back() const noexcept { return *(end()-1); }
+		inline pointer			data() noexcept { return m_data; }
+		inline const_pointer	data() const noexcept { return m_data; }
+
+	private:
+		inline T* inlineStorage() noexcept { return reinterpret_cast<T*>(inline_storage); }
+		inline const T* inlineStorage() const noexcept { return reinterpret_cast<const T*>(inline_storage); }
+
+		// `item_count` needs to be set already
+		inline T* acquireStorage()
+		{
+			if (item_count<=InlineCapacity)
+				return inlineStorage();
+			return std::allocator_traits<allocator>::allocate(alctr,item_count);
+		}
+		template<typename iterator_t>
+		inline void constructFrom(iterator_t it)
+		{
+			for (size_t i=0ull; i<item_count; ++i,++it)
+				std::allocator_traits<allocator>::construct(alctr,m_data+i,*it);
+		}
+		// leaves the array empty and inline
+		inline void release()
+		{
+			for (size_t i=0ull; i<item_count; ++i)
+				std::allocator_traits<allocator>::destroy(alctr,m_data+i);
+			if (!is_inline())
+				std::allocator_traits<allocator>::deallocate(alctr,m_data,item_count);
+			item_count = 0ull;
+			m_data = inlineStorage();
+		}
+
+		allocator alctr;
+		size_t item_count;
+		T* m_data;
+		alignas(T) uint8_t inline_storage[sizeof(T)*InlineCapacity];
+};
+
+}
+
+#endif
@@ -0,0 +1,542 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef __NBL_CORE_STABLE_FLAT_HASH_MAP_H_INCLUDED__
+#define __NBL_CORE_STABLE_FLAT_HASH_MAP_H_INCLUDED__
+
+#include "nbl/core/decl/Types.h"
+#include "nbl/core/math/intutil.h"
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace nbl::core
+{
+
+//! Hasher which lets `std::string` keyed containers be searched with anything convertible to a `std::string_view` without allocating
+template<typename K>
+struct transparent_hash : std::hash<K> {};
+template<typename C, typename T, typename A>
+struct transparent_hash<std::basic_string<C,T,A>>
+{
+    using is_transparent = void;
+
+    inline size_t operator()(const std::basic_string_view<C,T> str) const {return std::hash<std::basic_string_view<C,T>>()(str);}
+};
+
+namespace impl
+{
+
+//! Open addressing hash index over a pool of nodes which never move, so references and handles stay valid until the element is erased.
+/** The nodes are also threaded on a doubly linked list in which elements with equal keys are adjacent (same as `std::unordered_multimap`),
+so `equal_range` can return an iterator pair. The index only holds one slot per distinct key, pointing at the first node of the key's group.
+Erased nodes go on a free list and get reused, memory is only returned on `clear()` or destruction. */
+template<typename K, typename T, class Hash, class KeyEqual, class Allocator, bool Multi>
+class stable_flat_hash_map_base
+{
+    public:
+        using key_type = K;
+        using mapped_type = T;
+        using value_type = std::pair<const K,T>;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using allocator_type = Allocator;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        //! Stays valid (and refers to the same element) until that element is erased
+        using handle_t = uint32_t;
+        _NBL_STATIC_INLINE_CONSTEXPR handle_t invalid_handle = ~0u;
+
+    private:
+        struct SNode
+        {
+            inline value_type* get() {return std::launder(reinterpret_cast<value_type*>(storage));}
+            inline const value_type* get() const {return std::launder(reinterpret_cast<const value_type*>(storage));}
+
+            alignas(value_type) uint8_t storage[sizeof(value_type)];
+            size_t hash;
+            handle_t prev;
+            handle_t next;
+        };
+        struct SSlot
+        {
+            handle_t node;
+            // top bits of the hash, so most mismatches can be rejected without touching the node
+            uint32_t tag;
+        };
+        _NBL_STATIC_INLINE_CONSTEXPR handle_t empty_slot = invalid_handle;
+        _NBL_STATIC_INLINE_CONSTEXPR handle_t tombstone_slot = invalid_handle-1u;
+        _NBL_STATIC_INLINE_CONSTEXPR uint32_t chunk_size_log2 = 8u;
+        _NBL_STATIC_INLINE_CONSTEXPR uint32_t chunk_size = 0x1u<<chunk_size_log2;
+
+        using node_allocator_t = typename std::allocator_traits<Allocator>::template rebind_alloc<SNode>;
+        using slot_allocator_t = typename std::allocator_traits<Allocator>::template rebind_alloc<SSlot>;
+        using chunk_allocator_t = typename std::allocator_traits<Allocator>::template rebind_alloc<SNode*>;
+
+        template<bool Const>
+        class iterator_impl
+        {
+                using owner_t = std::conditional_t<Const,const stable_flat_hash_map_base,stable_flat_hash_map_base>;
+                friend class stable_flat_hash_map_base;
+
+            public:
+                using iterator_category = std::bidirectional_iterator_tag;
+                using value_type = typename stable_flat_hash_map_base::value_type;
+                using difference_type = ptrdiff_t;
+                using pointer = std::conditional_t<Const,const value_type*,value_type*>;
+                using reference = std::conditional_t<Const,const value_type&,value_type&>;
+
+                iterator_impl() = default;
+                iterator_impl(owner_t* _owner, handle_t _node) : owner(_owner), node(_node) {}
+                // non-const to const conversion
+                template<bool OtherConst> requires (Const && !OtherConst)
+                iterator_impl(const iterator_impl<OtherConst>& other) : owner(other.owner), node(other.node) {}
+
+                inline reference operator*() const {return *owner->getNode(node).get();}
+                inline pointer operator->() const {return owner->getNode(node).get();}
+
+                inline iterator_impl& operator++()
+                {
+                    node = owner->getNode(node).next;
+                    return *this;
+                }
+                inline iterator_impl operator++(int)
+                {
+                    auto retval = *this;
+                    operator++();
+                    return retval;
+                }
+                inline iterator_impl& operator--()
+                {
+                    node = node!=invalid_handle ? owner->getNode(node).prev:owner->listTail;
+                    return *this;
+                }
+                inline iterator_impl operator--(int)
+                {
+                    auto retval = *this;
+                    operator--();
+                    return retval;
+                }
+
+                template<bool OtherConst>
+                inline bool operator==(const iterator_impl<OtherConst>& other) const {return node==other.node;}
+
+                inline handle_t getHandle() const {return node;}
+
+            private:
+                template<bool> friend class iterator_impl;
+
+                owner_t* owner = nullptr;
+                handle_t node = invalid_handle;
+        };
+
+    public:
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        stable_flat_hash_map_base(const Hash& _hash=Hash(), const KeyEqual& _equal=KeyEqual(), const Allocator& _alloc=Allocator())
+            : hashFunc(_hash), equalFunc(_equal), alloc(_alloc), slots(slot_allocator_t(_alloc)), chunks(chunk_allocator_t(_alloc)) {}
+        stable_flat_hash_map_base(const stable_flat_hash_map_base& other) : stable_flat_hash_map_base(other.hashFunc,other.equalFunc,other.alloc)
+        {
+            reserve(other.size());
+            for (const auto& item : other)
+                emplace(item.first,item.second);
+        }
+        stable_flat_hash_map_base(stable_flat_hash_map_base&& other) : stable_flat_hash_map_base(other.hashFunc,other.equalFunc,other.alloc)
+        {
+            swap(other);
+        }
+        ~stable_flat_hash_map_base()
+        {
+            clear();
+        }
+
+        inline stable_flat_hash_map_base& operator=(const stable_flat_hash_map_base& other)
+        {
+            if (this!=&other)
+            {
+                stable_flat_hash_map_base tmp(other);
+                swap(tmp);
+            }
+            return *this;
+        }
+        inline stable_flat_hash_map_base& operator=(stable_flat_hash_map_base&& other)
+        {
+            swap(other);
+            return *this;
+        }
+
+        inline void swap(stable_flat_hash_map_base& other)
+        {
+            std::swap(hashFunc,other.hashFunc);
+            std::swap(equalFunc,other.equalFunc);
+            std::swap(alloc,other.alloc);
+            slots.swap(other.slots);
+            chunks.swap(other.chunks);
+            std::swap(nodeCount,other.nodeCount);
+            std::swap(elementCount,other.elementCount);
+            std::swap(usedSlots,other.usedSlots);
+            std::swap(freeList,other.freeList);
+            std::swap(listHead,other.listHead);
+            std::swap(listTail,other.listTail);
+        }
+
+        inline iterator begin() {return iterator(this,listHead);}
+        inline const_iterator begin() const {return const_iterator(this,listHead);}
+        inline const_iterator cbegin() const {return begin();}
+        inline iterator end() {return iterator(this,invalid_handle);}
+        inline const_iterator end() const {return const_iterator(this,invalid_handle);}
+        inline const_iterator cend() const {return end();}
+        inline reverse_iterator rbegin() {return reverse_iterator(end());}
+        inline const_reverse_iterator rbegin() const {return const_reverse_iterator(end());}
+        inline const_reverse_iterator crbegin() const {return rbegin();}
+        inline reverse_iterator rend() {return reverse_iterator(begin());}
+        inline const_reverse_iterator rend() const {return const_reverse_iterator(begin());}
+        inline const_reverse_iterator crend() const {return rend();}
+
+        inline size_type size() const {return elementCount;}
+        inline bool empty() const {return elementCount==0ull;}
+
+        inline const hasher& hash_function() const {return hashFunc;}
+        inline const key_equal& key_eq() const {return equalFunc;}
+
+        //! Turns a handle back into an iterator, the handle must refer to a live element
+        inline iterator fromHandle(const handle_t handle) {return iterator(this,handle);}
+        inline const_iterator fromHandle(const handle_t handle) const {return const_iterator(this,handle);}
+
+        inline void clear()
+        {
+            for (auto node=listHead; node!=invalid_handle;)
+            {
+                auto& n = getNode(node);
+                node = n.next;
+                n.get()->~value_type();
+            }
+            node_allocator_t nodeAlloc(alloc);
+            for (auto chunk : chunks)
+                nodeAlloc.deallocate(chunk,chunk_size);
+            chunks.clear();
+            slots.clear();
+            nodeCount = 0u;
+            elementCount = 0ull;
+            usedSlots = 0ull;
+            freeList = invalid_handle;
+            listHead = invalid_handle;
+            listTail = invalid_handle;
+        }
+
+        //! Makes room in the index for `count` distinct keys
+        inline void reserve(const size_type count)
+        {
+            const size_type needed = core::roundUpToPoT<size_type>(std::max<size_type>((count*8ull+6ull)/7ull,8ull));
+            if (needed>slots.size())
+                rehash(needed);
+        }
+
+        template<typename LookupKey>
+        inline iterator find(const LookupKey& key)
+        {
+            return iterator(this,findGroup(key,hashFunc(key)));
+        }
+        template<typename LookupKey>
+        inline const_iterator find(const LookupKey& key) const
+        {
+            return const_iterator(this,findGroup(key,hashFunc(key)));
+        }
+        template<typename LookupKey>
+        inline bool contains(const LookupKey& key) const
+        {
+            return findGroup(key,hashFunc(key))!=invalid_handle;
+        }
+        template<typename LookupKey>
+        inline size_type count(const LookupKey& key) const
+        {
+            auto range = equal_range(key);
+            return std::distance(range.first,range.second);
+        }
+        template<typename LookupKey>
+        inline std::pair<iterator,iterator> equal_range(const LookupKey& key)
+        {
+            const auto range = const_cast<const stable_flat_hash_map_base*>(this)->equal_range(key);
+            return {iterator(this,range.first.node),iterator(this,range.second.node)};
+        }
+        template<typename LookupKey>
+        inline std::pair<const_iterator,const_iterator> equal_range(const LookupKey& key) const
+        {
+            const handle_t first = findGroup(key,hashFunc(key));
+            if (first==invalid_handle)
+                return {end(),end()};
+            return {const_iterator(this,first),const_iterator(this,getNode(groupLast(first)).next)};
+        }
+
+        //! Returns an iterator for multimaps, and an (iterator,inserted) pair for maps
+        inline auto insert(const value_type& value) {return emplace(value.first,value.second);}
+        inline auto insert(value_type&& value) {return emplace(std::move(const_cast<K&>(value.first)),std::move(value.second));}
+        //! The hint is ignored, it's only there for interface compatibility with the other containers
+        inline iterator insert(const_iterator hint, const value_type& value)
+        {
+            if constexpr (Multi)
+                return insert(value);
+            else
+                return insert(value).first;
+        }
+
+        template<typename KeyArg, typename... Args>
+        inline auto emplace(KeyArg&& key, Args&&... args)
+        {
+            const size_t hash = hashFunc(key);
+            const handle_t group = findGroup(key,hash);
+            if constexpr (!Multi)
+            {
+                if (group!=invalid_handle)
+                    return std::pair<iterator,bool>(iterator(this,group),false);
+            }
+
+            const handle_t node = allocateNode();
+            auto& n = getNode(node);
+            // nothing references the node yet, so only it needs giving back if the constructor throws
+            try
+            {
+                new (n.storage) value_type(std::piecewise_construct,std::forward_as_tuple(std::forward<KeyArg>(key)),std::forward_as_tuple(std::forward<Args>(args)...));
+            }
+            catch (...)
+            {
+                freeNode(node);
+                throw;
+            }
+            n.hash = hash;
+            elementCount++;
+            // keep equal keys adjacent, new elements go at the end of their group like in `std::multimap`
+            if (group!=invalid_handle)
+                linkAfter(node,groupLast(group));
+            else
+            {
+                linkAfter(node,listTail);
+                insertSlot(node,hash);
+            }
+
+            if constexpr (Multi)
+                return iterator(this,node);
+            else
+                return std::pair<iterator,bool>(iterator(this,node),true);
+        }
+
+        inline iterator erase(const_iterator it)
+        {
+            const handle_t node = it.node;
+            auto& n = getNode(node);
+            const handle_t next = n.next;
+            // if this was the head of its group, the index has to point at the next one of the group or forget the key
+            if (n.prev==invalid_handle || !sameKey(getNode(n.prev),n))
+            {
+                const size_t slot = findSlotOf(node,n.hash);
+                if (next!=invalid_handle && sameKey(getNode(next),n))
+                    slots[slot].node = next;
+                else
+                {
+                    slots[slot].node = tombstone_slot;
+                    // don't bother tracking tombstones separately, `usedSlots` counts them until the next rehash
+                }
+            }
+            unlink(node);
+            n.get()->~value_type();
+            freeNode(node);
+            elementCount--;
+            return iterator(this,next);
+        }
+        template<typename LookupKey> requires (!std::is_convertible_v<const LookupKey&,const_iterator>)
+        inline size_type erase(const LookupKey& key)
+        {
+            size_type retval = 0ull;
+            for (auto range=equal_range(key); range.first!=range.second; retval++)
+                range.first = erase(range.first);
+            return retval;
+        }
+
+    private:
+        inline SNode& getNode(const handle_t node) {return chunks[node>>chunk_size_log2][node&(chunk_size-1u)];}
+        inline const SNode& getNode(const handle_t node) const {return chunks[node>>chunk_size_log2][node&(chunk_size-1u)];}
+
+        static inline uint32_t getTag(const size_t hash) {return static_cast<uint32_t>(static_cast<uint64_t>(hash)>>32ull)|0x1u;}
+        // hashers like `std::hash<T*>` are the identity, so mix before using the low bits as the slot
+        static inline size_t getHome(const size_t hash) {return static_cast<size_t>((static_cast<uint64_t>(hash)^(static_cast<uint64_t>(hash)>>29ull))*0xbf58476d1ce4e5b9ull>>17ull);}
+
+        inline bool sameKey(const SNode& a, const SNode& b) const
+        {
+            return a.hash==b.hash && equalFunc(a.get()->first,b.get()->first);
+        }
+
+        template<typename LookupKey>
+        inline handle_t findGroup(const LookupKey& key, const size_t hash) const
+        {
+            if (slots.empty())
+                return invalid_handle;
+            const size_t mask = slots.size()-1ull;
+            const uint32_t tag = getTag(hash);
+            for (size_t i=getHome(hash)&mask; true; i=(i+1ull)&mask)
+            {
+                const auto& slot = slots[i];
+                if (slot.node==empty_slot)
+                    return invalid_handle;
+                if (slot.node!=tombstone_slot && slot.tag==tag)
+                {
+                    const auto& n = getNode(slot.node);
+                    if (n.hash==hash && equalFunc(n.get()->first,key))
+                        return slot.node;
+                }
+            }
+        }
+        inline size_t findSlotOf(const handle_t node, const size_t hash) const
+        {
+            const size_t mask = slots.size()-1ull;
+            for (size_t i=getHome(hash)&mask; true; i=(i+1ull)&mask)
+            if (slots[i].node==node)
+                return i;
+        }
+        inline handle_t groupLast(handle_t node) const
+        {
+            for (handle_t next; (next=getNode(node).next)!=invalid_handle && sameKey(getNode(next),getNode(node));)
+                node = next;
+            return node;
+        }
+
+        inline void insertSlot(const handle_t node, const size_t hash)
+        {
+            // keep the load factor including tombstones under 7/8
+            if ((usedSlots+1ull)*8ull>slots.size()*7ull)
+            {
+                const size_type distinctKeys = slots.size() ? countDistinctKeys():0ull;
+                rehash(core::roundUpToPoT<size_type>(std::max<size_type>((distinctKeys+1ull)*2ull,8ull)));
+                // the new node is already linked, so the rehash put it in the index
+                return;
+            }
+            const size_t mask = slots.size()-1ull;
+            size_t i = getHome(hash)&mask;
+            while (slots[i].node!=empty_slot && slots[i].node!=tombstone_slot)
+                i = (i+1ull)&mask;
+            if (slots[i].node==empty_slot)
+                usedSlots++;
+            slots[i] = {node,getTag(hash)};
+        }
+        inline size_type countDistinctKeys() const
+        {
+            size_type retval = 0ull;
+            for (const auto& slot : slots)
+            if (slot.node!=empty_slot && slot.node!=tombstone_slot)
+                retval++;
+            return retval;
+        }
+        inline void rehash(const size_type slotCount)
+        {
+            slots.assign(slotCount,SSlot{empty_slot,0u});
+            usedSlots = 0ull;
+            const size_t mask = slotCount-1ull;
+            for (handle_t node=listHead; node!=invalid_handle; node=getNode(node).next)
+            {
+                const auto& n = getNode(node);
+                if (n.prev!=invalid_handle && sameKey(getNode(n.prev),n))
+                    continue;
+                size_t i = getHome(n.hash)&mask;
+                while (slots[i].node!=empty_slot)
+                    i = (i+1ull)&mask;
+                slots[i] = {node,getTag(n.hash)};
+                usedSlots++;
+            }
+        }
+
+        inline handle_t allocateNode()
+        {
+            if (freeList!=invalid_handle)
+            {
+                const handle_t node = freeList;
+                freeList = getNode(node).next;
+                return node;
+            }
+            if ((nodeCount&(chunk_size-1u))==0u)
+                chunks.push_back(node_allocator_t(alloc).allocate(chunk_size));
+            return nodeCount++;
+        }
+        inline void freeNode(const handle_t node)
+        {
+            getNode(node).next = freeList;
+            freeList = node;
+        }
+        inline void linkAfter(const handle_t node, const handle_t after)
+        {
+            auto& n = getNode(node);
+            n.prev = after;
+            if (after!=invalid_handle)
+            {
+                auto& a = getNode(after);
+                n.next = a.next;
+                a.next = node;
+            }
+            else
+            {
+                n.next = listHead;
+                listHead = node;
+            }
+            if (n.next!=invalid_handle)
+                getNode(n.next).prev = node;
+            else
+                listTail = node;
+        }
+        inline void unlink(const handle_t node)
+        {
+            auto& n = getNode(node);
+            if (n.prev!=invalid_handle)
+                getNode(n.prev).next = n.next;
+            else
+                listHead = n.next;
+            if (n.next!=invalid_handle)
+                getNode(n.next).prev = n.prev;
+            else
+                listTail = n.prev;
+        }
+
+        Hash hashFunc;
+        KeyEqual equalFunc;
+        allocator_type alloc;
+        core::vector<SSlot,slot_allocator_t> slots;
+        core::vector<SNode*,chunk_allocator_t> chunks;
+        handle_t nodeCount = 0u;
+        size_type elementCount = 0ull;
+        // live and tombstoned slots
+        size_type usedSlots = 0ull;
+        handle_t freeList = invalid_handle;
+        handle_t listHead = invalid_handle;
+        handle_t listTail = invalid_handle;
+};
+
+}
+
+//! Hash map with stable references and handles to its elements, see `impl::stable_flat_hash_map_base`
+template<typename K, typename T, class Hash=transparent_hash<K>, class KeyEqual=std::equal_to<>, class Allocator=allocator<std::pair<const K,T>>>
+class stable_flat_hash_map : public impl::stable_flat_hash_map_base<K,T,Hash,KeyEqual,Allocator,false>
+{
+        using base_t = impl::stable_flat_hash_map_base<K,T,Hash,KeyEqual,Allocator,false>;
+
+    public:
+        using base_t::base_t;
+};
+
+//! Hash multimap with stable references and handles to its elements, elements with equal keys are adjacent when iterating
+template<typename K, typename T, class Hash=transparent_hash<K>, class KeyEqual=std::equal_to<>, class Allocator=allocator<std::pair<const K,T>>>
+class stable_flat_hash_multimap : public impl::stable_flat_hash_map_base<K,T,Hash,KeyEqual,Allocator,true>
+{
+        using base_t = impl::stable_flat_hash_map_base<K,T,Hash,KeyEqual,Allocator,true>;
+
+    public:
+        using base_t::base_t;
+};
+
+}
+
+#endif
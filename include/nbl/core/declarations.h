@@ -17,6 +17,7 @@
 
 // TODO: split the rest into declarations and definitions
 #include "CConcurrentObjectCache.h"
+#include "CShardedObjectCache.h"
 // allocator
 #include "nbl/core/alloc/AddressAllocatorBase.h"
 #include "nbl/core/alloc/AddressAllocatorConcurrencyAdaptors.h"
@@ -25,6 +26,7 @@
 #include "nbl/core/alloc/aligned_allocator.h"
 #include "nbl/core/alloc/aligned_allocator_adaptor.h"
 #include "nbl/core/alloc/AllocatorTrivialBases.h"
+#include "nbl/core/alloc/BuddyAddressAllocator.h"
 #include "nbl/core/alloc/GeneralpurposeAddressAllocator.h"
 #include "nbl/core/alloc/IAddressAllocator.h"
 #include "nbl/core/alloc/IAllocator.h"
@@ -40,8 +42,12 @@
 // containers
 #include "nbl/core/containers/dynamic_array.h"
 #include "nbl/core/containers/refctd_dynamic_array.h"
+#include "nbl/core/containers/small_dynamic_array.h"
 #include "nbl/core/containers/FixedCapacityDoublyLinkedList.h"
 #include "nbl/core/containers/LRUCache.h"
+#include "nbl/core/containers/CFrameArena.h"
+#include "nbl/core/containers/stable_flat_hash_map.h"
+#include "nbl/core/containers/CConcurrentRingBuffer.h"
 // math
 #include "nbl/core/math/intutil.h"
 #include "nbl/core/math/colorutil.h"
@@ -52,12 +58,14 @@
 #include "nbl/core/memory/memory.h"
 #include "nbl/core/memory/new_delete.h"
 // samplers
+#include "nbl/core/sampling/XoroshiroSampler.h"
 #include "nbl/core/sampling/RandomSampler.h"
 #include "nbl/core/sampling/SobolSampler.h"
 #include "nbl/core/sampling/OwenSampler.h"
 // parallel
 #include "nbl/core/parallel/IThreadBound.h"
 #include "nbl/core/parallel/unlock_guard.h"
+#include "nbl/core/parallel/CThreadPool.h"
 // string
 #include "nbl/core/string/stringutil.h"
 #include "nbl/core/string/StringLiteral.h"
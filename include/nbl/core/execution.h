@@ -17,6 +17,8 @@
 #include "oneapi/dpl/pstl/glue_algorithm_ranges_defs.h"
 #endif
 
+#include "nbl/core/parallel/CThreadPool.h"
+
 #define ALIAS_TEMPLATE_FUNCTION(highLevelF, lowLevelF) \
 template<typename... Args> \
 inline auto highLevelF(Args&&... args) -> decltype(lowLevelF(std::forward<Args>(args)...)) \
@@ -27,7 +29,10 @@ inline auto highLevelF(Args&&... args) -> decltype(lowLevelF(std::forward<Args>(
 namespace nbl::core
 {
 #if __has_include(<execution>)
-namespace execution = std::execution;
+namespace execution
+{
+using namespace std::execution;
+}
 
 ALIAS_TEMPLATE_FUNCTION(for_each_n, std::for_each_n)
 ALIAS_TEMPLATE_FUNCTION(for_each, std::for_each)
@@ -42,7 +47,10 @@ ALIAS_TEMPLATE_FUNCTION(nth_element, std::nth_element)
 //template <class _ExPo, class _FwdIt1, class _FwdIt2>
 //const auto swap_ranges = std::swap_ranges<_ExPo, _FwdIt1, _FwdIt2>;
 #else
-namespace execution = oneapi::dpl::execution;
+namespace execution
+{
+using namespace oneapi::dpl::execution;
+}
 
 ALIAS_TEMPLATE_FUNCTION(for_each_n, oneapi::dpl::for_each_n)
 ALIAS_TEMPLATE_FUNCTION(for_each, oneapi::dpl::for_each)
@@ -57,6 +65,52 @@ ALIAS_TEMPLATE_FUNCTION(nth_element, oneapi::dpl::nth_element)
 //template <class _ExPo, class _FwdIt1, class _FwdIt2>
 //const auto swap_ranges = oneapi::dpl::swap_ranges<_ExPo, _FwdIt1, _FwdIt2>;
 #endif
+
+namespace execution
+{
+//! Runs `core::for_each` and `core::for_each_n` on a `CThreadPool` instead of the standard library's backend.
+/** Uses `CThreadPool::getDefault()` unless given a pool, a zero grain size picks one which gives every thread a few ranges to balance the load. */
+class pool_policy
+{
+	public:
+		constexpr pool_policy() = default;
+		constexpr explicit pool_policy(CThreadPool* _pool, const size_t _grainSize=0ull) : pool(_pool), grainSize(_grainSize) {}
+
+		inline pool_policy on(CThreadPool& _pool) const {return pool_policy(&_pool,grainSize);}
+		inline pool_policy with_grain_size(const size_t _grainSize) const {return pool_policy(pool,_grainSize);}
+
+		inline CThreadPool& getPool() const {return pool ? *pool:CThreadPool::getDefault();}
+		inline size_t getGrainSize(const size_t count) const
+		{
+			if (grainSize)
+				return grainSize;
+			constexpr size_t RangesPerThread = 8ull;
+			return std::max<size_t>(count/((getPool().getWorkerCount()+1ull)*RangesPerThread),1ull);
+		}
+
+	private:
+		CThreadPool* pool = nullptr;
+		size_t grainSize = 0ull;
+};
+inline constexpr pool_policy par_pool = {};
+}
+
+// the aliases above don't take a `pool_policy` because the standard algorithms SFINAE on `is_execution_policy`
+template<class RandomAccessIt, class F>
+inline void for_each_n(const execution::pool_policy& policy, RandomAccessIt first, const size_t count, F f)
+{
+	policy.getPool().parallel_for(count,policy.getGrainSize(count),[&first,&f](const size_t begin, const size_t end) -> void
+	{
+		auto it = first+typename std::iterator_traits<RandomAccessIt>::difference_type(begin);
+		for (size_t i=begin; i<end; i++,++it)
+			f(*it);
+	});
+}
+template<class RandomAccessIt, class F>
+inline void for_each(const execution::pool_policy& policy, RandomAccessIt first, RandomAccessIt last, F f)
+{
+	for_each_n(policy,first,static_cast<size_t>(last-first),f);
+}
 }
 
 #undef ALIAS_TEMPLATE_FUNCTION
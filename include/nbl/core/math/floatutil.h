@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <cmath>
 #include <algorithm>
+#include <cstring>
 
 #include "BuildConfigOptions.h"
 #include "nbl/macros.h"
@@ -432,6 +433,13 @@ class Float16Compressor
 		}
 };
 
+//! Batch IEEE754 float32 -> float16 conversion, rounds to nearest even (unlike `Float16Compressor::compress` which truncates)
+/** Uses F16C or AVX-512 when the CPU has them, the scalar fallback gives bit-identical results including NaN payloads.
+With `_saturate` finite values out of float16 range become +/-65504 instead of infinity, NaNs stay NaN. */
+NBL_API2 void float32_to_float16(uint16_t* _out, const float* _in, size_t _count, bool _saturate=false);
+//! Batch IEEE754 float16 -> float32 conversion, exact, signalling NaNs get quietened same as F16C does
+NBL_API2 void float16_to_float32(float* _out, const uint16_t* _in, size_t _count);
+
 struct rgb32f {
 	float x, y, z;
 };
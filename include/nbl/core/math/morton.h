@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include "nbl/macros.h"
+#include "nbl/core/util/cpu_features.h"
 
 namespace nbl
 {
@@ -35,7 +36,7 @@ namespace impl
         {
             0x1249249249249249ull,
             0x10C30C30C30C30C3ull,
-            0x010F00F00F00F00Full,
+            0x100F00F00F00F00Full,
             0x001F0000FF0000FFull,
             0x001F00000000FFFFull
         };
@@ -70,7 +71,28 @@ namespace impl
         }
         if constexpr (bitDepth>32u)
         {
-            x = (x | (x >> 16));
+            x = (x | (x >> 16)) & static_cast<T>(0xFFFFFFFFull);
+        }
+        return x;
+    }
+    //! Inverse of `separate_bits_3d`
+    template <typename T, uint32_t bitDepth>
+    inline T morton3d_decode(T x)
+    {
+        x = x & morton3d_mask<T>(0);
+        x = (x | (x >> 2)) & morton3d_mask<T>(1);
+        x = (x | (x >> 4)) & morton3d_mask<T>(2);
+        if constexpr (bitDepth>8u)
+        {
+            x = (x | (x >> 8)) & morton3d_mask<T>(3);
+        }
+        if constexpr (bitDepth>16u)
+        {
+            x = (x | (x >> 16)) & morton3d_mask<T>(4);
+        }
+        if constexpr (bitDepth>32u)
+        {
+            x = (x | (x >> 32)) & static_cast<T>(0x1FFFFFull);
         }
         return x;
     }
@@ -149,6 +171,95 @@ T morton3d_encode(T x, T y, T z) { return impl::separate_bits_3d<T,bitDepth>(x)
 template<typename T, uint32_t bitDepth=sizeof(T)*8u>
 T morton4d_encode(T x, T y, T z, T w) { return impl::separate_bits_4d<T,bitDepth>(x) | (impl::separate_bits_4d<T,bitDepth>(y)<<1) | (impl::separate_bits_4d<T,bitDepth>(z)<<2) | (impl::separate_bits_4d<T,bitDepth>(w)<<3); }
 
+template<typename T, uint32_t bitDepth=sizeof(T)*8u>
+T morton3d_decode_x(T _morton) { return impl::morton3d_decode<T,bitDepth>(_morton); }
+template<typename T, uint32_t bitDepth=sizeof(T)*8u>
+T morton3d_decode_y(T _morton) { return impl::morton3d_decode<T,bitDepth>(_morton>>1); }
+template<typename T, uint32_t bitDepth=sizeof(T)*8u>
+T morton3d_decode_z(T _morton) { return impl::morton3d_decode<T,bitDepth>(_morton>>2); }
+
+namespace impl
+{
+    //! Which bits of a Morton code belong to the first axis, the other axes' masks are this shifted left by the axis index
+    template <typename T, uint32_t Dims>
+    constexpr T morton_axis_mask()
+    {
+        if constexpr (Dims==2u)
+            return static_cast<T>(0x5555555555555555ull);
+        else if constexpr (sizeof(T)==4u) // 10 bits per axis
+            return static_cast<T>(0x09249249ull);
+        else // 21 bits per axis
+            return static_cast<T>(0x1249249249249249ull);
+    }
+
+    template <typename T>
+    NBL_TARGET_ISA("bmi2") inline T pdep(T x, T mask)
+    {
+        if constexpr (sizeof(T)==4u)
+            return _pdep_u32(x,mask);
+        else
+            return _pdep_u64(x,mask);
+    }
+    template <typename T>
+    NBL_TARGET_ISA("bmi2") inline T pext(T x, T mask)
+    {
+        if constexpr (sizeof(T)==4u)
+            return _pext_u32(x,mask);
+        else
+            return _pext_u64(x,mask);
+    }
+}
+
+//! BMI2 versions of the full bit depth encoders and decoders, one `pdep` or `pext` per axis.
+/** Only call these after checking `getCPUFeatures().bmi2` (`fastPdepPext` tells whether they're actually faster than the functions above).
+Axes need to fit into `sizeof(T)*8/Dims` bits (10 bits for 3D in 32 bits), otherwise the results differ from the bit-twiddling versions. */
+template<typename T>
+NBL_TARGET_ISA("bmi2") inline T morton2d_encode_bmi2(T x, T y)
+{
+    constexpr T mask = impl::morton_axis_mask<T,2u>();
+    return impl::pdep<T>(x,mask)|impl::pdep<T>(y,mask<<1);
+}
+template<typename T>
+NBL_TARGET_ISA("bmi2") inline T morton3d_encode_bmi2(T x, T y, T z)
+{
+    constexpr T mask = impl::morton_axis_mask<T,3u>();
+    return impl::pdep<T>(x,mask)|impl::pdep<T>(y,mask<<1)|impl::pdep<T>(z,mask<<2);
+}
+template<typename T>
+NBL_TARGET_ISA("bmi2") inline T morton2d_decode_x_bmi2(T _morton) { return impl::pext<T>(_morton,impl::morton_axis_mask<T,2u>()); }
+template<typename T>
+NBL_TARGET_ISA("bmi2") inline T morton2d_decode_y_bmi2(T _morton) { return impl::pext<T>(_morton,impl::morton_axis_mask<T,2u>()<<1); }
+template<typename T>
+NBL_TARGET_ISA("bmi2") inline T morton3d_decode_x_bmi2(T _morton) { return impl::pext<T>(_morton,impl::morton_axis_mask<T,3u>()); }
+template<typename T>
+NBL_TARGET_ISA("bmi2") inline T morton3d_decode_y_bmi2(T _morton) { return impl::pext<T>(_morton,impl::morton_axis_mask<T,3u>()<<1); }
+template<typename T>
+NBL_TARGET_ISA("bmi2") inline T morton3d_decode_z_bmi2(T _morton) { return impl::pext<T>(_morton,impl::morton_axis_mask<T,3u>()<<2); }
+
+//! Encode `_count` quantized positions given as one array per axis, with AVX-512, AVX2, BMI2 or SSE4.1 (whichever is fastest on the CPU, picked at runtime).
+/** Same bit budget as the BMI2 functions: 16 bits per axis for 2D and 10 bits for 3D when encoding to 32 bits, 32 and 21 bits when encoding to 64 bits. */
+NBL_API2 void morton2d_encode(uint32_t* _out, const uint32_t* _x, const uint32_t* _y, size_t _count);
+NBL_API2 void morton2d_encode(uint64_t* _out, const uint32_t* _x, const uint32_t* _y, size_t _count);
+NBL_API2 void morton3d_encode(uint32_t* _out, const uint32_t* _x, const uint32_t* _y, const uint32_t* _z, size_t _count);
+NBL_API2 void morton3d_encode(uint64_t* _out, const uint32_t* _x, const uint32_t* _y, const uint32_t* _z, size_t _count);
+
+namespace impl
+{
+    enum E_MORTON_ENCODE_ISA : uint8_t
+    {
+        EMEI_SSE = 0,
+        EMEI_BMI2,
+        EMEI_AVX2,
+        EMEI_AVX512
+    };
+    //! The batch encoders with the instruction set fixed instead of picked at runtime, for benchmarking them against each other
+    /** The caller has to check `getCPUFeatures()` supports `_isa`. */
+    NBL_API2 void morton2d_encode(E_MORTON_ENCODE_ISA _isa, uint32_t* _out, const uint32_t* _x, const uint32_t* _y, size_t _count);
+    NBL_API2 void morton2d_encode(E_MORTON_ENCODE_ISA _isa, uint64_t* _out, const uint32_t* _x, const uint32_t* _y, size_t _count);
+    NBL_API2 void morton3d_encode(E_MORTON_ENCODE_ISA _isa, uint32_t* _out, const uint32_t* _x, const uint32_t* _y, const uint32_t* _z, size_t _count);
+    NBL_API2 void morton3d_encode(E_MORTON_ENCODE_ISA _isa, uint64_t* _out, const uint32_t* _x, const uint32_t* _y, const uint32_t* _z, size_t _count);
+}
+
 }}
 
 #endif
\ No newline at end of file
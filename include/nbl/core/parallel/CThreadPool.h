@@ -0,0 +1,110 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef _NBL_CORE_C_THREAD_POOL_H_INCLUDED_
+#define _NBL_CORE_C_THREAD_POOL_H_INCLUDED_
+
+#include "nbl/core/decl/Types.h"
+#include "nbl/core/decl/BaseClasses.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace nbl::core
+{
+
+//! Work-stealing pool for data-parallel loops, backs `core::execution::pool_policy`.
+/** Every worker has its own queue, it pushes and pops its own work at the back and steals from the front of the others' queues.
+Ranges get split in halves until they're at most the grain size, so the big halves are what gets stolen.
+
+The thread calling `parallel_for` works on the range too and keeps executing (any) tasks until its range is done,
+so nesting `parallel_for` inside a task can't deadlock and doesn't spawn extra threads, even with zero workers. */
+class CThreadPool final : public Uncopyable
+{
+    public:
+        //! Zero workers is valid, then all the work is done by the threads calling `parallel_for`
+        NBL_API2 explicit CThreadPool(uint32_t workerCount=getDefaultWorkerCount());
+        NBL_API2 ~CThreadPool();
+
+        inline uint32_t getWorkerCount() const {return m_workerCount;}
+
+        //! One less than the hardware threads, because the caller of `parallel_for` works too
+        static inline uint32_t getDefaultWorkerCount()
+        {
+            const uint32_t hwThreads = std::thread::hardware_concurrency();
+            return hwThreads>1u ? (hwThreads-1u):0u;
+        }
+
+        //! The pool `core::execution::par_pool` runs on, created on first use
+        NBL_API2 static CThreadPool& getDefault();
+        //! Only has an effect before the first `getDefault()`, returns whether it did
+        NBL_API2 static bool setDefaultPoolWorkerCount(uint32_t workerCount);
+
+        //! Calls `f(begin,end)` over disjoint subranges of `[0,count)` of at most `grainSize` elements, returns when all are done.
+        /** `f` must not throw, like with the standard parallel algorithms. */
+        template<typename F>
+        inline void parallel_for(const size_t count, const size_t grainSize, F&& f)
+        {
+            if (count==0ull)
+                return;
+            // nothing to split
+            if (count<=grainSize || m_workerCount==0u)
+            {
+                f(size_t(0ull),count);
+                return;
+            }
+
+            SJob job(count,grainSize ? grainSize:1ull);
+            job.context = &f;
+            job.execute = [](const void* context, size_t begin, size_t end) -> void
+            {
+                (*reinterpret_cast<std::remove_reference_t<F>*>(const_cast<void*>(context)))(begin,end);
+            };
+            run(job);
+        }
+
+    private:
+        struct SJob
+        {
+            SJob(const size_t count, const size_t _grainSize) : grainSize(_grainSize), pending(count) {}
+
+            void(*execute)(const void*,size_t,size_t) = nullptr;
+            const void* context = nullptr;
+            const size_t grainSize;
+            // elements not done yet
+            std::atomic<size_t> pending;
+        };
+        struct STask
+        {
+            SJob* job;
+            size_t begin;
+            size_t end;
+        };
+        struct SQueue;
+
+        NBL_API2 void run(SJob& job);
+
+        uint32_t getOwnQueueIndex() const;
+        void push(const uint32_t queueIx, const STask& task);
+        bool tryGetTask(const uint32_t ownQueueIx, STask& task);
+        void executeTask(const uint32_t ownQueueIx, STask task);
+        void workerLoop(const uint32_t workerIx);
+
+        const uint32_t m_workerCount;
+        // one per worker plus one shared by threads from outside the pool
+        SQueue* m_queues;
+        std::thread* m_workers;
+
+        std::mutex m_sleepMutex;
+        std::condition_variable m_sleepCondition;
+        std::atomic_uint32_t m_sleeping = 0u;
+        uint64_t m_wakeEpoch = 0ull;
+        bool m_stop = false;
+};
+
+}
+
+#endif
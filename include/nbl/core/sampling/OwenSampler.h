@@ -13,14 +13,14 @@ namespace nbl
 namespace core
 {
 
-	//! TODO: make the tree sampler/generator configurable and let RandomSampler be default
-	template<class SequenceSampler=SobolSampler>
+	//! TODO: make the tree sampler configurable and let RandomSampler be default
+	//! `TreeRNG` generates the flips, needs to be constructible from a `uint32_t` seed, like the standard engines or `XoroshiroSampler`
+	template<class SequenceSampler=SobolSampler, class TreeRNG=std::mt19937>
 	class OwenSampler : protected SequenceSampler
 	{
 	public:
-		OwenSampler(uint32_t _dimensions, uint32_t _seed) : SequenceSampler(_dimensions)
+		OwenSampler(uint32_t _dimensions, uint32_t _seed) : SequenceSampler(_dimensions), flipGenerator(_seed)
 		{
-			mersenneTwister.seed(_seed);
 			cachedFlip.resize(MAX_SAMPLES-1u);
 			resetDimensionCounter(0u);
 		}
@@ -63,7 +63,7 @@ namespace core
 			for (uint32_t i=0u; i<MAX_SAMPLES-1u; i++) 
 			{
 				uint32_t randMask = (i<(MAX_SAMPLES/2u-1u)) ? 0x80000000u:0xffffffffu;
-				cachedFlip[i] = mersenneTwister()&(randMask>>getTreeDepth(i));
+				cachedFlip[i] = flipGenerator()&(randMask>>getTreeDepth(i));
 			}
 			for (uint32_t i=1u; i<MAX_SAMPLES_LOG2; i++)
 			{
@@ -97,11 +97,78 @@ namespace core
 			return hlsl::findMSB(sampleNum+1u);
 		}
 
-		std::mt19937 mersenneTwister;
+		TreeRNG flipGenerator;
 		uint32_t lastDim;
 		core::vector<uint32_t> cachedFlip;
 	};
 
+	//! Owen scrambling without the flip tree, the nested uniform scramble of every sample is computed from a hash of (seed, dimension, sample).
+	/** Uses the Laine-Karras style permutation from Burley's "Practical Hash-based Owen Scrambling" (JCGT 2020) on the bit-reversed sample,
+	a hash which only lets lower bits affect the higher ones is exactly an Owen scramble of the reversed digits.
+
+	Unlike `OwenSampler` this needs no memory beyond the `SequenceSampler`, can sample the dimensions in any order,
+	and `sample()` is `const` and safe to call from many threads at once. The scramble differs from `OwenSampler`'s for the same seed. */
+	template<class SequenceSampler=SobolSampler>
+	class HashedOwenSampler : protected SequenceSampler
+	{
+	public:
+		HashedOwenSampler(uint32_t _dimensions, uint32_t _seed) : SequenceSampler(_dimensions), seed(hash(_seed))
+		{
+		}
+
+		//
+		inline uint32_t sample(uint32_t dim, uint32_t sampleNum) const
+		{
+			return scramble(SequenceSampler::sample(dim,sampleNum),getDimensionSeed(dim));
+		}
+
+		//! Seeds of neighbouring dimensions need to be decorrelated, so they're hashed and not just incremented
+		inline uint32_t getDimensionSeed(uint32_t dim) const
+		{
+			return hash(seed^hash(dim));
+		}
+
+		//! Nested uniform scramble of the binary digits after the radix point, the most significant bit is the first digit
+		static inline uint32_t scramble(uint32_t sample, uint32_t dimSeed)
+		{
+			return reverseBits(laineKarrasPermutation(reverseBits(sample),dimSeed));
+		}
+
+	protected:
+		// all the mixing steps only propagate bits upwards (multiplications by even constants and additions)
+		static inline uint32_t laineKarrasPermutation(uint32_t x, uint32_t dimSeed)
+		{
+			x ^= x*0x3d20adeau;
+			x += dimSeed;
+			x *= (dimSeed>>16u)|1u;
+			x ^= x*0x05526c56u;
+			x ^= x*0x53a22864u;
+			return x;
+		}
+
+		// lowbias32 by Chris Wellons
+		static inline uint32_t hash(uint32_t x)
+		{
+			x ^= x>>16u;
+			x *= 0x7feb352du;
+			x ^= x>>15u;
+			x *= 0x846ca68bu;
+			x ^= x>>16u;
+			return x;
+		}
+
+		static inline uint32_t reverseBits(uint32_t x)
+		{
+			x = ((x>>1u)&0x55555555u)|((x&0x55555555u)<<1u);
+			x = ((x>>2u)&0x33333333u)|((x&0x33333333u)<<2u);
+			x = ((x>>4u)&0x0F0F0F0Fu)|((x&0x0F0F0F0Fu)<<4u);
+			x = ((x>>8u)&0x00FF00FFu)|((x&0x00FF00FFu)<<8u);
+			return (x>>16u)|(x<<16u);
+		}
+
+		const uint32_t seed;
+	};
+
 
 }
 }
@@ -7,28 +7,34 @@
 
 #include <random>
 #include "nbl/core/decl/Types.h"
+#include "nbl/core/sampling/XoroshiroSampler.h"
 
 namespace nbl::core
 {
 
-class RandomSampler
+//! `RNG` needs to be constructible from a `uint32_t` seed, like the standard engines or `XoroshiroSampler`
+template<class RNG>
+class GenericRandomSampler
 {
 	public:
-		RandomSampler(uint32_t _seed)
+		GenericRandomSampler(uint32_t _seed) : rng(_seed)
 		{
-			mersenneTwister.seed(_seed);
 		}
 
 		// 
 		inline uint32_t nextSample()
 		{
-			return mersenneTwister();
+			return rng();
 		}
 
 	protected:
-		std::mt19937 mersenneTwister;
+		RNG rng;
 };
 
+using RandomSampler = GenericRandomSampler<std::mt19937>;
+//! Much smaller and faster to seed, with jump-ahead for per-thread streams
+using XoroshiroRandomSampler = GenericRandomSampler<XoroshiroSampler<>>;
+
 
 }
 
@@ -6,6 +6,10 @@
 #define __NBL_CORE_SOBOL_SAMPLER_H_
 
 #include "nbl/core/decl/Types.h"
+#include "nbl/core/execution.h"
+
+#include <numeric>
+#include <thread>
 
 namespace nbl::core
 {
@@ -77,12 +81,12 @@ class SobolSampler
 		}
 		
 		// Idea for optimization, do PoT samples per pass, then can precompute most of the `retval`
-		inline uint32_t sample(uint32_t dim, uint32_t sampleNum)
+		inline uint32_t sample(uint32_t dim, uint32_t sampleNum) const
 		{
 			#ifdef _DEBUG
 				assert(dim<dimensions);
 			#endif
-			auto vectors = *reinterpret_cast<uint32_t(*)[][SOBOL_BITS]>(directions);
+			const auto& vectors = *reinterpret_cast<const uint32_t(*)[][SOBOL_BITS]>(directions);
 
 			uint32_t retval = (sampleNum & 0x1u) ? vectors[dim][0] : 0u;
 			for (uint32_t i=1u; i<SOBOL_BITS; i++)
@@ -91,6 +95,104 @@ class SobolSampler
 			return retval;
 		}
 
+		//! Fills `out[i*dimCount+d]` with `sample(firstDim+d,firstSample+i)` for `sampleCount` samples and `dimCount` dimensions.
+		/** Samples are generated incrementally like with the Gray code construction, except that the XOR for going from sample `n-1` to `n`
+		is precomputed for every possible count of trailing zeroes of `n`, so samples come out in the natural order, same as `sample()`.
+		The row XOR is contiguous over the dimensions so it vectorizes, and the sample range is split into chunks for the `policy`,
+		each chunk starts off one `sample()` per dimension. */
+		template<class ExecutionPolicy>
+		inline void generateBlock(ExecutionPolicy&& policy, uint32_t* out, uint32_t firstSample, uint32_t sampleCount, uint32_t firstDim, uint32_t dimCount) const
+		{
+			if (sampleCount==0u || dimCount==0u)
+				return;
+			assert(firstDim+dimCount<=dimensions);
+			assert(uint64_t(firstSample)+sampleCount<=(0x1ull<<SOBOL_BITS));
+
+			const auto& vectors = *reinterpret_cast<const uint32_t(*)[][SOBOL_BITS]>(directions);
+			// `prefixXor[k]` flips every bit `n-1` and `n` differ by, when `n` has `k` trailing zeroes
+			core::vector<uint32_t> prefixXor(SOBOL_BITS*dimCount);
+			for (uint32_t d=0u; d<dimCount; d++)
+			{
+				uint32_t accumulated = 0u;
+				for (uint32_t k=0u; k<SOBOL_BITS; k++)
+					prefixXor[k*dimCount+d] = accumulated ^= vectors[firstDim+d][k];
+			}
+
+			constexpr uint32_t MinChunkSize = 1024u;
+			const uint32_t chunkCount = std::is_same_v<std::remove_cvref_t<ExecutionPolicy>,core::execution::sequenced_policy> ? 1u:
+				std::max(std::min((sampleCount+MinChunkSize-1u)/MinChunkSize,std::thread::hardware_concurrency()*4u),1u);
+			const uint32_t chunkSize = (sampleCount+chunkCount-1u)/chunkCount;
+			core::vector<uint32_t> chunks(chunkCount);
+			std::iota(chunks.begin(),chunks.end(),0u);
+			core::for_each(policy,chunks.begin(),chunks.end(),[&](const uint32_t chunk) -> void
+			{
+				const uint32_t begin = chunk*chunkSize;
+				const uint32_t end = std::min(begin+chunkSize,sampleCount);
+				if (begin>=end)
+					return;
+
+				uint32_t* row = out+size_t(begin)*dimCount;
+				for (uint32_t d=0u; d<dimCount; d++)
+					row[d] = sample(firstDim+d,firstSample+begin);
+				for (uint32_t i=begin+1u; i<end; i++)
+				{
+					const uint32_t* flip = prefixXor.data()+hlsl::findLSB(firstSample+i)*dimCount;
+					uint32_t* const nextRow = row+dimCount;
+					for (uint32_t d=0u; d<dimCount; d++)
+						nextRow[d] = row[d]^flip[d];
+					row = nextRow;
+				}
+			});
+		}
+
+		//! Header of a serialized table of samples made by `generateBlock`, directly followed by `sampleCount*dimCount` samples
+		struct STableHeader
+		{
+			_NBL_STATIC_INLINE_CONSTEXPR uint32_t Magic = 0x4c425353u; // "SSBL" in little endian
+			_NBL_STATIC_INLINE_CONSTEXPR uint32_t Version = 1u;
+
+			uint32_t magic = Magic;
+			uint32_t version = Version;
+			uint32_t firstSample = 0u;
+			uint32_t sampleCount = 0u;
+			uint32_t firstDim = 0u;
+			uint32_t dimCount = 0u;
+		};
+
+		static inline size_t getSerializedTableSize(uint32_t sampleCount, uint32_t dimCount)
+		{
+			return sizeof(STableHeader)+size_t(sampleCount)*dimCount*sizeof(uint32_t);
+		}
+
+		//! `dst` needs to have `getSerializedTableSize(sampleCount,dimCount)` bytes, returns the pointer to the samples in `dst`
+		template<class ExecutionPolicy>
+		inline uint32_t* serializeTable(ExecutionPolicy&& policy, void* dst, uint32_t firstSample, uint32_t sampleCount, uint32_t firstDim, uint32_t dimCount) const
+		{
+			STableHeader header;
+			header.firstSample = firstSample;
+			header.sampleCount = sampleCount;
+			header.firstDim = firstDim;
+			header.dimCount = dimCount;
+			memcpy(dst,&header,sizeof(header));
+
+			uint32_t* samples = reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(dst)+sizeof(STableHeader));
+			generateBlock(std::forward<ExecutionPolicy>(policy),samples,firstSample,sampleCount,firstDim,dimCount);
+			return samples;
+		}
+
+		//! Validates a serialized table, returns nullptr if `src` doesn't hold one or is too small, otherwise the samples and their header
+		static inline const uint32_t* deserializeTable(const void* src, size_t srcSize, STableHeader& outHeader)
+		{
+			if (srcSize<sizeof(STableHeader))
+				return nullptr;
+			memcpy(&outHeader,src,sizeof(STableHeader));
+			if (outHeader.magic!=STableHeader::Magic || outHeader.version!=STableHeader::Version)
+				return nullptr;
+			if (srcSize<getSerializedTableSize(outHeader.sampleCount,outHeader.dimCount))
+				return nullptr;
+			return reinterpret_cast<const uint32_t*>(reinterpret_cast<const uint8_t*>(src)+sizeof(STableHeader));
+		}
+
 	protected:
 		typedef struct SobolDirectionNumbers {
 			uint32_t d, s, a;
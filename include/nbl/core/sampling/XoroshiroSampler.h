@@ -0,0 +1,140 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef _NBL_CORE_XOROSHIRO_SAMPLER_H_INCLUDED_
+#define _NBL_CORE_XOROSHIRO_SAMPLER_H_INCLUDED_
+
+#include "nbl/core/decl/Types.h"
+#include "nbl/builtin/hlsl/random/xoroshiro.hlsl"
+
+namespace nbl::core
+{
+
+//! C++ side of `nbl/builtin/hlsl/random/xoroshiro.hlsl`, runs the very same code so a stream started here can be continued on the GPU and vice versa.
+/** 8 bytes of state instead of `std::mt19937`'s 2.5kB, and it can skip ahead to split a sequence into non-overlapping per-thread streams:
+- `jump()` advances by 2^32 outputs, so you get 2^32 streams of 2^32 numbers each
+- `long_jump()` advances by 2^48 outputs, for 2^16 groups of streams made with `jump()`
+Meets the requirements of a UniformRandomBitGenerator, so it can be used with `<random>` distributions. */
+template<class Generator=hlsl::Xoroshiro64StarStar>
+class XoroshiroSampler
+{
+	public:
+		using result_type = uint32_t;
+		using state_type = hlsl::uint32_t2;
+
+		static constexpr result_type min() {return 0u;}
+		static constexpr result_type max() {return ~0u;}
+
+		//! Spreads the seed over the whole state with splitmix64, so seeds which differ by a few bits still give uncorrelated streams
+		explicit XoroshiroSampler(uint32_t _seed=0u) : XoroshiroSampler(unpack(splitmix64(_seed))) {}
+		//! The state must not be all zero
+		explicit XoroshiroSampler(const state_type& _state) : generator(Generator::construct(_state))
+		{
+			assert(pack(_state)!=0ull);
+		}
+
+		//
+		inline result_type operator()()
+		{
+			return generator();
+		}
+		inline result_type nextSample()
+		{
+			return generator();
+		}
+
+		//! For handing the stream over to a shader
+		inline const state_type& getState() const {return generator.stateHolder.state;}
+
+		inline void jump()
+		{
+			setState(getJumpMatrices().jump.apply(pack(getState())));
+		}
+		inline void long_jump()
+		{
+			setState(getJumpMatrices().longJump.apply(pack(getState())));
+		}
+
+	protected:
+		// the state transition is linear over GF(2), so advancing by N steps is a multiplication by a 64x64 bit matrix
+		struct SJumpMatrix
+		{
+			inline uint64_t apply(uint64_t state) const
+			{
+				uint64_t retval = 0ull;
+				for (uint32_t i=0u; state; i++,state>>=1u)
+				if (state&0x1ull)
+					retval ^= columns[i];
+				return retval;
+			}
+
+			uint64_t columns[64];
+		};
+		struct SJumpMatrices
+		{
+			SJumpMatrix jump;
+			SJumpMatrix longJump;
+		};
+
+		// generated once by squaring the single step matrix
+		static inline const SJumpMatrices& getJumpMatrices()
+		{
+			static const SJumpMatrices matrices = []() -> SJumpMatrices
+			{
+				SJumpMatrix power;
+				for (uint32_t i=0u; i<64u; i++)
+				{
+					hlsl::Xoroshiro64StateHolder holder = {unpack(0x1ull<<i)};
+					holder.xoroshiro64_state_advance();
+					power.columns[i] = pack(holder.state);
+				}
+				auto square = [&power]() -> void
+				{
+					SJumpMatrix squared;
+					for (uint32_t i=0u; i<64u; i++)
+						squared.columns[i] = power.apply(power.columns[i]);
+					power = squared;
+				};
+
+				SJumpMatrices retval;
+				for (uint32_t i=0u; i<32u; i++)
+					square();
+				retval.jump = power;
+				for (uint32_t i=32u; i<48u; i++)
+					square();
+				retval.longJump = power;
+				return retval;
+			}();
+			return matrices;
+		}
+
+		static inline uint64_t splitmix64(uint64_t x)
+		{
+			x += 0x9E3779B97F4A7C15ull;
+			x = (x^(x>>30u))*0xBF58476D1CE4E5B9ull;
+			x = (x^(x>>27u))*0x94D049BB133111EBull;
+			x ^= x>>31u;
+			// all zero state is the only fixed point of xoroshiro
+			return x ? x:0x1ull;
+		}
+
+		static inline uint64_t pack(const state_type& state)
+		{
+			return (uint64_t(state[1])<<32u)|state[0];
+		}
+		static inline state_type unpack(uint64_t state)
+		{
+			return state_type(static_cast<uint32_t>(state),static_cast<uint32_t>(state>>32u));
+		}
+		inline void setState(uint64_t state)
+		{
+			generator.stateHolder.state = unpack(state);
+		}
+
+		Generator generator;
+};
+
+}
+
+#endif
@@ -0,0 +1,45 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef _NBL_CORE_UTIL_CPU_FEATURES_H_INCLUDED_
+#define _NBL_CORE_UTIL_CPU_FEATURES_H_INCLUDED_
+
+#include "nbl/macros.h"
+
+namespace nbl::core
+{
+
+//! Instruction set extensions of the CPU we're running on, for picking code paths at runtime.
+/** Only extensions the OS also saves the register state of are reported (AVX and AVX-512 need XSAVE support),
+everything is false on non-x86 targets. */
+struct SCPUFeatures
+{
+    bool sse42 = false;
+    bool popcnt = false;
+    bool avx = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool f16c = false;
+    bool bmi1 = false;
+    bool bmi2 = false;
+    //! `pdep` and `pext` are microcoded (tens of cycles) on AMD before Zen 3, so bit-twiddling is faster there
+    bool fastPdepPext = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool avx512vl = false;
+};
+
+//! Detected once, on first call
+NBL_API2 const SCPUFeatures& getCPUFeatures();
+
+}
+
+//! Lets a single function use instructions above the baseline the project is compiled for, MSVC doesn't need (or have) this
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define NBL_TARGET_ISA(ISA)
+#else
+    #define NBL_TARGET_ISA(ISA) __attribute__((target(ISA)))
+#endif
+
+#endif
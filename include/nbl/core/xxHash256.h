@@ -7,95 +7,141 @@
 
 #include <cstdint>
 #include <cstring>
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <span>
+#include <type_traits>
+
+#include <cassert>
 
 namespace nbl::core
 {
-constexpr std::array<uint64_t, 4> XXHash_256(const uint8_t* input, const size_t len)
+namespace impl
 {
-#define _rotl(x,r) ((x << r) | (x >> (64 - r)))
-    constexpr uint64_t PRIME = 11400714819323198393ULL;
+struct XXHash_256_Constants
+{
+    static constexpr uint64_t PRIME = 11400714819323198393ULL;
+    static constexpr size_t small_loop_step = 4 * sizeof(uint64_t);
+    static constexpr size_t big_loop_step = 4 * 4 * sizeof(uint64_t);
+    // Set the big loop limit early enough, so the well-mixing small loop can be executed twice after it
+    static constexpr size_t big_loop_req_len = big_loop_step + 2 * small_loop_step;
+};
 
-    uint64_t out[4] = { 0,0,0,0 }; // must be initialized to 0s
+constexpr uint64_t XXHash_256_getU64(const uint8_t* in)
+{
+    // outside of constant evaluation a single unaligned load is way faster than assembling bytes, not every compiler spots the pattern
+    if constexpr (std::endian::native == std::endian::little)
+    if (!std::is_constant_evaluated())
+    {
+        uint64_t u64;
+        std::memcpy(&u64, in, sizeof(uint64_t));
+        return u64;
+    }
 
-    const uint8_t* p = input;
-    const uint8_t* const bEnd = p + len;
+    uint64_t u64 = 0;
+    for (int i = 0; i < 8; ++i)
+        u64 |= static_cast<uint64_t>(in[i]) << (i * 8);
+    return u64;
+}
 
-    uint64_t v1 = len * PRIME;
-    uint64_t v2 = v1;
-    uint64_t v3 = v1;
-    uint64_t v4 = v1;
+// consumes `big_loop_step` bytes per block
+constexpr void XXHash_256_bigLoop(uint64_t (&v)[4], const uint8_t* p, size_t blockCount)
+{
+    constexpr uint64_t PRIME = XXHash_256_Constants::PRIME;
+    uint64_t v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+    for (; blockCount; --blockCount)
+    {
+        v1 = std::rotl(v1, 29) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v2 = std::rotl(v2, 31) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v3 = std::rotl(v3, 33) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v4 = std::rotl(v4, 35) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v1 += v2 *= PRIME;
+        v1 = std::rotl(v1, 29) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v2 = std::rotl(v2, 31) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v3 = std::rotl(v3, 33) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v4 = std::rotl(v4, 35) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v2 += v3 *= PRIME;
+        v1 = std::rotl(v1, 29) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v2 = std::rotl(v2, 31) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v3 = std::rotl(v3, 33) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v4 = std::rotl(v4, 35) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v3 += v4 *= PRIME;
+        v1 = std::rotl(v1, 29) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v2 = std::rotl(v2, 31) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v3 = std::rotl(v3, 33) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v4 = std::rotl(v4, 35) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v4 += v1 *= PRIME;
+    }
+    v[0] = v1; v[1] = v2; v[2] = v3; v[3] = v4;
+}
 
-    constexpr size_t small_loop_step = 4 * sizeof(uint64_t);
-    if (len >= small_loop_step)
+// consumes `small_loop_step` bytes per block
+constexpr void XXHash_256_smallLoop(uint64_t (&v)[4], const uint8_t* p, size_t blockCount)
+{
+    constexpr uint64_t PRIME = XXHash_256_Constants::PRIME;
+    uint64_t v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+    for (; blockCount; --blockCount)
     {
-        const uint8_t* const small_loop_limit = bEnd - small_loop_step;
+        v1 = std::rotl(v1, 29) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v2 += v1 *= PRIME;
+        v2 = std::rotl(v2, 31) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v3 += v2 *= PRIME;
+        v3 = std::rotl(v3, 33) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v4 += v3 *= PRIME;
+        v4 = std::rotl(v4, 35) + XXHash_256_getU64(p); p += sizeof(uint64_t);
+        v1 += v4 *= PRIME;
+    }
+    v[0] = v1; v[1] = v2; v[2] = v3; v[3] = v4;
+}
 
-        constexpr auto getU64 = [](const uint8_t* in)
-        {
-            uint64_t u64 = 0;
+// how many blocks each loop runs for an input of `len` bytes, the loop bounds depend on the total length
+constexpr size_t XXHash_256_bigBlockCount(const size_t len)
+{
+    using C = XXHash_256_Constants;
+    if (len <= C::big_loop_req_len)
+        return 0;
+    return (len - C::big_loop_req_len + C::big_loop_step - 1) / C::big_loop_step;
+}
+constexpr size_t XXHash_256_smallBlockCount(const size_t len)
+{
+    using C = XXHash_256_Constants;
+    const size_t offset = XXHash_256_bigBlockCount(len) * C::big_loop_step;
+    if (len < C::small_loop_step || offset >= len - C::small_loop_step)
+        return 0;
+    return (len - C::small_loop_step - offset + C::small_loop_step - 1) / C::small_loop_step;
+}
 
-            for (int i = 0; i < 8; ++i)
-                u64 |= static_cast<uint64_t>(in[i]) << (i * 8);
-            return u64;
-        };
+// the leftover (at most `small_loop_step`) bytes get added to the state as-is
+constexpr std::array<uint64_t, 4> XXHash_256_finalize(const uint64_t (&v)[4], const uint8_t* p, const size_t leftOverBytes)
+{
+    uint64_t out[4] = { 0,0,0,0 }; // must be initialized to 0s
 
-        const size_t big_loop_step = 4 * 4 * sizeof(uint64_t);
-        // Set the big loop limit early enough, so the well-mixing small loop can be executed twice after it
-        const size_t big_loop_req_len = big_loop_step + 2 * small_loop_step;
-        if (len >= big_loop_req_len)
-        {
-            const uint8_t* const big_loop_limit = bEnd - big_loop_req_len;
-            while (p < big_loop_limit)
-            {
-                v1 = _rotl(v1, 29) + getU64(p); p += sizeof(uint64_t);
-                v2 = _rotl(v2, 31) + getU64(p); p += sizeof(uint64_t);
-                v3 = _rotl(v3, 33) + getU64(p); p += sizeof(uint64_t);
-                v4 = _rotl(v4, 35) + getU64(p); p += sizeof(uint64_t);
-                v1 += v2 *= PRIME;
-                v1 = _rotl(v1, 29) + getU64(p); p += sizeof(uint64_t);
-                v2 = _rotl(v2, 31) + getU64(p); p += sizeof(uint64_t);
-                v3 = _rotl(v3, 33) + getU64(p); p += sizeof(uint64_t);
-                v4 = _rotl(v4, 35) + getU64(p); p += sizeof(uint64_t);
-                v2 += v3 *= PRIME;
-                v1 = _rotl(v1, 29) + getU64(p); p += sizeof(uint64_t);
-                v2 = _rotl(v2, 31) + getU64(p); p += sizeof(uint64_t);
-                v3 = _rotl(v3, 33) + getU64(p); p += sizeof(uint64_t);
-                v4 = _rotl(v4, 35) + getU64(p); p += sizeof(uint64_t);
-                v3 += v4 *= PRIME;
-                v1 = _rotl(v1, 29) + getU64(p); p += sizeof(uint64_t);
-                v2 = _rotl(v2, 31) + getU64(p); p += sizeof(uint64_t);
-                v3 = _rotl(v3, 33) + getU64(p); p += sizeof(uint64_t);
-                v4 = _rotl(v4, 35) + getU64(p); p += sizeof(uint64_t);
-                v4 += v1 *= PRIME;
-            }
-        }
+    for (size_t i = 0; i < leftOverBytes; ++i)
+        out[i / 8] |= (static_cast<uint64_t>(p[i]) << ((i % 8) * 8));
 
-        while (p < small_loop_limit)
-        {
-            v1 = _rotl(v1, 29) + getU64(p); p += sizeof(uint64_t);
-            v2 += v1 *= PRIME;
-            v2 = _rotl(v2, 31) + getU64(p); p += sizeof(uint64_t);
-            v3 += v2 *= PRIME;
-            v3 = _rotl(v3, 33) + getU64(p); p += sizeof(uint64_t);
-            v4 += v3 *= PRIME;
-            v4 = _rotl(v4, 35) + getU64(p); p += sizeof(uint64_t);
-            v1 += v4 *= PRIME;
-        }
-    }
-#undef _rotl
+    return { out[0]+v[0],out[1]+v[1],out[2]+v[2],out[3]+v[3] };
+}
+}
 
-    size_t leftOverBytes = bEnd - p;
+constexpr std::array<uint64_t, 4> XXHash_256(const uint8_t* input, const size_t len)
+{
+    using C = impl::XXHash_256_Constants;
 
-    for (size_t i = 0; i < leftOverBytes; ++i)
-        out[i / 8] |= (static_cast<uint64_t>(p[i]) << ((i % 8) * 8));
+    const uint8_t* p = input;
+    uint64_t v[4];
+    for (auto& lane : v)
+        lane = len * C::PRIME;
 
-    out[0] += v1;
-    out[1] += v2;
-    out[2] += v3;
-    out[3] += v4;
+    const size_t bigBlocks = impl::XXHash_256_bigBlockCount(len);
+    impl::XXHash_256_bigLoop(v, p, bigBlocks);
+    p += bigBlocks * C::big_loop_step;
 
-    return { out[0],out[1],out[2],out[3] };
+    const size_t smallBlocks = impl::XXHash_256_smallBlockCount(len);
+    impl::XXHash_256_smallLoop(v, p, smallBlocks);
+    p += smallBlocks * C::small_loop_step;
+
+    return impl::XXHash_256_finalize(v, p, input + len - p);
 }
 
 /*
@@ -153,6 +199,93 @@ inline void XXHash_256(const void* input, size_t len, uint64_t* out)
     for (uint8_t i = 0; i < hash.size(); ++i)
         out[i] = hash[i];
 }
+
+//! Incremental version of `XXHash_256`, feed it the input piece by piece with `update` and get the exact same hash from `finalize`.
+/** The length of the input needs to be known upfront, because it seeds the hash state and decides where the loops of the algorithm stop.
+Whole blocks are hashed straight out of the spans passed to `update`, only blocks straddling two `update` calls get copied.
+Usable in constant evaluation too. */
+class XXHash_256_Stream
+{
+        using C = impl::XXHash_256_Constants;
+
+    public:
+        constexpr XXHash_256_Stream(const size_t _totalLength) : totalLength(_totalLength),
+            bigLoopEnd(impl::XXHash_256_bigBlockCount(_totalLength)*C::big_loop_step),
+            smallLoopEnd(bigLoopEnd+impl::XXHash_256_smallBlockCount(_totalLength)*C::small_loop_step)
+        {
+            for (auto& lane : v)
+                lane = totalLength * C::PRIME;
+        }
+
+        //! Returns false if `data` goes past `totalLength`, the excess is then dropped (and the hash is not the one of the whole input anymore)
+        constexpr bool update(std::span<const uint8_t> data)
+        {
+            const size_t remaining = totalLength - consumed - buffered;
+            const bool fits = data.size() <= remaining;
+            assert(fits);
+            if (!fits)
+                data = data.first(remaining);
+            while (!data.empty())
+            {
+                const size_t offset = consumed + buffered;
+                const size_t blockSize = offset<bigLoopEnd ? C::big_loop_step:(offset<smallLoopEnd ? C::small_loop_step:(totalLength-smallLoopEnd));
+                // complete a partially filled block first
+                if (buffered || data.size() < blockSize || offset >= smallLoopEnd)
+                {
+                    const size_t copied = std::min(blockSize - buffered, data.size());
+                    std::copy_n(data.data(), copied, buffer + buffered);
+                    buffered += copied;
+                    data = data.subspan(copied);
+                    if (buffered == blockSize && offset < smallLoopEnd)
+                    {
+                        consume(buffer, blockSize, 1);
+                        buffered = 0;
+                    }
+                    continue;
+                }
+                // hash as many whole blocks of the current loop as possible in-place
+                const size_t loopEnd = offset<bigLoopEnd ? bigLoopEnd:smallLoopEnd;
+                const size_t blockCount = std::min(loopEnd - offset, data.size()) / blockSize;
+                consume(data.data(), blockSize, blockCount);
+                data = data.subspan(blockCount * blockSize);
+            }
+            return fits;
+        }
+        inline bool update(const void* data, const size_t len)
+        {
+            return update(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(data), len));
+        }
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        inline bool updateWithObject(const T& obj)
+        {
+            return update(&obj, sizeof(T));
+        }
+
+        //! All `totalLength` bytes must have been fed to `update` by now
+        constexpr std::array<uint64_t, 4> finalize() const
+        {
+            assert(consumed + buffered == totalLength);
+            return impl::XXHash_256_finalize(v, buffer, buffered);
+        }
+
+    private:
+        constexpr void consume(const uint8_t* p, const size_t blockSize, const size_t blockCount)
+        {
+            if (blockSize == C::big_loop_step)
+                impl::XXHash_256_bigLoop(v, p, blockCount);
+            else
+                impl::XXHash_256_smallLoop(v, p, blockCount);
+            consumed += blockSize * blockCount;
+        }
+
+        const size_t totalLength;
+        const size_t bigLoopEnd;
+        const size_t smallLoopEnd;
+        size_t consumed = 0;
+        size_t buffered = 0;
+        uint64_t v[4] = {};
+        uint8_t buffer[C::big_loop_step] = {};
+};
 }
 
 #endif // __NBL_CORE_XXHASH256_H_INCLUDED__
\ No newline at end of file
@@ -0,0 +1,160 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/asset/CFileBackedCPUBuffer.h"
+
+using namespace nbl;
+using namespace nbl::asset;
+
+CFileBackedCPUBuffer::CFileBackedCPUBuffer(core::smart_refctd_ptr<system::IFile>&& _file, const size_t _fileOffset, const size_t _size) :
+	ICPUBuffer(_size,nullptr), m_file(std::move(_file)), m_fileOffset(_fileOffset), m_residentPages((_size+PageSize-1ull)/PageSize,false)
+{
+	// the base constructor takes no data as no contents
+	m_creationParams.size = _size;
+}
+
+CFileBackedCPUBuffer::~CFileBackedCPUBuffer()
+{
+	release();
+}
+
+bool CFileBackedCPUBuffer::prefetch(const size_t offset, const size_t size)
+{
+	std::unique_lock lock(m_lock);
+	return pageIn_impl(offset,size);
+}
+
+void CFileBackedCPUBuffer::drop()
+{
+	std::unique_lock lock(m_lock);
+	if (m_file)
+		release();
+}
+
+size_t CFileBackedCPUBuffer::getResidentSize() const
+{
+	std::unique_lock lock(m_lock);
+	if (m_residentPageCount==0ull)
+		return 0ull;
+	// only the last page can be partial
+	size_t retval = m_residentPageCount*PageSize;
+	if (m_residentPages.back())
+		retval -= m_residentPages.size()*PageSize-getSize();
+	return retval;
+}
+
+void* CFileBackedCPUBuffer::pageIn(const size_t offset, const size_t size)
+{
+	std::unique_lock lock(m_lock);
+	return pageIn_impl(offset,size);
+}
+
+void CFileBackedCPUBuffer::freeData()
+{
+	std::unique_lock lock(m_lock);
+	release();
+}
+
+void CFileBackedCPUBuffer::restoreFromDummy_impl(IAsset* _other, uint32_t _levelsBelow)
+{
+	if (!willBeRestoredFrom(_other))
+		return;
+
+	// take over the file and whatever got read of it
+	if (auto* other=dynamic_cast<CFileBackedCPUBuffer*>(_other))
+	{
+		std::scoped_lock lock(m_lock,other->m_lock);
+		std::swap(m_file,other->m_file);
+		std::swap(m_fileOffset,other->m_fileOffset);
+		std::swap(m_storage,other->m_storage);
+		std::swap(m_residentPages,other->m_residentPages);
+		std::swap(m_residentPageCount,other->m_residentPageCount);
+		ICPUBuffer::data.store(other->ICPUBuffer::data.exchange(ICPUBuffer::data.load()),std::memory_order_release);
+		return;
+	}
+
+	// anything else could have its contents from an allocator we know nothing about
+	const void* contents = static_cast<const ICPUBuffer*>(_other)->getPointer();
+	auto* storage = contents ? reinterpret_cast<uint8_t*>(_NBL_ALIGNED_MALLOC(getSize(),_NBL_SIMD_ALIGNMENT)):nullptr;
+	if (storage)
+		memcpy(storage,contents,getSize());
+	std::unique_lock lock(m_lock);
+	release();
+	adopt(storage);
+}
+
+void* CFileBackedCPUBuffer::exchangeData(void* _data)
+{
+	std::unique_lock lock(m_lock);
+	// the contents must all be in memory to be given away
+	uint8_t* retval = pageIn_impl(0ull,getSize()) ? m_storage:nullptr;
+	if (!retval)
+		release();
+	m_storage = nullptr;
+	adopt(reinterpret_cast<uint8_t*>(_data));
+	return retval;
+}
+
+uint8_t* CFileBackedCPUBuffer::pageIn_impl(const size_t offset, const size_t size)
+{
+	// a dummy must not get its contents back, and without a file there's nowhere to get them from
+	if (isADummyObjectForCache() || !m_file || offset>=getSize())
+		return nullptr;
+
+	if (!m_storage)
+	{
+		m_storage = reinterpret_cast<uint8_t*>(_NBL_ALIGNED_MALLOC(getSize(),_NBL_SIMD_ALIGNMENT));
+		if (!m_storage)
+			return nullptr;
+	}
+
+	const size_t end = size<getSize()-offset ? (offset+size):getSize();
+	const size_t lastPage = (end-1ull)/PageSize;
+	for (size_t page=offset/PageSize; page<=lastPage; page++)
+	{
+		if (m_residentPages[page])
+			continue;
+		// one read for every run of missing pages
+		size_t runEnd = page+1ull;
+		while (runEnd<=lastPage && !m_residentPages[runEnd])
+			runEnd++;
+
+		const size_t readOffset = page*PageSize;
+		const size_t readSize = std::min(runEnd*PageSize,getSize())-readOffset;
+		system::IFile::success_t success;
+		m_file->read(success,m_storage+readOffset,m_fileOffset+readOffset,readSize);
+		if (!success)
+			return nullptr;
+
+		std::fill(m_residentPages.begin()+page,m_residentPages.begin()+runEnd,true);
+		m_residentPageCount += runEnd-page;
+		page = runEnd-1ull;
+	}
+
+	// from now on `getPointer` doesn't need to come here, the release makes the pages we just read visible with the pointer
+	if (m_residentPageCount==m_residentPages.size())
+		ICPUBuffer::data.store(m_storage,std::memory_order_release);
+	return m_storage+offset;
+}
+
+void CFileBackedCPUBuffer::release()
+{
+	if (m_storage)
+		_NBL_ALIGNED_FREE(m_storage);
+	m_storage = nullptr;
+	ICPUBuffer::data = nullptr; // so that ICPUBuffer won't try deallocating
+	std::fill(m_residentPages.begin(),m_residentPages.end(),false);
+	m_residentPageCount = 0ull;
+}
+
+void CFileBackedCPUBuffer::adopt(uint8_t* _storage)
+{
+	m_file = nullptr;
+	m_fileOffset = 0ull;
+	m_storage = _storage;
+	const bool resident = m_storage;
+	std::fill(m_residentPages.begin(),m_residentPages.end(),resident);
+	m_residentPageCount = resident ? m_residentPages.size():0ull;
+	ICPUBuffer::data.store(m_storage,std::memory_order_release);
+}
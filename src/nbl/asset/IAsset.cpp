@@ -4,8 +4,121 @@
 
 #include "nbl/asset/IAsset.h"
 
+#include "nbl/core/declarations.h"
+#include "nbl/core/parallel/CThreadPool.h"
+
+using namespace nbl;
 using namespace nbl::asset;
 
 IAsset::~IAsset()
 {
-}
\ No newline at end of file
+}
+
+namespace
+{
+    thread_local IAsset::SCloneSession* tl_cloneSession = nullptr;
+}
+
+struct IAsset::SCloneSession::SState
+{
+    struct SKey
+    {
+        inline bool operator==(const SKey&) const = default;
+
+        const IAsset* asset;
+        uint32_t depth;
+    };
+    struct SKeyHash
+    {
+        inline size_t operator()(const SKey& key) const
+        {
+            return std::hash<const IAsset*>()(key.asset)^(size_t(key.depth)<<1ull);
+        }
+    };
+    struct SClone
+    {
+        // keeps the address in the key from getting reused by another asset while the session is open
+        core::smart_refctd_ptr<const IAsset> original;
+        core::smart_refctd_ptr<IAsset> clone;
+    };
+    core::unordered_map<SKey,SClone,SKeyHash> clones;
+    // how many `clone` calls on this session are on the stack
+    uint32_t nesting = 0u;
+
+    struct SCopy
+    {
+        void* dst;
+        const void* src;
+        size_t size;
+    };
+    core::vector<SCopy> pendingCopies;
+};
+
+IAsset::SCloneSession::SCloneSession() : m_state(new SState()), m_previous(tl_cloneSession)
+{
+    tl_cloneSession = this;
+}
+
+IAsset::SCloneSession::~SCloneSession()
+{
+    flush();
+    tl_cloneSession = m_previous;
+    delete m_state;
+}
+
+IAsset::SCloneSession* IAsset::SCloneSession::getCurrent()
+{
+    return tl_cloneSession;
+}
+
+void IAsset::SCloneSession::flush()
+{
+    auto& pending = m_state->pendingCopies;
+    if (pending.empty())
+        return;
+
+    // split into equal-ish pieces so one huge buffer doesn't end up on a single thread
+    core::vector<SState::SCopy> chunks;
+    for (const auto& copy : pending)
+    for (size_t offset=0ull; offset<copy.size; offset+=ParallelCopyChunkSize)
+    {
+        const size_t size = std::min(ParallelCopyChunkSize,copy.size-offset);
+        chunks.push_back({reinterpret_cast<uint8_t*>(copy.dst)+offset,reinterpret_cast<const uint8_t*>(copy.src)+offset,size});
+    }
+    pending.clear();
+
+    core::CThreadPool::getDefault().parallel_for(chunks.size(),1ull,[&chunks](const size_t begin, const size_t end) -> void
+    {
+        for (size_t i=begin; i<end; i++)
+            memcpy(chunks[i].dst,chunks[i].src,chunks[i].size);
+    });
+}
+
+void IAsset::SCloneSession::copy(void* dst, const void* src, const size_t size)
+{
+    if (size<ParallelCopyThreshold)
+        memcpy(dst,src,size);
+    else
+        m_state->pendingCopies.push_back({dst,src,size});
+}
+
+core::smart_refctd_ptr<IAsset> IAsset::SCloneSession::clone(const IAsset* _asset, uint32_t _depth)
+{
+    // buffers don't reference anything, so the depth makes no difference to the clone
+    if (_asset->getAssetType()==ET_BUFFER)
+        _depth = 0u;
+
+    const SState::SKey key = {_asset,_depth};
+    auto found = m_state->clones.find(key);
+    if (found!=m_state->clones.end())
+        return found->second.clone;
+
+    // can't hold on to an iterator, `clone_impl` recurses into this and can rehash the map
+    m_state->nesting++;
+    auto retval = _asset->clone_impl(_depth);
+    m_state->clones.emplace(key,SState::SClone{core::smart_refctd_ptr<const IAsset>(_asset),retval});
+    // the deferred copies only get batched up within one top level `clone`, nobody gets to see a clone before its contents are there
+    if (--m_state->nesting==0u)
+        flush();
+    return retval;
+}
@@ -92,6 +92,8 @@
 #endif
 
 #include "nbl/asset/interchange/CBufferLoaderBIN.h"
+#include "nbl/asset/interchange/CNBLLoader.h"
+#include "nbl/asset/interchange/CNBLWriter.h"
 #include "nbl/asset/utils/CGeometryCreator.h"
 #include "nbl/asset/utils/CMeshManipulator.h"
 
@@ -104,6 +106,7 @@ std::function<void(SAssetBundle&)> nbl::asset::makeAssetGreetFunc(const IAssetMa
 {
 	return [_mgr](SAssetBundle& _asset) {
 		_mgr->setAssetCached(_asset, true);
+		_mgr->accountCachedBundle(_asset, true);
 		auto rng = _asset.getContents();
 		//assets being in the cache must be immutable
         //asset mutability is changed just before insertion by inserting methods of IAssetManager
@@ -115,12 +118,670 @@ std::function<void(SAssetBundle&)> nbl::asset::makeAssetDisposeFunc(const IAsset
 {
 	return [_mgr](SAssetBundle& _asset) {
 		_mgr->setAssetCached(_asset, false);
+		_mgr->accountCachedBundle(_asset, false);
 		auto rng = _asset.getContents();
         for (auto ass : rng)
 			_mgr->setAssetMutability(ass.get(), IAsset::EM_MUTABLE);
 	};
 }
 
+void IAssetManager::accountCachedBundle(const SAssetBundle& _bundle, const bool _inserted) const
+{
+    const auto contents = _bundle.getContents();
+    if (contents.empty() || !contents.begin()[0])
+        return;
+
+    auto& accounting = m_cacheAccounting[IAsset::typeFlagToIndex(_bundle.getAssetType())];
+    std::unique_lock lock(accounting.lock);
+    if (_inserted)
+    {
+        uint64_t bytes = 0ull;
+        for (const auto& asset : contents)
+            bytes += asset->conservativeSizeEstimate();
+        const bool builtin = contents.begin()[0]->getMutability()==IAsset::EM_IMMUTABLE;
+        accounting.usage[_bundle.getCacheKey()].push_back({contents.begin()[0].get(),bytes,m_cacheUseClock.fetch_add(1ull,std::memory_order_relaxed),builtin});
+        accounting.bytesCached += bytes;
+        accounting.bundleCount++;
+        return;
+    }
+
+    auto found = accounting.usage.find(_bundle.getCacheKey());
+    if (found==accounting.usage.end())
+        return;
+    auto& records = found->second;
+    auto record = std::find_if(records.begin(),records.end(),[&contents](const SCacheAccounting::SUsage& r) -> bool {return r.firstAsset==contents.begin()[0].get();});
+    if (record==records.end())
+        return;
+    accounting.bytesCached -= record->bytes;
+    accounting.bundleCount--;
+    records.erase(record);
+    if (records.empty())
+        accounting.usage.erase(found);
+}
+
+void IAssetManager::touchCachedBundles(const uint32_t _typeIx, const SAssetBundle* _bundles, const size_t _count) const
+{
+    if (!_count)
+        return;
+
+    auto& accounting = m_cacheAccounting[_typeIx];
+    std::unique_lock lock(accounting.lock);
+    for (size_t i=0ull; i<_count; i++)
+    {
+        const auto contents = _bundles[i].getContents();
+        if (contents.empty())
+            continue;
+        accounting.hits++;
+        auto found = accounting.usage.find(_bundles[i].getCacheKey());
+        if (found==accounting.usage.end())
+            continue;
+        for (auto& record : found->second)
+        if (record.firstAsset==contents.begin()[0].get())
+            record.lastUse = m_cacheUseClock.fetch_add(1ull,std::memory_order_relaxed);
+    }
+}
+
+void IAssetManager::changeCachedBundleKey(const SAssetBundle& _bundle, const std::string& _oldKey, const std::string& _newKey)
+{
+    const auto contents = _bundle.getContents();
+    if (contents.empty() || _oldKey==_newKey)
+        return;
+
+    auto& accounting = m_cacheAccounting[IAsset::typeFlagToIndex(_bundle.getAssetType())];
+    std::unique_lock lock(accounting.lock);
+    auto found = accounting.usage.find(_oldKey);
+    if (found==accounting.usage.end())
+        return;
+    auto& records = found->second;
+    auto record = std::find_if(records.begin(),records.end(),[&contents](const SCacheAccounting::SUsage& r) -> bool {return r.firstAsset==contents.begin()[0].get();});
+    if (record==records.end())
+        return;
+    const auto moved = *record;
+    records.erase(record);
+    if (records.empty())
+        accounting.usage.erase(found);
+    accounting.usage[_newKey].push_back(moved);
+}
+
+void IAssetManager::evictToBudget(const uint32_t _typeIx)
+{
+    auto& accounting = m_cacheAccounting[_typeIx];
+    struct SVictim
+    {
+        std::string key;
+        const IAsset* firstAsset;
+        uint64_t bytes;
+        uint64_t lastUse;
+    };
+    core::vector<SVictim> victims;
+    uint64_t targetBytes;
+    {
+        std::unique_lock lock(accounting.lock);
+        if (!accounting.byteBudget || accounting.bytesCached<=accounting.byteBudget)
+            return;
+        // free a bit more than needed, so the next few insertions don't have to evict again
+        targetBytes = accounting.byteBudget-accounting.byteBudget/8ull;
+        for (const auto& entry : accounting.usage)
+        for (const auto& record : entry.second)
+        if (!record.builtin)
+            victims.push_back({entry.first,record.firstAsset,record.bytes,record.lastUse});
+    }
+    std::sort(victims.begin(),victims.end(),[](const SVictim& lhs, const SVictim& rhs) -> bool {return lhs.lastUse<rhs.lastUse;});
+
+    // can't hold the accounting lock while removing from the cache, the dispose function takes it
+    auto& cache = m_assetCache[_typeIx];
+    core::vector<SAssetBundle> found;
+    bool evicted = false;
+    for (const auto& victim : victims)
+    {
+        {
+            std::unique_lock lock(accounting.lock);
+            if (accounting.bytesCached<=targetBytes)
+                break;
+        }
+
+        size_t count = 0ull;
+        cache->findAndStoreRange(victim.key,count,static_cast<SAssetBundle*>(nullptr));
+        found.resize(count);
+        cache->findAndStoreRange(victim.key,count,found.data());
+        for (size_t i=0ull; i<count; i++)
+        {
+            auto& bundle = found[i];
+            if (bundle.getContents().empty() || bundle.getContents().begin()[0].get()!=victim.firstAsset)
+                continue;
+            // Only evict what nothing but the cache needs, so that evicting never splits an asset in two when it gets loaded again.
+            // We expect exactly two references to each asset of the bundle: the bundle stored in the cache and our copy in `found`.
+            // A third one is a user's `smart_refctd_ptr`, a bundle still held from an earlier load, or another asset referencing it
+            // (a cached mesh referencing the meshbuffer, a pipeline the shader, ...), which then has to be evicted or released first.
+            // The deduplicator keeping the first asset with some contents doesn't count, it lets go of them below.
+            bool inUse = false;
+            for (const auto& asset : bundle.getContents())
+                inUse = inUse || static_cast<uint32_t>(asset->getReferenceCount())>2u+m_deduplicator->getHeldReferenceCount(asset.get());
+            if (!inUse && removeAssetFromCache(bundle))
+            {
+                evicted = true;
+                std::unique_lock lock(accounting.lock);
+                accounting.evictions++;
+                accounting.evictedBytes += victim.bytes;
+            }
+        }
+        found.clear();
+    }
+    // otherwise the evicted assets and everything they reference would live on in the deduplicator
+    if (evicted)
+        m_deduplicator->releaseUnused();
+}
+
+void IAssetManager::setCacheBudget(const IAsset::E_TYPE _type, const uint64_t _byteBudget)
+{
+    const uint32_t typeIx = IAsset::typeFlagToIndex(_type);
+    {
+        std::unique_lock lock(m_cacheAccounting[typeIx].lock);
+        m_cacheAccounting[typeIx].byteBudget = _byteBudget;
+    }
+    evictToBudget(typeIx);
+}
+
+IAssetManager::SCacheStatistics IAssetManager::getCacheStatistics(const IAsset::E_TYPE _type) const
+{
+    auto& accounting = m_cacheAccounting[IAsset::typeFlagToIndex(_type)];
+    std::unique_lock lock(accounting.lock);
+    SCacheStatistics retval;
+    retval.bytesCached = accounting.bytesCached;
+    retval.byteBudget = accounting.byteBudget;
+    retval.bundleCount = accounting.bundleCount;
+    retval.hits = accounting.hits;
+    retval.evictions = accounting.evictions;
+    retval.evictedBytes = accounting.evictedBytes;
+    return retval;
+}
+
+IAssetManager::SLoaderCall*& IAssetManager::getLoaderCallOnThisThread()
+{
+    thread_local SLoaderCall* call = nullptr;
+    return call;
+}
+
+void IAssetManager::changeRegistry(const std::function<void(SRegistry&)>& _change)
+{
+    std::unique_lock lock(m_registryChangeLock);
+    auto registry = std::make_shared<SRegistry>(*m_registry.load(std::memory_order_relaxed));
+    _change(*registry);
+    // the replaced registry gets freed here unless a load or write still uses it, then the last of them does
+    m_registry.store(std::move(registry),std::memory_order_release);
+}
+
+SAssetBundle IAssetManager::callLoader(const SRegistry& _registry, IAssetLoader* _loader, system::IFile* _file, const std::string& _cacheKey, const IAssetLoader::SAssetLoadParams& _params, IAssetLoader::IAssetLoaderOverride* _override, const uint32_t _hierarchyLevel)
+{
+    auto counters = m_statisticsEnabled.load(std::memory_order_relaxed) ? _registry.loaderCounters.find(_loader):_registry.loaderCounters.end();
+    if (counters==_registry.loaderCounters.end())
+        return _loader->loadAsset(_file, _params, _override, _hierarchyLevel);
+
+    // the dependency loads add their time to this while it's the innermost call on the thread
+    SLoaderCall call = {counters->second.get(),&_cacheKey};
+    SLoaderCall*& current = getLoaderCallOnThisThread();
+    SLoaderCall* const previous = current;
+    current = &call;
+    const auto start = std::chrono::steady_clock::now();
+    auto bundle = _loader->loadAsset(_file, _params, _override, _hierarchyLevel);
+    const auto end = std::chrono::steady_clock::now();
+    current = previous;
+
+    auto& stats = *counters->second;
+    stats.calls.fetch_add(1ull,std::memory_order_relaxed);
+    if (bundle.getContents().empty())
+        stats.failures.fetch_add(1ull,std::memory_order_relaxed);
+    stats.inputFileBytes.fetch_add(_file->getSize(),std::memory_order_relaxed);
+    stats.wallTimeNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count(),std::memory_order_relaxed);
+    stats.dependencyTimeNs.fetch_add(call.dependencyTimeNs,std::memory_order_relaxed);
+    logStatisticsIfDue(end);
+    return bundle;
+}
+
+bool IAssetManager::callWriter(const SRegistry& _registry, IAssetWriter* _writer, system::IFile* _file, const IAssetWriter::SAssetWriteParams& _params, IAssetWriter::IAssetWriterOverride* _override)
+{
+    auto counters = m_statisticsEnabled.load(std::memory_order_relaxed) ? _registry.writerCounters.find(_writer):_registry.writerCounters.end();
+    if (counters==_registry.writerCounters.end())
+        return _writer->writeAsset(_file, _params, _override);
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool success = _writer->writeAsset(_file, _params, _override);
+    const auto end = std::chrono::steady_clock::now();
+
+    auto& stats = *counters->second;
+    stats.calls.fetch_add(1ull,std::memory_order_relaxed);
+    if (success)
+        stats.bytesWritten.fetch_add(_file->getSize(),std::memory_order_relaxed);
+    else
+        stats.failures.fetch_add(1ull,std::memory_order_relaxed);
+    stats.wallTimeNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count(),std::memory_order_relaxed);
+    logStatisticsIfDue(end);
+    return success;
+}
+
+IAssetManager::SLoaderStatistics IAssetManager::getStatistics(const SLoaderCounters& _counters)
+{
+    SLoaderStatistics retval;
+    retval.calls = _counters.calls.load(std::memory_order_relaxed);
+    retval.failures = _counters.failures.load(std::memory_order_relaxed);
+    retval.inputFileBytes = _counters.inputFileBytes.load(std::memory_order_relaxed);
+    retval.wallTime = std::chrono::nanoseconds(_counters.wallTimeNs.load(std::memory_order_relaxed));
+    retval.dependencyTime = std::chrono::nanoseconds(_counters.dependencyTimeNs.load(std::memory_order_relaxed));
+    for (uint32_t i=0u; i<IAsset::ET_STANDARD_TYPES_COUNT; i++)
+    {
+        retval.cacheHits[i] = _counters.cacheHits[i].load(std::memory_order_relaxed);
+        retval.cacheMisses[i] = _counters.cacheMisses[i].load(std::memory_order_relaxed);
+    }
+    return retval;
+}
+
+IAssetManager::SWriterStatistics IAssetManager::getStatistics(const SWriterCounters& _counters)
+{
+    SWriterStatistics retval;
+    retval.calls = _counters.calls.load(std::memory_order_relaxed);
+    retval.failures = _counters.failures.load(std::memory_order_relaxed);
+    retval.bytesWritten = _counters.bytesWritten.load(std::memory_order_relaxed);
+    retval.wallTime = std::chrono::nanoseconds(_counters.wallTimeNs.load(std::memory_order_relaxed));
+    return retval;
+}
+
+IAssetManager::SLoaderStatistics IAssetManager::getLoaderStatistics(const IAssetLoader* _loader) const
+{
+    const SRegistryReader registry(this);
+    auto found = registry->loaderCounters.find(_loader);
+    if (found==registry->loaderCounters.end())
+        return {};
+    return getStatistics(*found->second);
+}
+
+IAssetManager::SWriterStatistics IAssetManager::getWriterStatistics(const IAssetWriter* _writer) const
+{
+    const SRegistryReader registry(this);
+    auto found = registry->writerCounters.find(_writer);
+    if (found==registry->writerCounters.end())
+        return {};
+    return getStatistics(*found->second);
+}
+
+void IAssetManager::resetStatistics()
+{
+    const SRegistryReader registry(this);
+    for (auto& entry : registry->loaderCounters)
+    {
+        auto& counters = *entry.second;
+        counters.calls.store(0ull,std::memory_order_relaxed);
+        counters.failures.store(0ull,std::memory_order_relaxed);
+        counters.inputFileBytes.store(0ull,std::memory_order_relaxed);
+        counters.wallTimeNs.store(0ull,std::memory_order_relaxed);
+        counters.dependencyTimeNs.store(0ull,std::memory_order_relaxed);
+        for (uint32_t i=0u; i<IAsset::ET_STANDARD_TYPES_COUNT; i++)
+        {
+            counters.cacheHits[i].store(0ull,std::memory_order_relaxed);
+            counters.cacheMisses[i].store(0ull,std::memory_order_relaxed);
+        }
+    }
+    for (auto& entry : registry->writerCounters)
+    {
+        auto& counters = *entry.second;
+        counters.calls.store(0ull,std::memory_order_relaxed);
+        counters.failures.store(0ull,std::memory_order_relaxed);
+        counters.bytesWritten.store(0ull,std::memory_order_relaxed);
+        counters.wallTimeNs.store(0ull,std::memory_order_relaxed);
+    }
+}
+
+void IAssetManager::logStatistics(const system::logger_opt_ptr _logger) const
+{
+    // loaders and writers have no names, the extensions they handle will have to do
+    auto describe = [](const char** exts) -> std::string
+    {
+        std::string retval;
+        for (size_t extIx=0u; const char* ext=exts[extIx]; extIx++)
+            retval += (extIx ? ",.":".")+std::string(ext);
+        return retval;
+    };
+    auto toMs = [](const std::chrono::nanoseconds time) -> double {return std::chrono::duration<double,std::milli>(time).count();};
+
+    const SRegistryReader registry(this);
+    for (const auto& loader : registry->loaders)
+    {
+        auto found = registry->loaderCounters.find(loader.get());
+        if (found==registry->loaderCounters.end())
+            continue;
+        const auto stats = getStatistics(*found->second);
+        if (stats.calls==0ull)
+            continue;
+
+        std::string lookups;
+        for (uint32_t i=0u; i<IAsset::ET_STANDARD_TYPES_COUNT; i++)
+        if (stats.cacheHits[i] || stats.cacheMisses[i])
+            lookups += " type "+std::to_string(1ull<<i)+": "+std::to_string(stats.cacheHits[i])+"/"+std::to_string(stats.cacheMisses[i]);
+        _logger.log("Loader %p (%s): %llu calls, %llu failed, %llu bytes of input files, %.3f ms total, %.3f ms in dependencies, dependency cache hits/misses:%s", system::ILogger::ELL_PERFORMANCE,
+            loader.get(), describe(loader->getAssociatedFileExtensions()).c_str(), static_cast<unsigned long long>(stats.calls), static_cast<unsigned long long>(stats.failures),
+            static_cast<unsigned long long>(stats.inputFileBytes), toMs(stats.wallTime), toMs(stats.dependencyTime), lookups.empty() ? " none":lookups.c_str()
+        );
+    }
+    for (const auto& writer : registry->writerCounters)
+    {
+        const auto stats = getStatistics(*writer.second);
+        if (stats.calls==0ull)
+            continue;
+        _logger.log("Writer %p (%s): %llu calls, %llu failed, %llu bytes written, %.3f ms total", system::ILogger::ELL_PERFORMANCE,
+            writer.first, describe(writer.first->getAssociatedFileExtensions()).c_str(), static_cast<unsigned long long>(stats.calls), static_cast<unsigned long long>(stats.failures),
+            static_cast<unsigned long long>(stats.bytesWritten), toMs(stats.wallTime)
+        );
+    }
+    const auto deduplication = m_deduplicator->getStatistics();
+    if (deduplication.duplicates)
+        _logger.log("Deduplication: %llu duplicate assets replaced, ~%llu bytes saved", system::ILogger::ELL_PERFORMANCE,
+            static_cast<unsigned long long>(deduplication.duplicates), static_cast<unsigned long long>(deduplication.bytesSaved)
+        );
+}
+
+void IAssetManager::setPeriodicStatisticsLog(core::smart_refctd_ptr<system::ILogger>&& _logger, const std::chrono::milliseconds _period)
+{
+    std::unique_lock lock(m_statisticsLogLock);
+    const auto period = _logger ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(_period).count():0;
+    m_statisticsLogger = std::move(_logger);
+    m_nextStatisticsLog.store((std::chrono::steady_clock::now().time_since_epoch()).count()+period,std::memory_order_relaxed);
+    m_statisticsLogPeriod.store(period,std::memory_order_relaxed);
+}
+
+void IAssetManager::logStatisticsIfDue(const std::chrono::steady_clock::time_point _now)
+{
+    const auto period = m_statisticsLogPeriod.load(std::memory_order_relaxed);
+    if (period<=0)
+        return;
+    const auto now = _now.time_since_epoch().count();
+    auto next = m_nextStatisticsLog.load(std::memory_order_relaxed);
+    // only the thread which moves the deadline logs
+    if (now<next || !m_nextStatisticsLog.compare_exchange_strong(next,now+period,std::memory_order_relaxed))
+        return;
+
+    std::unique_lock lock(m_statisticsLogLock);
+    if (m_statisticsLogger)
+        logStatistics(m_statisticsLogger.get());
+}
+
+void IAssetManager::recordDependency(const std::string& _key) const
+{
+    const std::string* loading = IAssetLoader::SLoadScope::getCurrent();
+    if (!loading)
+        return;
+
+    std::unique_lock lock(m_dependencyGraph.lock);
+    // depending on an intermediate asset of another file is depending on that file
+    const std::string* dependency = &_key;
+    if (auto found=m_dependencyGraph.intermediateOwners.find(_key); found!=m_dependencyGraph.intermediateOwners.end())
+        dependency = &found->second;
+    if (*dependency==*loading)
+        return;
+    m_dependencyGraph.dependencies[*loading].insert(*dependency);
+    m_dependencyGraph.dependents[*dependency].insert(*loading);
+}
+
+void IAssetManager::recordIntermediateInsertion(const std::string& _key)
+{
+    const std::string* loading = IAssetLoader::SLoadScope::getCurrent();
+    // the file itself getting inserted
+    if (!loading || *loading==_key)
+        return;
+
+    std::unique_lock lock(m_dependencyGraph.lock);
+    m_dependencyGraph.intermediateOwners.insert_or_assign(_key,*loading);
+}
+
+core::unordered_set<std::string> IAssetManager::forgetDependencies(const std::string& _key)
+{
+    std::unique_lock lock(m_dependencyGraph.lock);
+    auto found = m_dependencyGraph.dependencies.find(_key);
+    if (found==m_dependencyGraph.dependencies.end())
+        return {};
+
+    core::unordered_set<std::string> retval = std::move(found->second);
+    m_dependencyGraph.dependencies.erase(found);
+    for (const auto& dependency : retval)
+    {
+        auto dependents = m_dependencyGraph.dependents.find(dependency);
+        if (dependents==m_dependencyGraph.dependents.end())
+            continue;
+        dependents->second.erase(_key);
+        if (dependents->second.empty())
+            m_dependencyGraph.dependents.erase(dependents);
+    }
+    return retval;
+}
+
+void IAssetManager::removeIntermediates(const std::string& _key)
+{
+    core::vector<std::string> intermediates;
+    {
+        std::unique_lock lock(m_dependencyGraph.lock);
+        for (auto it=m_dependencyGraph.intermediateOwners.begin(); it!=m_dependencyGraph.intermediateOwners.end(); )
+        {
+            if (it->second==_key)
+            {
+                intermediates.push_back(it->first);
+                it = m_dependencyGraph.intermediateOwners.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+    // not under the graph lock, removal runs the dispose functions of the caches
+    for (const auto& intermediate : intermediates)
+    {
+        auto found = findAssets(intermediate);
+        for (auto& bundle : *found)
+            removeAssetFromCache(bundle);
+    }
+}
+
+core::vector<std::string> IAssetManager::getDependentFiles(const std::string& _key) const
+{
+    std::unique_lock lock(m_dependencyGraph.lock);
+
+    auto getDependents = [&](const std::string& key) -> const core::unordered_set<std::string>*
+    {
+        auto found = m_dependencyGraph.dependents.find(key);
+        return found!=m_dependencyGraph.dependents.end() ? &found->second:nullptr;
+    };
+
+    // everything reachable through the dependents
+    core::unordered_set<std::string> affected;
+    {
+        core::vector<const std::string*> stack = {&_key};
+        while (!stack.empty())
+        {
+            const std::string* key = stack.back();
+            stack.pop_back();
+            if (auto dependents=getDependents(*key))
+            for (const auto& dependent : *dependents)
+            if (dependent!=_key && affected.insert(dependent).second)
+                stack.push_back(&dependent);
+        }
+    }
+
+    // Kahn's algorithm, only counting the dependencies which get reloaded too
+    core::unordered_map<std::string_view,uint32_t> pendingDependencies;
+    core::vector<std::string> retval;
+    retval.reserve(affected.size());
+    for (const auto& key : affected)
+    {
+        uint32_t count = 0u;
+        // files only get here by being a dependent, but the dependencies of one might not have been recorded (or already forgotten)
+        if (auto dependencies=m_dependencyGraph.dependencies.find(key); dependencies!=m_dependencyGraph.dependencies.end())
+        for (const auto& dependency : dependencies->second)
+        if (affected.contains(dependency))
+            count++;
+        if (count)
+            pendingDependencies[std::string_view(key)] = count;
+        else
+            retval.push_back(key);
+    }
+    for (size_t i=0ull; i<retval.size(); i++)
+    if (auto dependents=getDependents(retval[i]))
+    for (const auto& dependent : *dependents)
+    {
+        auto found = pendingDependencies.find(std::string_view(dependent));
+        if (found!=pendingDependencies.end() && (--found->second)==0u)
+        {
+            pendingDependencies.erase(found);
+            retval.push_back(dependent);
+        }
+    }
+    // there shouldn't be cycles, but if a loader made one, those still need a reload
+    for (const auto& cyclic : pendingDependencies)
+        retval.emplace_back(cyclic.first);
+    return retval;
+}
+
+namespace
+{
+// the references `restoreFromDummy` recurses into which can be shared with other files' assets, once per reference
+template<typename F>
+void forEachDependency(const IAsset* _asset, F&& _visit)
+{
+    switch (_asset->getAssetType())
+    {
+        case IAsset::ET_IMAGE_VIEW:
+            _visit(static_cast<const ICPUImageView*>(_asset)->getCreationParameters().image.get());
+            break;
+        case IAsset::ET_IMAGE:
+            _visit(static_cast<const ICPUImage*>(_asset)->getBuffer());
+            break;
+        case IAsset::ET_RENDERPASS_INDEPENDENT_PIPELINE:
+        {
+            const auto* pipeline = static_cast<const ICPURenderpassIndependentPipeline*>(_asset);
+            _visit(pipeline->getLayout());
+            for (uint32_t i=0u; i<ICPURenderpassIndependentPipeline::GRAPHICS_SHADER_STAGE_COUNT; i++)
+                _visit(pipeline->getSpecInfo(static_cast<ICPUShader::E_SHADER_STAGE>(0x1u<<i)).shader);
+            break;
+        }
+        case IAsset::ET_SUB_MESH:
+        {
+            const auto* meshbuffer = static_cast<const ICPUMeshBuffer*>(_asset);
+            for (uint32_t i=0u; i<ICPUMeshBuffer::MAX_ATTR_BUF_BINDING_COUNT; i++)
+                _visit(meshbuffer->getVertexBufferBindings()[i].buffer.get());
+            _visit(meshbuffer->getIndexBufferBinding().buffer.get());
+            _visit(meshbuffer->getInverseBindPoseBufferBinding().buffer.get());
+            _visit(meshbuffer->getJointAABBBufferBinding().buffer.get());
+            _visit(meshbuffer->getPipeline());
+            _visit(meshbuffer->getAttachedDescriptorSet());
+            break;
+        }
+        case IAsset::ET_MESH:
+            for (const auto* meshbuffer : static_cast<const ICPUMesh*>(_asset)->getMeshBuffers())
+                _visit(meshbuffer);
+            break;
+        default:
+            break;
+    }
+}
+}
+
+core::vector<std::string> IAssetManager::reloadAffected(const system::path& _filePath, const IAssetLoader::SAssetLoadParams& _params, IAssetLoader::IAssetLoaderOverride* _override)
+{
+    const std::string changedKey = _filePath.string();
+    core::vector<std::string> toReload = getDependentFiles(changedKey);
+    toReload.insert(toReload.begin(),changedKey);
+
+    // only the top level gets loaded anew, everything else comes from the cache, which already has the reloaded dependencies
+    IAssetLoader::SAssetLoadParams params(_params);
+    params.cacheFlags = static_cast<IAssetLoader::E_CACHING_FLAGS>(params.cacheFlags|IAssetLoader::ECF_DUPLICATE_TOP_LEVEL);
+    params.restoreLevels = 0u;
+
+    core::vector<std::string> retval;
+    retval.reserve(toReload.size());
+    for (const auto& key : toReload)
+    {
+        removeIntermediates(key);
+        const auto previousDependencies = forgetDependencies(key);
+
+        SAssetBundle reloaded;
+        {
+            // not nested in whatever the calling thread is doing
+            IAssetLoader::SLoadScope scope(nullptr);
+            reloaded = getAssetInHierarchy_impl<true>(key,params,0u,_override);
+        }
+        if (reloaded.getContents().empty())
+        {
+            _params.logger.log("Could not reload %s, the cached version stays", system::ILogger::ELL_ERROR, key.c_str());
+            IAssetLoader::SLoadScope scope(&key);
+            for (const auto& dependency : previousDependencies)
+                recordDependency(dependency);
+            continue;
+        }
+
+        bool selfContained;
+        {
+            std::unique_lock lock(m_dependencyGraph.lock);
+            selfContained = !m_dependencyGraph.dependencies.contains(key);
+        }
+
+        auto cached = findAssets(key);
+        SAssetBundle* previous = cached->size() ? cached->begin():nullptr;
+        auto canRestoreInPlace = [&]() -> bool
+        {
+            // restoring converts the whole subtree to dummies first, which must not free anything another file's assets use
+            if (!selfContained || !previous)
+                return false;
+            const auto previousContents = previous->getContents();
+            const auto reloadedContents = reloaded.getContents();
+            if (previousContents.size()!=reloadedContents.size())
+                return false;
+            for (size_t i=0ull; i<previousContents.size(); i++)
+            {
+                IAsset* asset = previousContents.begin()[i].get();
+                IAsset* reloadedAsset = reloadedContents.begin()[i].get();
+                if (asset->getAssetType()!=reloadedAsset->getAssetType() || !asset->isMutable() || !asset->canBeRestoredFrom(reloadedAsset))
+                    return false;
+            }
+            // The deduplicator shares dependencies between files, restoring one of those would swap the contents of the other files' assets too.
+            // So every dependency may only be referenced from within this subtree, and by the deduplicator keeping it as the first of its contents.
+            core::unordered_map<const IAsset*,uint32_t> subtreeReferences;
+            core::vector<const IAsset*> stack;
+            for (const auto& asset : previousContents)
+                stack.push_back(asset.get());
+            while (!stack.empty())
+            {
+                const IAsset* asset = stack.back();
+                stack.pop_back();
+                forEachDependency(asset,[&](const IAsset* dependency) -> void
+                {
+                    // walk every dependency once, but count each reference to it
+                    if (dependency && subtreeReferences[dependency]++==0u)
+                        stack.push_back(dependency);
+                });
+            }
+            for (const auto& [dependency,references] : subtreeReferences)
+            if (static_cast<uint32_t>(dependency->getReferenceCount())>references+m_deduplicator->getHeldReferenceCount(dependency))
+                return false;
+            return true;
+        };
+        if (canRestoreInPlace())
+        {
+            const auto reloadedContents = reloaded.getContents();
+            for (size_t i=0ull; i<reloadedContents.size(); i++)
+            {
+                IAsset* asset = previous->getContents().begin()[i].get();
+                asset->convertToDummyObject(~0u);
+                asset->restoreFromDummy(reloadedContents.begin()[i].get(),~0u);
+            }
+        }
+        else
+        {
+            if (previous)
+                removeAssetFromCache(*previous);
+            changeAssetKey(reloaded,key);
+            // same as if it got loaded by getAsset
+            insertAssetIntoCache(reloaded,IAsset::EM_MUTABLE);
+        }
+        retval.push_back(key);
+    }
+    return retval;
+}
+
 void IAssetManager::initializeMeshTools()
 {
 	m_meshManipulator = core::make_smart_refctd_ptr<CMeshManipulator>();
@@ -175,10 +836,12 @@ void IAssetManager::addLoadersAndWriters()
 	addAssetLoader(core::make_smart_refctd_ptr<asset::CImageLoaderTGA>());
 #endif
     addAssetLoader(core::make_smart_refctd_ptr<asset::CBufferLoaderBIN>());
+	addAssetLoader(core::make_smart_refctd_ptr<asset::CNBLLoader>(this));
 	addAssetLoader(core::make_smart_refctd_ptr<asset::CGLSLLoader>());
 	addAssetLoader(core::make_smart_refctd_ptr<asset::CHLSLLoader>());
 	addAssetLoader(core::make_smart_refctd_ptr<asset::CSPVLoader>());
 
+	addAssetWriter(core::make_smart_refctd_ptr<asset::CNBLWriter>());
 #ifdef _NBL_COMPILE_WITH_BAW_WRITER_
 	//addAssetWriter(core::make_smart_refctd_ptr<asset::CBAWMeshWriter>(getFileSystem()));
 #endif
@@ -207,7 +870,8 @@ void IAssetManager::addLoadersAndWriters()
 	addAssetWriter(core::make_smart_refctd_ptr<asset::CGLIWriter>(core::smart_refctd_ptr<system::ISystem>(m_system)));
 #endif
 
-    for (auto& loader : m_loaders.vector)
+    const SRegistryReader registry(this);
+    for (auto& loader : registry->loaders)
         loader->initialize();
 }
 
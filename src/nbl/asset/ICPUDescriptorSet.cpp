@@ -42,7 +42,7 @@ std::span<const ICPUDescriptorSet::SDescriptorInfo> ICPUDescriptorSet::getDescri
 	return { infosBegin, count };
 }
 
-core::smart_refctd_ptr<IAsset> ICPUDescriptorSet::clone(uint32_t _depth) const
+core::smart_refctd_ptr<IAsset> ICPUDescriptorSet::clone_impl(uint32_t _depth) const
 {
 	auto layout = (_depth > 0u && m_layout) ? core::smart_refctd_ptr_static_cast<ICPUDescriptorSetLayout>(m_layout->clone(_depth - 1u)) : m_layout;
 	auto cp = core::make_smart_refctd_ptr<ICPUDescriptorSet>(std::move(layout));
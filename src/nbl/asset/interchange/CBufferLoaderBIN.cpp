@@ -3,6 +3,8 @@
 // For conditions of distribution and use, see copyright notice in nabla.h
 #include "CBufferLoaderBIN.h"
 
+#include "nbl/asset/CFileBackedCPUBuffer.h"
+
 using namespace nbl;
 using namespace nbl::asset;
 
@@ -11,6 +13,9 @@ asset::SAssetBundle CBufferLoaderBIN::loadAsset(system::IFile* _file, const asse
 	if (!_file)
 		return {};
 
+	if (_params.loaderFlags&IAssetLoader::ELPF_LAZY_BUFFERS)
+		return SAssetBundle(nullptr,{core::make_smart_refctd_ptr<CFileBackedCPUBuffer>(core::smart_refctd_ptr<system::IFile>(_file),0ull,_file->getSize())});
+
 	SContext ctx(_file->getSize());
 	ctx.file = _file;
 
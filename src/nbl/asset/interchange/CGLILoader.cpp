@@ -249,38 +249,41 @@ namespace nbl
 		}
 
 		bool CGLILoader::isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const
+		{
+			std::array<uint8_t,SniffedHeaderSize> headerStorage;
+			return isALoadableFileHeader(_file, sniffHeader(_file,headerStorage), logger);
+		}
+
+		bool CGLILoader::isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger) const
 		{
 			const auto fileName = std::string(_file->getFileName().string());
 
-			constexpr auto ddsMagic = 0x20534444;
+			constexpr std::array<uint8_t, 4> ddsMagic = { 0x44, 0x44, 0x53, 0x20 };
 			constexpr std::array<uint8_t, 12> ktxMagic = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
 			constexpr std::array<uint8_t, 16> kmgMagic = { 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55 };
+			auto startsWith = [&_header](const auto& magic) -> bool
+			{
+				return _header.size()>=magic.size() && std::equal(magic.begin(),magic.end(),_header.begin());
+			};
 
 			// TODO: try to read the headers regardless of extension
-			system::IFile::success_t success;
 			if (fileName.rfind(".dds") != std::string::npos)
 			{
-				std::remove_const<decltype(ddsMagic)>::type tmpBuffer;
-				_file->read(success, &tmpBuffer, 0, sizeof(ddsMagic));
-				if (success && *reinterpret_cast<decltype(ddsMagic)*>(&tmpBuffer) == ddsMagic)
+				if (startsWith(ddsMagic))
 					return true;
 				else
 					logger.log("LOAD GLI: Invalid (non-DDS) file!", system::ILogger::ELL_ERROR);
 			}
 			else if (fileName.rfind(".kmg") != std::string::npos)
 			{
-				std::remove_const<decltype(kmgMagic)>::type tmpBuffer;
-				_file->read(success, tmpBuffer.data(), 0, sizeof(kmgMagic[0]) * kmgMagic.size());
-				if (success && tmpBuffer==kmgMagic)
+				if (startsWith(kmgMagic))
 					return true;
 				else
 					logger.log("LOAD GLI: Invalid (non-KMG) file!", system::ILogger::ELL_ERROR);
 			}
 			else if (fileName.rfind(".ktx") != std::string::npos)
 			{
-				std::remove_const<decltype(ktxMagic)>::type tmpBuffer;
-				_file->read(success, tmpBuffer.data(), 0, sizeof(ktxMagic[0]) * ktxMagic.size());
-				if (success && tmpBuffer==ktxMagic)
+				if (startsWith(ktxMagic))
 					return true;
 				else
 					logger.log("LOAD GLI: Invalid (non-KTX) file!", system::ILogger::ELL_ERROR);
@@ -27,6 +27,7 @@ class CGLILoader final : public asset::IAssetLoader
 		explicit CGLILoader() = default;
 
 		bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override;
+		bool isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger) const override;
 
 		const char** getAssociatedFileExtensions() const override
 		{
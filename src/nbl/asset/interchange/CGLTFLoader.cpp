@@ -674,7 +674,7 @@ using namespace nbl::asset;
 							return bufferViewOffset + relativeAccessorOffset;
 						}();
 
-						auto* inData = reinterpret_cast<core::matrix4SIMD*>(reinterpret_cast<uint8_t*>(cpuBuffer->getPointer()) + globalIBPOffset); //! glTF stores 4x4 IBP column_major matrices
+						auto* inData = reinterpret_cast<const core::matrix4SIMD*>(cpuBuffer->getPointer(globalIBPOffset, sizeof(core::matrix4SIMD)*jointCount)); //! glTF stores 4x4 IBP column_major matrices
 						for (uint32_t j=0u; j<jointCount; ++j)
 							inverseBindPoseIt[j] = core::transpose(inData[j]).extractSub3x4();
 					}
@@ -942,8 +942,8 @@ using namespace nbl::asset;
 									overrideRef.bufferRange.offset = globalOffset;
 									overrideRef.bufferRange.size = overrideRef.accessor->count.value() * asset::getTexelOrBlockBytesize(overrideRef.format);
 
-									auto* bufferData = reinterpret_cast<uint8_t*>(overrideRef.bufferRange.buffer->getPointer());
-									overrideRef.data = bufferData + overrideRef.bufferRange.offset;
+									// only what's read, the buffer could be read from the file on demand
+									overrideRef.data = overrideRef.bufferRange.buffer->getPointer(overrideRef.bufferRange.offset, overrideRef.bufferRange.size);
 								}
 							}
 
@@ -1013,8 +1013,8 @@ using namespace nbl::asset;
 									overrideRef.bufferRange.offset = globalOffset;
 									overrideRef.bufferRange.size = overrideRef.accessor->count.value() * asset::getTexelOrBlockBytesize(overrideRef.format);
 
-									auto* bufferData = reinterpret_cast<uint8_t*>(overrideRef.bufferRange.buffer->getPointer());
-									overrideRef.data = bufferData + overrideRef.bufferRange.offset;
+									// only what's read, the buffer could be read from the file on demand
+									overrideRef.data = overrideRef.bufferRange.buffer->getPointer(overrideRef.bufferRange.offset, overrideRef.bufferRange.size);
 								}
 							}
 
@@ -160,7 +160,7 @@ SAssetBundle CGraphicsPipelineLoaderMTL::loadAsset(system::IFile* _file, const I
     constexpr uint32_t PIPELINE_PERMUTATION_COUNT = 2u;
     const auto pipelineCount = materials.size()*PIPELINE_PERMUTATION_COUNT;
 
-    auto retval = core::make_refctd_dynamic_array<SAssetBundle::contents_container_t>(pipelineCount);
+    SAssetBundle::contents_container_t retval(pipelineCount);
     auto meta = core::make_smart_refctd_ptr<CMTLMetadata>(pipelineCount,core::smart_refctd_ptr(m_basicViewParamsSemantics));
     uint32_t offset = 0u;
     for (auto& material : materials)
@@ -186,7 +186,7 @@ SAssetBundle CGraphicsPipelineLoaderMTL::loadAsset(system::IFile* _file, const I
                 }
             }
             meta->placeMeta(offset,ppln.get(),std::move(ds3),material.params,std::string(material.name),hash);
-            retval->operator[](offset) = std::move(ppln);
+            retval[offset] = std::move(ppln);
             offset++;
         };
         createPplnDescAndMeta(false);
@@ -550,22 +550,31 @@ CGraphicsPipelineLoaderMTL::image_views_set_t CGraphicsPipelineLoaderMTL::loadIm
     images_set_t images;
     image_views_set_t views;
 
-    for (uint32_t i = 0u; i < images.size(); ++i)
+    // all the maps of a material are independent files, so load them at once
+    std::array<SAssetBundle,CMTLMetadata::CRenderpassIndependentPipeline::EMP_COUNT> bundles;
+    interm_loadInParallel(images.size(),[&](const uint32_t i) -> void
     {
         SAssetLoadParams lp = _ctx.inner.params;
         if (_mtl.maps[i].size() )
         {
             const uint32_t hierarchyLevel = _ctx.topHierarchyLevel + ICPURenderpassIndependentPipeline::IMAGE_HIERARCHYLEVELS_BELOW; // this is weird actually, we're not sure if we're loading image or image view
-            SAssetBundle bundle;
             if (i != CMTLMetadata::CRenderpassIndependentPipeline::EMP_BUMP)
-                bundle = interm_getAssetInHierarchy(m_assetMgr, _mtl.maps[i], lp, hierarchyLevel, _ctx.loaderOverride);
+                bundles[i] = interm_getAssetInHierarchy(m_assetMgr, _mtl.maps[i], lp, hierarchyLevel, _ctx.loaderOverride);
             else // TODO: you should attempt to get derivative map FIRST, then restore and regenerate! (right now you're always restoring!)
             {
                 // we need bumpmap restored to create derivative map from it
                 const uint32_t restoreLevels = 3u; // 2 in case of image (image, texel buffer) and 3 in case of image view (view, image, texel buffer)
                 lp.restoreLevels = std::max(lp.restoreLevels, hierarchyLevel + restoreLevels);
-                bundle = interm_getAssetInHierarchy(m_assetMgr, _mtl.maps[i], lp, hierarchyLevel, _ctx.loaderOverride);
+                bundles[i] = interm_getAssetInHierarchy(m_assetMgr, _mtl.maps[i], lp, hierarchyLevel, _ctx.loaderOverride);
             }
+        }
+    });
+
+    for (uint32_t i = 0u; i < images.size(); ++i)
+    {
+        if (_mtl.maps[i].size() )
+        {
+            const SAssetBundle& bundle = bundles[i];
             auto asset = _ctx.loaderOverride->chooseDefaultAsset(bundle,_ctx.inner);
             if (asset)
             switch (bundle.getAssetType())
@@ -17,6 +17,7 @@
 #include "nbl/asset/interchange/IImageAssetHandlerBase.h"
 
 #include <string>
+#include <cstring>
 
 #include <stdio.h> // required for jpeglib.h
 #ifdef _NBL_COMPILE_WITH_LIBJPEG_
@@ -148,18 +149,23 @@ namespace jpeg
 #endif // _NBL_COMPILE_WITH_LIBJPEG_
 
 //! returns true if the file maybe is able to be loaded by this class
-bool CImageLoaderJPG::isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr) const
+bool CImageLoaderJPG::isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const
+{
+	std::array<uint8_t,SniffedHeaderSize> headerStorage;
+	return isALoadableFileHeader(_file, sniffHeader(_file,headerStorage), logger);
+}
+
+bool CImageLoaderJPG::isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr) const
 {
 #ifndef _NBL_COMPILE_WITH_LIBJPEG_
 	return false;
 #else
-	if (!_file)
+	if (_header.size()<6u+sizeof(uint32_t))
 		return false;
 
-	uint32_t header = 0;	
-	system::IFile::success_t success;
-	_file->read(success, &header, 6, sizeof(uint32_t));
-	return success && ((header&0x00FFD8FFu)==0x00FFD8FFu || header == 0x4a464946 || header == 0x4649464a || header == 0x66697845u || header == 0x70747468u); // maybe 0x4a464946 can go
+	uint32_t header = 0;
+	memcpy(&header, _header.data()+6, sizeof(uint32_t));
+	return ((header&0x00FFD8FFu)==0x00FFD8FFu || header == 0x4a464946 || header == 0x4649464a || header == 0x66697845u || header == 0x70747468u); // maybe 0x4a464946 can go
 #endif
 }
 
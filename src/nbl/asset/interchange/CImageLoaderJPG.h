@@ -37,6 +37,15 @@ private:
 	    CImageLoaderJPG();
 
         virtual bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override;
+        virtual bool isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger) const override;
+
+        virtual std::span<const SMagicNumber> getMagicNumbers() const override
+        {
+            // start of image marker followed by the first marker
+            static const uint8_t soi[] = { 0xffu, 0xd8u, 0xffu };
+            static const SMagicNumber magicNumbers[] = { {0ull, soi} };
+            return magicNumbers;
+        }
 
         virtual const char** getAssociatedFileExtensions() const override
         {
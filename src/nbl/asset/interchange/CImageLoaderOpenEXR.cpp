@@ -392,17 +392,23 @@ SAssetBundle CImageLoaderOpenEXR::loadAsset(system::IFile* _file, const asset::I
 	return SAssetBundle(std::move(meta),std::move(images));
 }
 
-bool isImfMagic(char* b)
+std::span<const IAssetLoader::SMagicNumber> CImageLoaderOpenEXR::getMagicNumbers() const
 {
-	return b[0] == 0x76 && b[1] == 0x2f && b[2] == 0x31 && b[3] == 0x01;
+	static const uint8_t imfMagic[] = { 0x76u, 0x2fu, 0x31u, 0x01u };
+	static_assert(sizeof(imfMagic)==sizeof(SContext::magicNumber));
+	static const SMagicNumber magicNumbers[] = { {0ull, imfMagic} };
+	return magicNumbers;
 }
 
 bool CImageLoaderOpenEXR::isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const
-{	
-	char magicNumberBuffer[sizeof(SContext::magicNumber)];
-	system::IFile::success_t success;
-	_file->read(success, magicNumberBuffer, 0, sizeof(SContext::magicNumber));
-	return success && isImfMagic(magicNumberBuffer);
+{
+	std::array<uint8_t,SniffedHeaderSize> headerStorage;
+	return isALoadableFileHeader(_file, sniffHeader(_file,headerStorage), logger);
+}
+
+bool CImageLoaderOpenEXR::isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger) const
+{
+	return getMagicNumbers().front().matches(_header);
 }
 
 template<typename rgbaFormat>
@@ -26,6 +26,9 @@ class CImageLoaderOpenEXR final : public IImageLoader
 		CImageLoaderOpenEXR(IAssetManager* _manager) : m_manager(_manager) {}
 
 		bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override;
+		bool isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger) const override;
+
+		std::span<const SMagicNumber> getMagicNumbers() const override;
 
 		const char** getAssociatedFileExtensions() const override
 		{
@@ -75,22 +75,19 @@ void PNGAPI user_read_data_fcn(png_structp png_pt, png_bytep data, png_size_t le
 
 //! returns true if the file maybe is able to be loaded by this class
 bool CImageLoaderPng::isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const
+{
+	std::array<uint8_t,SniffedHeaderSize> headerStorage;
+	return isALoadableFileHeader(_file, sniffHeader(_file,headerStorage), logger);
+}
+
+bool CImageLoaderPng::isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger) const
 {
 #ifdef _NBL_COMPILE_WITH_LIBPNG_
-	if (!_file)
+	if (_header.size()<8u)
 		return false;
 
-
-	png_byte buffer[8];
-
-	// Read the first few bytes of the PNG _file
-	system::IFile::success_t success;
-	_file->read(success, buffer, 0, sizeof(buffer));
-    if (!success)
-        return false;
-    
 	// Check if it really is a PNG _file
-	return !png_sig_cmp(buffer, 0, 8);
+	return !png_sig_cmp(_header.data(), 0, 8);
 #else
 	return false;
 #endif // _NBL_COMPILE_WITH_LIBPNG_
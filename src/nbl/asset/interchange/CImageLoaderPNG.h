@@ -34,6 +34,14 @@ public:
     };
     explicit CImageLoaderPng() {}
     virtual bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override;
+    virtual bool isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger) const override;
+
+    virtual std::span<const SMagicNumber> getMagicNumbers() const override
+    {
+        static const uint8_t signature[] = { 0x89u, 'P', 'N', 'G', '\r', '\n', 0x1au, '\n' };
+        static const SMagicNumber magicNumbers[] = { {0ull, signature} };
+        return magicNumbers;
+    }
 
     virtual const char** getAssociatedFileExtensions() const override
     {
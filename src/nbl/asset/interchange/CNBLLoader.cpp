@@ -0,0 +1,498 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/system/ISystem.h"
+#include "nbl/system/IFile.h"
+
+#include "nbl/asset/IAssetManager.h"
+#include "nbl/asset/CFileBackedCPUBuffer.h"
+#include "nbl/asset/ICPUImage.h"
+#include "nbl/asset/ICPUMesh.h"
+#include "nbl/asset/ICPUSkeleton.h"
+#include "nbl/asset/ICPUAnimationLibrary.h"
+
+#include "CNBLLoader.h"
+
+#include <cstring>
+
+using namespace nbl;
+using namespace nbl::asset;
+
+namespace
+{
+// keeps whatever owns the memory (the mapped file or the copy of it) alive for as long as a buffer points into it
+struct SAliasingAllocator
+{
+	using value_type = uint8_t;
+	using pointer = uint8_t*;
+
+	inline void deallocate(pointer, size_t)
+	{
+		owner = nullptr;
+	}
+
+	core::smart_refctd_ptr<core::IReferenceCounted> owner;
+};
+using CAliasingCPUBuffer = CCustomAllocatorCPUBuffer<SAliasingAllocator,true>;
+
+// the container has no shaders, `ICPURenderpassIndependentPipeline::create` wants some, so we only get the fixed function state and an empty layout
+class CNBLPipeline final : public ICPURenderpassIndependentPipeline
+{
+	public:
+		inline CNBLPipeline(const SCachedCreationParams& params)
+			: ICPURenderpassIndependentPipeline(core::make_smart_refctd_ptr<ICPUPipelineLayout>(std::span<const SPushConstantRange>(),nullptr,nullptr,nullptr,nullptr),params) {}
+};
+
+inline bool isInRange(const uint64_t offset, const uint64_t size, const uint64_t rangeSize)
+{
+	return offset<=rangeSize && size<=rangeSize-offset;
+}
+
+inline core::aabbox3df fromAABB(const SNBLFormat::SAABB& box)
+{
+	return core::aabbox3df(box.minEdge[0],box.minEdge[1],box.minEdge[2],box.maxEdge[0],box.maxEdge[1],box.maxEdge[2]);
+}
+}
+
+struct CNBLLoader::SContext
+{
+	// the whole file, null when only the records got read and the buffers read their contents themselves
+	const uint8_t* data;
+	uint64_t size;
+	core::smart_refctd_ptr<core::IReferenceCounted> owner;
+	core::smart_refctd_ptr<system::IFile> file;
+	const SNBLFormat::SObject* objects;
+	// one per object, where its record is in memory
+	core::vector<const uint8_t*> records;
+	// one per object, same order
+	core::vector<core::smart_refctd_ptr<IAsset>> assets;
+
+	// the object table has been validated, so the object itself is within the file
+	template<typename Record>
+	inline const Record* getRecord(const uint32_t ix) const
+	{
+		if (objects[ix].size<sizeof(Record))
+			return nullptr;
+		return reinterpret_cast<const Record*>(records[ix]);
+	}
+	template<typename Record>
+	inline std::span<const uint8_t> getTail(const uint32_t ix) const
+	{
+		return {records[ix]+sizeof(Record),objects[ix].size-sizeof(Record)};
+	}
+
+	// objects can only reference the ones before them
+	template<class AssetType>
+	inline core::smart_refctd_ptr<AssetType> getObject(const uint32_t ix, const uint32_t referencer) const
+	{
+		if (ix>=referencer || assets[ix]->getAssetType()!=AssetType::AssetType)
+			return nullptr;
+		return core::smart_refctd_ptr_static_cast<AssetType>(assets[ix]);
+	}
+	inline bool getBinding(SBufferBinding<ICPUBuffer>& out, const SNBLFormat::SBinding& binding, const uint32_t referencer) const
+	{
+		out = {};
+		if (binding.object==SNBLFormat::InvalidObject)
+			return true;
+		out.offset = binding.offset;
+		out.buffer = getObject<ICPUBuffer>(binding.object,referencer);
+		return out.buffer && binding.offset<=out.buffer->getSize();
+	}
+	// `count` null terminated strings packed one after the other
+	static inline bool getStrings(std::span<const uint8_t> tail, const uint32_t count, core::vector<const char*>& out)
+	{
+		out.resize(count);
+		for (auto& str : out)
+		{
+			const auto* end = reinterpret_cast<const uint8_t*>(memchr(tail.data(),0,tail.size()));
+			if (!end)
+				return false;
+			str = reinterpret_cast<const char*>(tail.data());
+			tail = tail.subspan(end-tail.data()+1ull);
+		}
+		return true;
+	}
+
+	core::smart_refctd_ptr<IAsset> loadBuffer(const uint32_t ix)
+	{
+		const auto* record = getRecord<SNBLFormat::SBuffer>(ix);
+		if (!record || record->dataOffset%SNBLFormat::BlobAlignment || !isInRange(record->dataOffset,record->size,size))
+			return nullptr;
+		core::smart_refctd_ptr<ICPUBuffer> buffer;
+		if (data)
+		{
+			// const cast is fine, buffers aliasing a read-only mapping get made immutable at the end
+			auto* blob = const_cast<uint8_t*>(data+record->dataOffset);
+			buffer = core::make_smart_refctd_ptr<CAliasingCPUBuffer>(record->size,blob,core::adopt_memory,SAliasingAllocator{owner});
+		}
+		else
+			buffer = core::make_smart_refctd_ptr<CFileBackedCPUBuffer>(core::smart_refctd_ptr(file),record->dataOffset,record->size);
+		buffer->setUsageFlags(static_cast<IBuffer::E_USAGE_FLAGS>(record->usage));
+		return buffer;
+	}
+
+	core::smart_refctd_ptr<IAsset> loadImage(const uint32_t ix)
+	{
+		const auto* record = getRecord<SNBLFormat::SImage>(ix);
+		if (!record || getTail<SNBLFormat::SImage>(ix).size()<record->regionCount*sizeof(SNBLFormat::SRegion))
+			return nullptr;
+
+		ICPUImage::SCreationParams params = {};
+		params.type = static_cast<IImage::E_TYPE>(record->type);
+		params.samples = static_cast<IImage::E_SAMPLE_COUNT_FLAGS>(record->samples);
+		params.format = static_cast<E_FORMAT>(record->format);
+		params.extent = {record->extent[0],record->extent[1],record->extent[2]};
+		params.mipLevels = record->mipLevels;
+		params.arrayLayers = record->arrayLayers;
+		params.flags = static_cast<IImage::E_CREATE_FLAGS>(record->flags);
+		params.usage = static_cast<IImage::E_USAGE_FLAGS>(record->usage);
+		params.stencilUsage = static_cast<IImage::E_USAGE_FLAGS>(record->stencilUsage);
+		for (uint32_t f=0u; f<EF_COUNT; f++)
+			params.viewFormats.set(f,(record->viewFormats[f/64u]>>(f%64u))&0x1ull);
+		auto image = ICPUImage::create(params);
+		if (!image)
+			return nullptr;
+
+		if (record->buffer==SNBLFormat::InvalidObject)
+			return image;
+		auto buffer = getObject<ICPUBuffer>(record->buffer,ix);
+		if (!buffer)
+			return nullptr;
+		auto regions = core::make_refctd_dynamic_array<core::smart_refctd_dynamic_array<IImage::SBufferCopy>>(record->regionCount);
+		const auto* inRegion = reinterpret_cast<const SNBLFormat::SRegion*>(record+1);
+		for (auto& region : *regions)
+		{
+			region.bufferOffset = inRegion->bufferOffset;
+			region.bufferRowLength = inRegion->bufferRowLength;
+			region.bufferImageHeight = inRegion->bufferImageHeight;
+			region.imageSubresource.aspectMask = static_cast<IImage::E_ASPECT_FLAGS>(inRegion->aspectMask);
+			region.imageSubresource.mipLevel = inRegion->mipLevel;
+			region.imageSubresource.baseArrayLayer = inRegion->baseArrayLayer;
+			region.imageSubresource.layerCount = inRegion->layerCount;
+			region.imageOffset = {inRegion->imageOffset[0],inRegion->imageOffset[1],inRegion->imageOffset[2]};
+			region.imageExtent = {inRegion->imageExtent[0],inRegion->imageExtent[1],inRegion->imageExtent[2]};
+			inRegion++;
+		}
+		if (!image->setBufferAndRegions(std::move(buffer),regions))
+			return nullptr;
+		return image;
+	}
+
+	core::smart_refctd_ptr<IAsset> loadPipeline(const uint32_t ix)
+	{
+		const auto* record = getRecord<SNBLFormat::SPipeline>(ix);
+		if (!record)
+			return nullptr;
+		return core::make_smart_refctd_ptr<CNBLPipeline>(SNBLFormat::fromRecord(*record));
+	}
+
+	core::smart_refctd_ptr<IAsset> loadMeshBuffer(const uint32_t ix)
+	{
+		const auto* record = getRecord<SNBLFormat::SMeshBuffer>(ix);
+		if (!record)
+			return nullptr;
+
+		auto meshbuffer = core::make_smart_refctd_ptr<ICPUMeshBuffer>();
+		if (record->pipeline!=SNBLFormat::InvalidObject)
+		{
+			auto pipeline = getObject<ICPURenderpassIndependentPipeline>(record->pipeline,ix);
+			if (!pipeline)
+				return nullptr;
+			meshbuffer->setPipeline(std::move(pipeline));
+		}
+		SBufferBinding<ICPUBuffer> binding;
+		for (uint32_t i=0u; i<ICPUMeshBuffer::MAX_ATTR_BUF_BINDING_COUNT; i++)
+		{
+			if (!getBinding(binding,record->vertexBindings[i],ix))
+				return nullptr;
+			if (binding.buffer)
+				meshbuffer->setVertexBufferBinding(std::move(binding),i);
+		}
+		if (!getBinding(binding,record->indexBinding,ix))
+			return nullptr;
+		if (binding.buffer)
+			meshbuffer->setIndexBufferBinding(std::move(binding));
+		if (record->jointCount)
+		{
+			SBufferBinding<ICPUBuffer> jointAABBBinding;
+			if (!getBinding(binding,record->inverseBindPoseBinding,ix) || !getBinding(jointAABBBinding,record->jointAABBBinding,ix))
+				return nullptr;
+			if (!meshbuffer->setSkin(std::move(binding),std::move(jointAABBBinding),record->jointCount,record->maxJointsPerVertex))
+				return nullptr;
+		}
+
+		meshbuffer->setIndexType(static_cast<E_INDEX_TYPE>(record->indexType));
+		meshbuffer->setIndexCount(record->indexCount);
+		meshbuffer->setInstanceCount(record->instanceCount);
+		meshbuffer->setBaseInstance(record->baseInstance);
+		meshbuffer->setBaseVertex(record->baseVertex);
+		meshbuffer->setPositionAttributeIx(record->positionAttribute);
+		meshbuffer->setNormalAttributeIx(record->normalAttribute);
+		meshbuffer->setJointIDAttributeIx(record->jointIDAttribute);
+		meshbuffer->setJointWeightAttributeIx(record->jointWeightAttribute);
+		meshbuffer->setBoundingBox(fromAABB(record->boundingBox));
+		memcpy(meshbuffer->getPushConstantsDataPtr(),record->pushConstants,sizeof(record->pushConstants));
+		return meshbuffer;
+	}
+
+	core::smart_refctd_ptr<IAsset> loadMesh(const uint32_t ix)
+	{
+		const auto* record = getRecord<SNBLFormat::SMesh>(ix);
+		if (!record || getTail<SNBLFormat::SMesh>(ix).size()<record->meshBufferCount*sizeof(uint32_t))
+			return nullptr;
+
+		auto mesh = core::make_smart_refctd_ptr<ICPUMesh>();
+		auto& meshbuffers = mesh->getMeshBufferVector();
+		const auto* meshbufferIx = reinterpret_cast<const uint32_t*>(record+1);
+		for (uint32_t i=0u; i<record->meshBufferCount; i++)
+		{
+			auto meshbuffer = getObject<ICPUMeshBuffer>(meshbufferIx[i],ix);
+			if (!meshbuffer)
+				return nullptr;
+			meshbuffers.push_back(std::move(meshbuffer));
+		}
+		mesh->setBoundingBox(fromAABB(record->boundingBox));
+		return mesh;
+	}
+
+	core::smart_refctd_ptr<IAsset> loadSkeleton(const uint32_t ix)
+	{
+		const auto* record = getRecord<SNBLFormat::SSkeleton>(ix);
+		core::vector<const char*> names;
+		if (!record || !getStrings(getTail<SNBLFormat::SSkeleton>(ix),record->jointCount,names))
+			return nullptr;
+
+		SBufferBinding<ICPUBuffer> parentJointIDs,defaultTransforms;
+		if (!getBinding(parentJointIDs,record->parentJointIDs,ix) || !getBinding(defaultTransforms,record->defaultTransforms,ix))
+			return nullptr;
+		// the constructor asserts on these
+		if (record->jointCount)
+		{
+			if (!parentJointIDs.buffer || !isInRange(parentJointIDs.offset,sizeof(ICPUSkeleton::joint_id_t)*record->jointCount,parentJointIDs.buffer->getSize()))
+				return nullptr;
+			if (!defaultTransforms.buffer || !isInRange(defaultTransforms.offset,sizeof(core::matrix3x4SIMD)*record->jointCount,defaultTransforms.buffer->getSize()))
+				return nullptr;
+		}
+		return core::make_smart_refctd_ptr<ICPUSkeleton>(std::move(parentJointIDs),std::move(defaultTransforms),names.begin(),names.end());
+	}
+
+	core::smart_refctd_ptr<IAsset> loadAnimationLibrary(const uint32_t ix)
+	{
+		const auto* record = getRecord<SNBLFormat::SAnimationLibrary>(ix);
+		if (!record)
+			return nullptr;
+		const auto tail = getTail<SNBLFormat::SAnimationLibrary>(ix);
+		const size_t offsetsSize = record->nameCount*sizeof(uint32_t);
+		core::vector<const char*> names;
+		if (tail.size()<offsetsSize || !getStrings(tail.subspan(offsetsSize),record->nameCount,names))
+			return nullptr;
+
+		SBufferBinding<ICPUBuffer> keyframes,timestamps,animationBinding;
+		if (!getBinding(keyframes,record->keyframes,ix) || !getBinding(timestamps,record->timestamps,ix))
+			return nullptr;
+		// the constructor asserts on these
+		if (!keyframes.buffer || !isInRange(keyframes.offset,sizeof(ICPUAnimationLibrary::Keyframe)*record->keyframeCount,keyframes.buffer->getSize()))
+			return nullptr;
+		if (!timestamps.buffer || !isInRange(timestamps.offset,sizeof(ICPUAnimationLibrary::timestamp_t)*record->keyframeCount,timestamps.buffer->getSize()))
+			return nullptr;
+		const SNBLFormat::SBinding animationRecordBinding = {record->animations.object,0u,record->animations.offset};
+		if (!getBinding(animationBinding,animationRecordBinding,ix))
+			return nullptr;
+		SBufferRange<ICPUBuffer> animations = {animationBinding.offset,record->animations.size,std::move(animationBinding.buffer)};
+
+		auto library = core::make_smart_refctd_ptr<ICPUAnimationLibrary>(std::move(keyframes),std::move(timestamps),record->keyframeCount,std::move(animations));
+		library->addAnimationNames(names.begin(),names.end(),reinterpret_cast<const uint32_t*>(tail.data()));
+		return library;
+	}
+};
+
+bool CNBLLoader::isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger) const
+{
+	if (_header.size()<sizeof(SNBLFormat::SHeader) || !getMagicNumbers().front().matches(_header))
+		return false;
+
+	SNBLFormat::SHeader header;
+	memcpy(&header,_header.data(),sizeof(header));
+	if (header.version!=SNBLFormat::Version)
+	{
+		logger.log("NBL container %s has version %u, only version %u is supported", system::ILogger::ELL_ERROR, _file->getFileName().string().c_str(), header.version, SNBLFormat::Version);
+		return false;
+	}
+	return true;
+}
+
+SAssetBundle CNBLLoader::loadAsset(system::IFile* _file, const IAssetLoader::SAssetLoadParams& _params, IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
+{
+	if (!_file)
+		return {};
+	const auto& logger = _params.logger;
+	const std::string filename = _file->getFileName().string();
+
+	SContext ctx = {};
+	ctx.size = _file->getSize();
+	auto getMapping = [](const system::IFile* file) -> const uint8_t*
+	{
+		return reinterpret_cast<const uint8_t*>(file->getMappedPointer());
+	};
+	if ((ctx.data=getMapping(_file)))
+		ctx.owner = core::smart_refctd_ptr<system::IFile>(_file);
+	else
+	{
+		// the asset manager doesn't open files for mapping, so try to get a mapping of our own
+		system::ISystem::future_t<core::smart_refctd_ptr<system::IFile>> future;
+		m_manager->getSystem()->createFile(future,_file->getFileName(),core::bitflag<system::IFileBase::E_CREATE_FLAGS>(system::IFileBase::ECF_READ)|system::IFileBase::ECF_MAPPABLE);
+		core::smart_refctd_ptr<system::IFile> mappedFile;
+		if (future.wait())
+			mappedFile = future.copy();
+		if (mappedFile && mappedFile->getSize()==ctx.size && (ctx.data=getMapping(mappedFile.get())))
+			ctx.owner = std::move(mappedFile);
+	}
+	const bool readOnlyMapping = ctx.data;
+	// the mapping gets paged in on demand by the OS already, so the buffers only read the file themselves when there's none
+	if (!readOnlyMapping && (_params.loaderFlags&IAssetLoader::ELPF_LAZY_BUFFERS))
+		ctx.file = core::smart_refctd_ptr<system::IFile>(_file);
+	else if (!readOnlyMapping)
+	{
+		auto copy = core::make_smart_refctd_ptr<ICPUBuffer>(ctx.size);
+		system::IFile::success_t success;
+		_file->read(success,copy->getPointer(),0ull,ctx.size);
+		if (!success)
+		{
+			logger.log("LOAD NBL: could not read %s", system::ILogger::ELL_ERROR, filename.c_str());
+			return {};
+		}
+		ctx.data = reinterpret_cast<const uint8_t*>(copy->getPointer());
+		ctx.owner = std::move(copy);
+	}
+
+	// from the file in memory, or straight from the file
+	auto readBytes = [&](void* dst, const uint64_t offset, const uint64_t size) -> bool
+	{
+		if (ctx.data)
+		{
+			memcpy(dst,ctx.data+offset,size);
+			return true;
+		}
+		system::IFile::success_t success;
+		_file->read(success,dst,offset,size);
+		return bool(success);
+	};
+
+	SNBLFormat::SHeader header;
+	if (ctx.size<sizeof(header) || !readBytes(&header,0ull,sizeof(header)) || !isALoadableFileHeader(_file,{reinterpret_cast<const uint8_t*>(&header),sizeof(header)},logger))
+		return {};
+	const bool validTables = header.fileSize<=ctx.size && header.objectTableOffset%alignof(uint64_t)==0ull &&
+		isInRange(header.objectTableOffset,header.objectCount*sizeof(SNBLFormat::SObject),ctx.size) &&
+		isInRange(header.rootTableOffset,header.rootCount*sizeof(uint32_t),ctx.size) && header.rootCount;
+	if (!validTables)
+	{
+		logger.log("LOAD NBL: %s is truncated or corrupt", system::ILogger::ELL_ERROR, filename.c_str());
+		return {};
+	}
+
+	// the records only get copied when the file isn't in memory
+	core::vector<SNBLFormat::SObject> objectTable;
+	core::vector<uint32_t> rootTable;
+	core::vector<uint64_t> recordStorage;
+	const uint32_t* rootIx;
+	auto isValidObject = [&](const SNBLFormat::SObject& object) -> bool
+	{
+		return object.offset%alignof(uint64_t)==0ull && isInRange(object.offset,object.size,ctx.size);
+	};
+	if (ctx.data)
+	{
+		ctx.objects = reinterpret_cast<const SNBLFormat::SObject*>(ctx.data+header.objectTableOffset);
+		rootIx = reinterpret_cast<const uint32_t*>(ctx.data+header.rootTableOffset);
+	}
+	else
+	{
+		objectTable.resize(header.objectCount);
+		rootTable.resize(header.rootCount);
+		if (!readBytes(objectTable.data(),header.objectTableOffset,objectTable.size()*sizeof(SNBLFormat::SObject)) || !readBytes(rootTable.data(),header.rootTableOffset,rootTable.size()*sizeof(uint32_t)))
+		{
+			logger.log("LOAD NBL: could not read %s", system::ILogger::ELL_ERROR, filename.c_str());
+			return {};
+		}
+		ctx.objects = objectTable.data();
+		rootIx = rootTable.data();
+
+		size_t recordWords = 0ull;
+		for (const auto& object : objectTable)
+		if (isValidObject(object))
+			recordWords += (object.size+sizeof(uint64_t)-1ull)/sizeof(uint64_t);
+		recordStorage.resize(recordWords);
+	}
+
+	ctx.records.resize(header.objectCount,nullptr);
+	ctx.assets.resize(header.objectCount);
+	uint64_t* nextRecord = recordStorage.data();
+	for (uint32_t i=0u; i<header.objectCount; i++)
+	{
+		const auto& object = ctx.objects[i];
+		if (isValidObject(object))
+		{
+			if (ctx.data)
+				ctx.records[i] = ctx.data+object.offset;
+			else if (readBytes(nextRecord,object.offset,object.size))
+			{
+				ctx.records[i] = reinterpret_cast<const uint8_t*>(nextRecord);
+				nextRecord += (object.size+sizeof(uint64_t)-1ull)/sizeof(uint64_t);
+			}
+		}
+		if (ctx.records[i])
+		switch (object.type)
+		{
+			case IAsset::ET_BUFFER:
+				ctx.assets[i] = ctx.loadBuffer(i);
+				break;
+			case IAsset::ET_IMAGE:
+				ctx.assets[i] = ctx.loadImage(i);
+				break;
+			case IAsset::ET_RENDERPASS_INDEPENDENT_PIPELINE:
+				ctx.assets[i] = ctx.loadPipeline(i);
+				break;
+			case IAsset::ET_SUB_MESH:
+				ctx.assets[i] = ctx.loadMeshBuffer(i);
+				break;
+			case IAsset::ET_MESH:
+				ctx.assets[i] = ctx.loadMesh(i);
+				break;
+			case IAsset::ET_SKELETON:
+				ctx.assets[i] = ctx.loadSkeleton(i);
+				break;
+			case IAsset::ET_ANIMATION_LIBRARY:
+				ctx.assets[i] = ctx.loadAnimationLibrary(i);
+				break;
+			default:
+				break;
+		}
+		if (!ctx.assets[i])
+		{
+			logger.log("LOAD NBL: object %u of %s is corrupt or of an unsupported type", system::ILogger::ELL_ERROR, i, filename.c_str());
+			return {};
+		}
+	}
+
+	core::vector<core::smart_refctd_ptr<IAsset>> roots(header.rootCount);
+	for (uint32_t i=0u; i<header.rootCount; i++)
+	{
+		if (rootIx[i]>=header.objectCount || ctx.objects[rootIx[i]].type!=ctx.objects[rootIx[0]].type)
+		{
+			logger.log("LOAD NBL: root table of %s is corrupt", system::ILogger::ELL_ERROR, filename.c_str());
+			return {};
+		}
+		roots[i] = ctx.assets[rootIx[i]];
+		// the cache makes top level assets writeable, which the mapping isn't
+		if (readOnlyMapping && roots[i]->getAssetType()==IAsset::ET_BUFFER)
+			roots[i] = roots[i]->clone(0u);
+	}
+
+	// only now, the setters used to assemble the assets modify the buffers' usage flags
+	if (readOnlyMapping)
+	for (const auto& asset : ctx.assets)
+	if (asset->getAssetType()==IAsset::ET_BUFFER)
+		interm_setAssetMutability(m_manager,asset.get(),IAsset::EM_IMMUTABLE);
+
+	return SAssetBundle(nullptr,std::move(roots));
+}
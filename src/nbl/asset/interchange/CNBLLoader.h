@@ -0,0 +1,65 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef _NBL_ASSET_C_NBL_LOADER_H_INCLUDED_
+#define _NBL_ASSET_C_NBL_LOADER_H_INCLUDED_
+
+#include "nbl/asset/interchange/IAssetLoader.h"
+
+#include "SNBLFormat.h"
+
+namespace nbl::asset
+{
+
+//! Loads the native `*.nbl` container written by `CNBLWriter`
+/**
+	The file gets memory mapped and the buffers point straight into the mapping, their contents are never copied.
+	The mapping is read-only so these buffers are immutable, clone them if you need to modify them. Only top level
+	buffers get copied, because the asset cache makes top level assets writeable.
+
+	When the file can't be mapped it's read in one go and the buffers point into that copy instead. Unless `ELPF_LAZY_BUFFERS` is set,
+	then only the records get read and the buffers are `CFileBackedCPUBuffer`'s which read their contents when they're used.
+
+	The meshbuffers' pipelines only get their fixed function state back, they have an empty layout and no shaders, so set those before converting to GPU.
+*/
+class CNBLLoader final : public IAssetLoader
+{
+	protected:
+		~CNBLLoader() = default;
+
+	public:
+		explicit CNBLLoader(IAssetManager* _manager) : m_manager(_manager) {}
+
+		inline bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override
+		{
+			std::array<uint8_t,SniffedHeaderSize> headerStorage;
+			return isALoadableFileHeader(_file, sniffHeader(_file,headerStorage), logger);
+		}
+		bool isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger) const override;
+
+		inline std::span<const SMagicNumber> getMagicNumbers() const override
+		{
+			static const SMagicNumber magicNumbers[] = { {0ull, SNBLFormat::Magic} };
+			return magicNumbers;
+		}
+
+		const char** getAssociatedFileExtensions() const override
+		{
+			static const char* ext[]{ "nbl", nullptr };
+			return ext;
+		}
+
+		uint64_t getSupportedAssetTypesBitfield() const override { return SNBLFormat::SupportedTypes; }
+
+		SAssetBundle loadAsset(system::IFile* _file, const IAssetLoader::SAssetLoadParams& _params, IAssetLoader::IAssetLoaderOverride* _override = nullptr, uint32_t _hierarchyLevel = 0u) override;
+
+	private:
+		struct SContext;
+
+		IAssetManager* m_manager;
+};
+
+}
+
+#endif
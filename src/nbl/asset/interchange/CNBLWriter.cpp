@@ -0,0 +1,337 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/system/IFile.h"
+
+#include "nbl/asset/ICPUImage.h"
+#include "nbl/asset/ICPUMesh.h"
+#include "nbl/asset/ICPUSkeleton.h"
+#include "nbl/asset/ICPUAnimationLibrary.h"
+
+#include "CNBLWriter.h"
+
+#include <cstring>
+
+using namespace nbl;
+using namespace nbl::asset;
+
+namespace
+{
+inline SNBLFormat::SAABB toAABB(const core::aabbox3df& box)
+{
+	return {{box.MinEdge.X,box.MinEdge.Y,box.MinEdge.Z},{box.MaxEdge.X,box.MaxEdge.Y,box.MaxEdge.Z}};
+}
+}
+
+bool CNBLWriter::writeAsset(system::IFile* _file, const SAssetWriteParams& _params, IAssetWriterOverride* _override)
+{
+	if (!_override)
+		getDefaultOverride(_override);
+
+	SAssetWriteContext inCtx{_params, _file};
+
+	const IAsset* root = _params.rootAsset;
+	if (!root || !(root->getAssetType()&SNBLFormat::SupportedTypes))
+	{
+		_params.logger.log("WRITING NBL: unsupported root asset", system::ILogger::ELL_ERROR);
+		return false;
+	}
+
+	system::IFile* file = _override->getOutputFile(_file, inCtx, {root, 0u});
+	if (!file)
+		return false;
+
+	SContext ctx = { SAssetWriteContext{inCtx.params, file} };
+	_params.logger.log("WRITING NBL: writing the file %s", system::ILogger::ELL_INFO, file->getFileName().string().c_str());
+
+	// header goes last when we know where everything is
+	ctx.fileOffset = sizeof(SNBLFormat::SHeader);
+	const uint32_t rootIx = writeObject(ctx, root);
+	if (rootIx==SNBLFormat::InvalidObject)
+		return false;
+
+	SNBLFormat::SHeader header = {};
+	memcpy(header.magic, SNBLFormat::Magic, sizeof(SNBLFormat::Magic));
+	header.version = SNBLFormat::Version;
+	header.objectCount = static_cast<uint32_t>(ctx.objects.size());
+	header.objectTableOffset = SNBLFormat::alignRecord(ctx.fileOffset);
+	if (!pad(ctx, header.objectTableOffset) || !write(ctx, ctx.objects.data(), ctx.objects.size()*sizeof(SNBLFormat::SObject)))
+		return false;
+	header.rootTableOffset = ctx.fileOffset;
+	header.rootCount = 1u;
+	if (!write(ctx, &rootIx, sizeof(rootIx)))
+		return false;
+	header.fileSize = ctx.fileOffset;
+
+	ctx.fileOffset = 0ull;
+	return write(ctx, &header, sizeof(header));
+}
+
+uint32_t CNBLWriter::writeObject(SContext& ctx, const IAsset* asset) const
+{
+	const auto found = ctx.objectIndices.find(asset);
+	if (found!=ctx.objectIndices.end())
+		return found->second;
+
+	switch (asset->getAssetType())
+	{
+		case IAsset::ET_BUFFER:
+			return writeBuffer(ctx, static_cast<const ICPUBuffer*>(asset));
+		case IAsset::ET_IMAGE:
+			return writeImage(ctx, static_cast<const ICPUImage*>(asset));
+		case IAsset::ET_RENDERPASS_INDEPENDENT_PIPELINE:
+			return writePipeline(ctx, static_cast<const ICPURenderpassIndependentPipeline*>(asset));
+		case IAsset::ET_SUB_MESH:
+			return writeMeshBuffer(ctx, static_cast<const ICPUMeshBuffer*>(asset));
+		case IAsset::ET_MESH:
+			return writeMesh(ctx, static_cast<const ICPUMesh*>(asset));
+		case IAsset::ET_SKELETON:
+			return writeSkeleton(ctx, static_cast<const ICPUSkeleton*>(asset));
+		case IAsset::ET_ANIMATION_LIBRARY:
+			return writeAnimationLibrary(ctx, static_cast<const ICPUAnimationLibrary*>(asset));
+		default:
+			break;
+	}
+	ctx.writeContext.params.logger.log("WRITING NBL: asset type %llu can't be stored", system::ILogger::ELL_ERROR, static_cast<unsigned long long>(asset->getAssetType()));
+	return SNBLFormat::InvalidObject;
+}
+
+uint32_t CNBLWriter::writeBuffer(SContext& ctx, const ICPUBuffer* buffer) const
+{
+	if (buffer->isADummyObjectForCache())
+		ctx.writeContext.params.logger.log("WRITING NBL: buffer has been converted to a dummy, it will be written empty", system::ILogger::ELL_WARNING);
+
+	SNBLFormat::SBuffer record = {};
+	record.size = buffer->getPointer() ? buffer->getSize():0ull;
+	record.usage = buffer->getUsageFlags().value;
+	record.dataOffset = SNBLFormat::alignBlob(ctx.fileOffset);
+	if (!pad(ctx, record.dataOffset) || !write(ctx, buffer->getPointer(), record.size))
+		return SNBLFormat::InvalidObject;
+
+	return beginObject(ctx, buffer, &record, sizeof(record), 0ull);
+}
+
+uint32_t CNBLWriter::writeImage(SContext& ctx, const ICPUImage* image) const
+{
+	const auto& params = image->getCreationParameters();
+	const auto regions = image->getRegions();
+
+	SNBLFormat::SImage record = {};
+	record.buffer = SNBLFormat::InvalidObject;
+	if (const auto* buffer=image->getBuffer())
+	{
+		record.buffer = writeObject(ctx, buffer);
+		if (record.buffer==SNBLFormat::InvalidObject)
+			return SNBLFormat::InvalidObject;
+	}
+	record.regionCount = static_cast<uint32_t>(regions.size());
+	record.type = params.type;
+	record.samples = params.samples;
+	record.format = params.format;
+	record.flags = params.flags.value;
+	record.usage = params.usage.value;
+	record.stencilUsage = params.stencilUsage.value;
+	record.extent[0] = params.extent.width;
+	record.extent[1] = params.extent.height;
+	record.extent[2] = params.extent.depth;
+	record.mipLevels = params.mipLevels;
+	record.arrayLayers = params.arrayLayers;
+	for (uint32_t f=0u; f<EF_COUNT; f++)
+	if (params.viewFormats.test(f))
+		record.viewFormats[f/64u] |= 0x1ull<<(f%64u);
+
+	const uint32_t retval = beginObject(ctx, image, &record, sizeof(record), regions.size()*sizeof(SNBLFormat::SRegion));
+	if (retval==SNBLFormat::InvalidObject)
+		return SNBLFormat::InvalidObject;
+	for (const auto& region : regions)
+	{
+		const SNBLFormat::SRegion out = {
+			region.bufferOffset,region.bufferRowLength,region.bufferImageHeight,
+			region.imageSubresource.aspectMask.value,region.imageSubresource.mipLevel,region.imageSubresource.baseArrayLayer,region.imageSubresource.layerCount,
+			{region.imageOffset.x,region.imageOffset.y,region.imageOffset.z},
+			{region.imageExtent.width,region.imageExtent.height,region.imageExtent.depth}
+		};
+		if (!write(ctx, &out, sizeof(out)))
+			return SNBLFormat::InvalidObject;
+	}
+	return retval;
+}
+
+uint32_t CNBLWriter::writePipeline(SContext& ctx, const ICPURenderpassIndependentPipeline* pipeline) const
+{
+	const SNBLFormat::SPipeline record = SNBLFormat::toRecord(pipeline->getCachedCreationParams());
+	return beginObject(ctx, pipeline, &record, sizeof(record), 0ull);
+}
+
+uint32_t CNBLWriter::writeMeshBuffer(SContext& ctx, const ICPUMeshBuffer* meshbuffer) const
+{
+	if (meshbuffer->getAttachedDescriptorSet())
+		ctx.writeContext.params.logger.log("WRITING NBL: descriptor sets are not stored, meshbuffer will be written without one", system::ILogger::ELL_WARNING);
+
+	SNBLFormat::SMeshBuffer record = {};
+	record.pipeline = SNBLFormat::InvalidObject;
+	if (const auto* pipeline=meshbuffer->getPipeline())
+	{
+		record.pipeline = writeObject(ctx, pipeline);
+		if (record.pipeline==SNBLFormat::InvalidObject)
+			return SNBLFormat::InvalidObject;
+	}
+	const auto* vertexBindings = meshbuffer->getVertexBufferBindings();
+	for (uint32_t i=0u; i<ICPUMeshBuffer::MAX_ATTR_BUF_BINDING_COUNT; i++)
+	if (!writeBinding(ctx, record.vertexBindings[i], vertexBindings[i].buffer.get(), vertexBindings[i].offset))
+		return SNBLFormat::InvalidObject;
+	const auto& indexBinding = meshbuffer->getIndexBufferBinding();
+	const auto& inverseBindPoseBinding = meshbuffer->getInverseBindPoseBufferBinding();
+	const auto& jointAABBBinding = meshbuffer->getJointAABBBufferBinding();
+	if (!writeBinding(ctx, record.indexBinding, indexBinding.buffer.get(), indexBinding.offset) ||
+		!writeBinding(ctx, record.inverseBindPoseBinding, inverseBindPoseBinding.buffer.get(), inverseBindPoseBinding.offset) ||
+		!writeBinding(ctx, record.jointAABBBinding, jointAABBBinding.buffer.get(), jointAABBBinding.offset))
+		return SNBLFormat::InvalidObject;
+
+	record.indexType = meshbuffer->getIndexType();
+	record.indexCount = meshbuffer->getIndexCount();
+	record.instanceCount = meshbuffer->getInstanceCount();
+	record.baseInstance = meshbuffer->getBaseInstance();
+	record.baseVertex = meshbuffer->getBaseVertex();
+	record.positionAttribute = meshbuffer->getPositionAttributeIx();
+	record.normalAttribute = meshbuffer->getNormalAttributeIx();
+	record.jointIDAttribute = meshbuffer->getJointIDAttributeIx();
+	record.jointWeightAttribute = meshbuffer->getJointWeightAttributeIx();
+	record.jointCount = meshbuffer->getJointCount();
+	record.maxJointsPerVertex = meshbuffer->getMaxJointsPerVertex();
+	record.boundingBox = toAABB(meshbuffer->getBoundingBox());
+	memcpy(record.pushConstants, meshbuffer->getPushConstantsDataPtr(), sizeof(record.pushConstants));
+
+	return beginObject(ctx, meshbuffer, &record, sizeof(record), 0ull);
+}
+
+uint32_t CNBLWriter::writeMesh(SContext& ctx, const ICPUMesh* mesh) const
+{
+	core::vector<uint32_t> meshbuffers;
+	for (const auto* meshbuffer : mesh->getMeshBuffers())
+	{
+		if (!meshbuffer)
+			continue;
+		meshbuffers.push_back(writeObject(ctx, meshbuffer));
+		if (meshbuffers.back()==SNBLFormat::InvalidObject)
+			return SNBLFormat::InvalidObject;
+	}
+
+	SNBLFormat::SMesh record = {};
+	record.meshBufferCount = static_cast<uint32_t>(meshbuffers.size());
+	record.boundingBox = toAABB(mesh->getBoundingBox());
+
+	const uint64_t tailSize = meshbuffers.size()*sizeof(uint32_t);
+	const uint32_t retval = beginObject(ctx, mesh, &record, sizeof(record), tailSize);
+	if (retval==SNBLFormat::InvalidObject || !write(ctx, meshbuffers.data(), tailSize))
+		return SNBLFormat::InvalidObject;
+	return retval;
+}
+
+uint32_t CNBLWriter::writeSkeleton(SContext& ctx, const ICPUSkeleton* skeleton) const
+{
+	SNBLFormat::SSkeleton record = {};
+	const auto& parentJointIDs = skeleton->getParentJointIDBinding();
+	const auto& defaultTransforms = skeleton->getDefaultTransformBinding();
+	if (!writeBinding(ctx, record.parentJointIDs, parentJointIDs.buffer.get(), parentJointIDs.offset) ||
+		!writeBinding(ctx, record.defaultTransforms, defaultTransforms.buffer.get(), defaultTransforms.offset))
+		return SNBLFormat::InvalidObject;
+	record.jointCount = skeleton->getJointCount();
+
+	core::vector<const char*> names(record.jointCount, "");
+	for (const auto& entry : skeleton->getJointNameToIDMap())
+	if (entry.second<record.jointCount)
+		names[entry.second] = entry.first;
+	uint64_t tailSize = 0ull;
+	for (const char* name : names)
+		tailSize += strlen(name)+1ull;
+
+	const uint32_t retval = beginObject(ctx, skeleton, &record, sizeof(record), tailSize);
+	if (retval==SNBLFormat::InvalidObject)
+		return SNBLFormat::InvalidObject;
+	for (const char* name : names)
+	if (!write(ctx, name, strlen(name)+1ull))
+		return SNBLFormat::InvalidObject;
+	return retval;
+}
+
+uint32_t CNBLWriter::writeAnimationLibrary(SContext& ctx, const ICPUAnimationLibrary* library) const
+{
+	SNBLFormat::SAnimationLibrary record = {};
+	const auto& keyframes = library->getKeyframeStorageBinding();
+	const auto& timestamps = library->getTimestampStorageBinding();
+	const auto& animations = library->getAnimationStorageRange();
+	if (!writeBinding(ctx, record.keyframes, keyframes.buffer.get(), keyframes.offset) ||
+		!writeBinding(ctx, record.timestamps, timestamps.buffer.get(), timestamps.offset))
+		return SNBLFormat::InvalidObject;
+	SNBLFormat::SBinding animationBinding;
+	if (!writeBinding(ctx, animationBinding, animations.buffer.get(), animations.offset))
+		return SNBLFormat::InvalidObject;
+	record.animations = {animationBinding.object,0u,animations.offset,animations.size};
+	record.keyframeCount = library->getKeyframeCount();
+
+	core::vector<uint32_t> offsets;
+	core::vector<const char*> names;
+	library->forEachAnimationName([&](const char* name, const uint32_t animation) -> void
+	{
+		names.push_back(name);
+		offsets.push_back(animation);
+	});
+	record.nameCount = static_cast<uint32_t>(names.size());
+	uint64_t tailSize = offsets.size()*sizeof(uint32_t);
+	for (const char* name : names)
+		tailSize += strlen(name)+1ull;
+
+	const uint32_t retval = beginObject(ctx, library, &record, sizeof(record), tailSize);
+	if (retval==SNBLFormat::InvalidObject || !write(ctx, offsets.data(), offsets.size()*sizeof(uint32_t)))
+		return SNBLFormat::InvalidObject;
+	for (const char* name : names)
+	if (!write(ctx, name, strlen(name)+1ull))
+		return SNBLFormat::InvalidObject;
+	return retval;
+}
+
+bool CNBLWriter::writeBinding(SContext& ctx, SNBLFormat::SBinding& out, const ICPUBuffer* buffer, const uint64_t offset) const
+{
+	out = {};
+	if (!buffer)
+		return true;
+	out.object = writeObject(ctx, buffer);
+	out.offset = offset;
+	return out.object!=SNBLFormat::InvalidObject;
+}
+
+bool CNBLWriter::pad(SContext& ctx, const uint64_t newOffset) const
+{
+	static const uint8_t zeroes[SNBLFormat::BlobAlignment] = {};
+	assert(newOffset>=ctx.fileOffset && newOffset-ctx.fileOffset<=sizeof(zeroes));
+	return write(ctx, zeroes, newOffset-ctx.fileOffset);
+}
+
+bool CNBLWriter::write(SContext& ctx, const void* data, const size_t size) const
+{
+	if (size==0ull)
+		return true;
+	system::IFile::success_t success;
+	ctx.writeContext.outputFile->write(success, data, ctx.fileOffset, size);
+	if (!success)
+	{
+		ctx.writeContext.params.logger.log("WRITING NBL: failed to write %llu bytes to %s", system::ILogger::ELL_ERROR, static_cast<unsigned long long>(size), ctx.writeContext.outputFile->getFileName().string().c_str());
+		return false;
+	}
+	ctx.fileOffset += size;
+	return true;
+}
+
+uint32_t CNBLWriter::beginObject(SContext& ctx, const IAsset* asset, const void* record, const size_t recordSize, const uint64_t tailSize) const
+{
+	const uint64_t offset = SNBLFormat::alignRecord(ctx.fileOffset);
+	if (!pad(ctx, offset) || !write(ctx, record, recordSize))
+		return SNBLFormat::InvalidObject;
+
+	const uint32_t retval = static_cast<uint32_t>(ctx.objects.size());
+	ctx.objects.push_back({asset->getAssetType(),offset,recordSize+tailSize});
+	ctx.objectIndices.emplace(asset, retval);
+	return retval;
+}
@@ -0,0 +1,71 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef _NBL_ASSET_C_NBL_WRITER_H_INCLUDED_
+#define _NBL_ASSET_C_NBL_WRITER_H_INCLUDED_
+
+#include "nbl/asset/interchange/IAssetWriter.h"
+
+#include "SNBLFormat.h"
+
+namespace nbl::asset
+{
+
+//! Writes buffers, images, meshes, skeletons and animation libraries (with everything they reference) to the native `*.nbl` container
+/** Assets referenced more than once are written once. Descriptor sets are not written and of the meshbuffers' pipelines only the fixed function state is, not the shaders or the layout.
+@see SNBLFormat */
+class CNBLWriter final : public IAssetWriter
+{
+	protected:
+		~CNBLWriter() = default;
+
+	public:
+		CNBLWriter() = default;
+
+		const char** getAssociatedFileExtensions() const override
+		{
+			static const char* ext[]{ "nbl", nullptr };
+			return ext;
+		}
+
+		uint64_t getSupportedAssetTypesBitfield() const override { return SNBLFormat::SupportedTypes; }
+
+		uint32_t getSupportedFlags() override { return asset::EWF_BINARY; }
+
+		uint32_t getForcedFlags() override { return asset::EWF_BINARY; }
+
+		bool writeAsset(system::IFile* _file, const SAssetWriteParams& _params, IAssetWriterOverride* _override = nullptr) override;
+
+	private:
+		struct SContext
+		{
+			SAssetWriteContext writeContext;
+			core::unordered_map<const IAsset*,uint32_t> objectIndices;
+			core::vector<SNBLFormat::SObject> objects;
+			uint64_t fileOffset = 0ull;
+		};
+
+		// writes `asset` and everything it references unless its already been, returns its index in the object table or `InvalidObject` on failure
+		uint32_t writeObject(SContext& ctx, const IAsset* asset) const;
+		uint32_t writeBuffer(SContext& ctx, const ICPUBuffer* buffer) const;
+		uint32_t writeImage(SContext& ctx, const ICPUImage* image) const;
+		uint32_t writePipeline(SContext& ctx, const ICPURenderpassIndependentPipeline* pipeline) const;
+		uint32_t writeMeshBuffer(SContext& ctx, const ICPUMeshBuffer* meshbuffer) const;
+		uint32_t writeMesh(SContext& ctx, const ICPUMesh* mesh) const;
+		uint32_t writeSkeleton(SContext& ctx, const ICPUSkeleton* skeleton) const;
+		uint32_t writeAnimationLibrary(SContext& ctx, const ICPUAnimationLibrary* library) const;
+
+		// `InvalidObject` for no buffer, fails the whole write if the buffer couldn't be written
+		bool writeBinding(SContext& ctx, SNBLFormat::SBinding& out, const ICPUBuffer* buffer, const uint64_t offset) const;
+
+		// pads with zeroes up to the alignment and returns where the next write goes
+		bool pad(SContext& ctx, const uint64_t newOffset) const;
+		bool write(SContext& ctx, const void* data, const size_t size) const;
+		// starts an object record, the tail (if any) has to be written right after
+		uint32_t beginObject(SContext& ctx, const IAsset* asset, const void* record, const size_t recordSize, const uint64_t tailSize) const;
+};
+
+}
+
+#endif
@@ -148,6 +148,8 @@ asset::SAssetBundle COBJMeshFileLoader::loadAsset(system::IFile* _file, const as
 	constexpr const char* NO_MATERIAL_MTL_NAME = "#";
 	bool noMaterial = true;
 	bool dummyMaterialCreated = false;
+	// per-face temporaries live in the thread's frame arena, rewound after every face
+	core::CFrameArenaMemoryResource faceScratch;
 	while(bufPtr != bufEnd)
 	{
 		switch(bufPtr[0])
@@ -283,7 +285,8 @@ asset::SAssetBundle COBJMeshFileLoader::loadAsset(system::IFile* _file, const as
 			const char* linePtr = wordBuffer.c_str();
 			const char* const endPtr = linePtr + wordBuffer.size();
 
-			core::vector<uint32_t> faceCorners;
+			core::CFrameArena::SScope faceScratchScope(faceScratch.getArena());
+			std::pmr::vector<uint32_t> faceCorners(&faceScratch);
 			faceCorners.reserve(32ull);
 
 			// read in all vertices
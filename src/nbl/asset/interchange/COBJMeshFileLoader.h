@@ -77,12 +77,14 @@ public:
 	COBJMeshFileLoader(IAssetManager* _manager);
 
     inline bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override
+    {
+        std::array<uint8_t,SniffedHeaderSize> headerStorage;
+        return isALoadableFileHeader(_file, sniffHeader(_file,headerStorage), logger);
+    }
+    inline bool isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger) const override
     {
         // OBJ doesn't really have any header but usually starts with a comment
-        system::IFile::success_t succ;
-        char firstChar = 0;
-        _file->read(succ, &firstChar, 0, sizeof(firstChar));
-        return succ && (firstChar =='#' || firstChar =='v');
+        return !_header.empty() && (_header[0] =='#' || _header[0] =='v');
     }
 
     virtual const char** getAssociatedFileExtensions() const override
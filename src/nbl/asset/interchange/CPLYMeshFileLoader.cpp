@@ -28,6 +28,12 @@ CPLYMeshFileLoader::CPLYMeshFileLoader(IAssetManager* _am)
 CPLYMeshFileLoader::~CPLYMeshFileLoader() {}
 
 bool CPLYMeshFileLoader::isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const
+{
+    std::array<uint8_t,SniffedHeaderSize> headerStorage;
+    return isALoadableFileHeader(_file, sniffHeader(_file,headerStorage), logger);
+}
+
+bool CPLYMeshFileLoader::isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger) const
 {
     const char* headers[3]{
         "format ascii 1.0",
@@ -35,12 +41,11 @@ bool CPLYMeshFileLoader::isALoadableFileFormat(system::IFile* _file, const syste
         "format binary_big_endian 1.0"
     };
 
-    char buf[40];
-
-	system::IFile::success_t success;
-	_file->read(success, buf, 0, sizeof(buf));
-	if (!success)
-		return false;
+    // null terminated for the string functions
+    char buf[41] = {};
+    if (_header.size() < 4u)
+        return false;
+    memcpy(buf, _header.data(), std::min<size_t>(_header.size(), sizeof(buf)-1u));
 
     char* header = buf;
     if (strncmp(header, "ply", 3u) != 0)
@@ -352,7 +357,11 @@ asset::SAssetBundle CPLYMeshFileLoader::loadAsset(system::IFile* _file, const as
 			mb->setNormalAttributeIx(3u);
       
 			asset::SBufferBinding<asset::ICPUBuffer> attributes[4];
-			core::vector<uint32_t> indices;
+			// the indices get copied into a buffer at the end, so they only need scratch memory from the thread's frame arena,
+			// which gets trimmed after so the thread doesn't keep a block the size of the biggest mesh it loaded
+			core::CFrameArenaMemoryResource scratch;
+			core::CFrameArena::SScope scratchScope(scratch.getArena(),true);
+			std::pmr::vector<uint32_t> indices(&scratch);
 
 			bool hasNormals = true;
 
@@ -409,6 +418,8 @@ asset::SAssetBundle CPLYMeshFileLoader::loadAsset(system::IFile* _file, const as
 				else if (ctx.ElementList[i]->Name == "face")
 				{
 					const size_t indicesCount = ctx.ElementList[i]->Count;
+					// every face is at least a triangle, and the arena never frees what a growing vector leaves behind
+					indices.reserve(indices.size()+indicesCount*3ull);
 
 					// read faces
 					for (uint32_t j=0; j < indicesCount; ++j)
@@ -627,7 +638,7 @@ bool CPLYMeshFileLoader::readVertex(SContext& _ctx, const SPLYElement& Element,
 }
 
 
-bool CPLYMeshFileLoader::readFace(SContext& _ctx, const SPLYElement& Element, core::vector<uint32_t>& _outIndices)
+bool CPLYMeshFileLoader::readFace(SContext& _ctx, const SPLYElement& Element, std::pmr::vector<uint32_t>& _outIndices)
 {
 	if (!_ctx.IsBinaryFile)
 		getNextLine(_ctx);
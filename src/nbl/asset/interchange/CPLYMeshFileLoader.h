@@ -43,6 +43,14 @@ public:
 	CPLYMeshFileLoader(IAssetManager* _am);
 
     virtual bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override;
+    virtual bool isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger) const override;
+
+    virtual std::span<const SMagicNumber> getMagicNumbers() const override
+    {
+        static const uint8_t magic[] = { 'p', 'l', 'y' };
+        static const SMagicNumber magicNumbers[] = { {0ull, magic} };
+        return magicNumbers;
+    }
 
     virtual const char** getAssociatedFileExtensions() const override
     {
@@ -195,7 +203,7 @@ private:
 	E_PLY_PROPERTY_TYPE getPropertyType(const char* typeString) const;
 
  	bool readVertex(SContext& _ctx, const SPLYElement &Element, asset::SBufferBinding<asset::ICPUBuffer> outAttributes[4], const uint32_t& currentVertexIndex, const IAssetLoader::SAssetLoadParams& _params);
-	bool readFace(SContext& _ctx, const SPLYElement &Element, core::vector<uint32_t>& _outIndices);
+	bool readFace(SContext& _ctx, const SPLYElement &Element, std::pmr::vector<uint32_t>& _outIndices);
 
 	void skipElement(SContext& _ctx, const SPLYElement &Element);
 	void skipProperty(SContext& _ctx, const SPLYProperty &Property);
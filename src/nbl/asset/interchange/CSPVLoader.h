@@ -15,13 +15,22 @@ class CSPVLoader final : public asset::IAssetLoader
 		_NBL_STATIC_INLINE_CONSTEXPR uint32_t SPV_MAGIC_NUMBER = 0x07230203u;
 	public:
 		CSPVLoader() = default;
-		inline bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr) const override
+		inline bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override
 		{
-			uint32_t magicNumber = 0u;
+			std::array<uint8_t,SniffedHeaderSize> headerStorage;
+			return isALoadableFileHeader(_file, sniffHeader(_file,headerStorage), logger);
+		}
+		inline bool isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr) const override
+		{
+			return getMagicNumbers().front().matches(_header);
+		}
 
-			system::IFile::success_t success;
-			_file->read(success, &magicNumber, 0, sizeof magicNumber);
-			return success && magicNumber==SPV_MAGIC_NUMBER;
+		inline std::span<const SMagicNumber> getMagicNumbers() const override
+		{
+			// little endian `SPV_MAGIC_NUMBER`
+			static const uint8_t magic[] = { 0x03u, 0x02u, 0x23u, 0x07u };
+			static const SMagicNumber magicNumbers[] = { {0ull, magic} };
+			return magicNumbers;
 		}
 
 		const char** getAssociatedFileExtensions() const override
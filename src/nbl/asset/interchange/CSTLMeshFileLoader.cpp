@@ -317,31 +317,26 @@ SAssetBundle CSTLMeshFileLoader::loadAsset(system::IFile* _file, const IAssetLoa
 
 bool CSTLMeshFileLoader::isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const
 {
-	if (!_file || _file->getSize() <= 6u)
-		return false;
+	std::array<uint8_t,SniffedHeaderSize> headerStorage;
+	return isALoadableFileHeader(_file, sniffHeader(_file,headerStorage), logger);
+}
 
-	char header[6];
-	{
-		system::IFile::success_t success;
-		_file->read(success, header, 0, sizeof(header));
-		if (!success)
-			return false;
-	}
+bool CSTLMeshFileLoader::isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger) const
+{
+	if (!_file || _file->getSize() <= 6u || _header.size() < 6u)
+		return false;
 
-	if (strncmp(header, "solid ", 6u) == 0)
+	if (getMagicNumbers().front().matches(_header))
 		return true;
 	else
 	{
-		if (_file->getSize() < 84u)
+		constexpr size_t readOffset = 80;
+		static_assert(readOffset+sizeof(uint32_t)<=SniffedHeaderSize);
+		if (_file->getSize() < 84u || _header.size() < readOffset+sizeof(uint32_t))
 			return false;
 
 		uint32_t triangleCount;
-
-		constexpr size_t readOffset = 80;
-		system::IFile::success_t success;
-		_file->read(success, &triangleCount, readOffset, sizeof(triangleCount));
-		if (!success)
-			return false;
+		memcpy(&triangleCount, _header.data()+readOffset, sizeof(triangleCount));
 
 		constexpr size_t STL_TRI_SZ = 50u;
 		return _file->getSize() == (STL_TRI_SZ * triangleCount + 84u);
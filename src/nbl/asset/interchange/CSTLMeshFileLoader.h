@@ -27,6 +27,15 @@ class CSTLMeshFileLoader final : public IRenderpassIndependentPipelineLoader
 		asset::SAssetBundle loadAsset(system::IFile* _file, const IAssetLoader::SAssetLoadParams& _params, IAssetLoader::IAssetLoaderOverride* _override = nullptr, uint32_t _hierarchyLevel = 0u) override;
 
 		bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override;
+		bool isALoadableFileHeader(system::IFile* _file, const std::span<const uint8_t> _header, const system::logger_opt_ptr logger) const override;
+
+		//! binary STL has no magic number, only the text one does
+		std::span<const SMagicNumber> getMagicNumbers() const override
+		{
+			static const uint8_t solid[] = { 's', 'o', 'l', 'i', 'd', ' ' };
+			static const SMagicNumber magicNumbers[] = { {0ull, solid} };
+			return magicNumbers;
+		}
 
 		const char** getAssociatedFileExtensions() const override
 		{
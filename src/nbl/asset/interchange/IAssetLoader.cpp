@@ -9,6 +9,39 @@
 using namespace nbl;
 using namespace asset;
 
+namespace
+{
+    thread_local const std::string* tl_loadScope = nullptr;
+}
+
+IAssetLoader::SLoadScope::SLoadScope(const std::string* _key) : m_previous(tl_loadScope)
+{
+    tl_loadScope = _key;
+}
+
+IAssetLoader::SLoadScope::~SLoadScope()
+{
+    tl_loadScope = m_previous;
+}
+
+const std::string* IAssetLoader::SLoadScope::getCurrent()
+{
+    return tl_loadScope;
+}
+
+std::span<const uint8_t> IAssetLoader::sniffHeader(system::IFile* _file, std::array<uint8_t,SniffedHeaderSize>& _storage)
+{
+    if (!_file)
+        return {};
+
+    const size_t size = std::min<size_t>(_file->getSize(),SniffedHeaderSize);
+    system::IFile::success_t success;
+    _file->read(success, _storage.data(), 0, size);
+    if (!success)
+        return {};
+    return {_storage.data(),size};
+}
+
 // todo NEED DOCS
 IAssetLoader::IAssetLoaderOverride::IAssetLoaderOverride(IAssetManager* _manager) : m_manager(_manager), m_system(m_manager->getSystem())
 {
@@ -23,6 +56,7 @@ SAssetBundle IAssetLoader::IAssetLoaderOverride::findCachedAsset(const std::stri
     auto found = m_manager->findAssets(inSearchKey, inAssetTypes);
     if (!found->size())
         return handleSearchFail(inSearchKey, ctx, hierarchyLevel);
+    m_manager->recordDependency(inSearchKey);
     return chooseRelevantFromFound(found->begin(), found->end(), ctx, hierarchyLevel);
 }
 
@@ -32,7 +66,10 @@ void IAssetLoader::IAssetLoaderOverride::insertAssetIntoCache(SAssetBundle& asse
 
     auto levelFlag = ctx.params.cacheFlags >> (uint64_t(hierarchyLevel) * 2ull);
     if (!(levelFlag&ECF_DONT_CACHE_TOP_LEVEL))
+    {
         m_manager->insertAssetIntoCache(asset, ASSET_MUTABILITY_ON_CACHE_INSERT);
+        m_manager->recordIntermediateInsertion(supposedKey);
+    }
 }
 
 core::smart_refctd_ptr<IAsset> IAssetLoader::IAssetLoaderOverride::handleRestore(core::smart_refctd_ptr<IAsset>&& _chosenAsset, SAssetBundle& _bundle, SAssetBundle& _reloadedBundle, uint32_t _restoreLevels)
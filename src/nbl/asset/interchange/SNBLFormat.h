@@ -0,0 +1,343 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef _NBL_ASSET_S_NBL_FORMAT_H_INCLUDED_
+#define _NBL_ASSET_S_NBL_FORMAT_H_INCLUDED_
+
+#include "nbl/asset/ICPUMeshBuffer.h"
+
+namespace nbl::asset
+{
+
+//! On-disk layout of the native `*.nbl` asset container, shared by `CNBLLoader` and `CNBLWriter`
+/**
+	The file is a flat table of objects, every object is a fixed size record (optionally followed by a variable length tail)
+	and the records reference each other by their index in the table. Objects always come after everything they reference,
+	so the loader can create them in a single pass and there can't be any cycles.
+
+	Buffer contents are stored as raw blobs aligned to `BlobAlignment`, so with the file mapped into memory a buffer
+	is just a pointer into the mapping and nothing gets copied or fixed up.
+
+	Everything is little endian with 64bit offsets from the start of the file, any change to a record needs a `Version` bump.
+*/
+struct SNBLFormat
+{
+	_NBL_STATIC_INLINE_CONSTEXPR uint8_t Magic[8] = {'N','B','L','A','S','S','E','T'};
+	_NBL_STATIC_INLINE_CONSTEXPR uint32_t Version = 2u;
+	// enough for any SIMD load and for a cache line not to be shared between two blobs
+	_NBL_STATIC_INLINE_CONSTEXPR uint64_t BlobAlignment = 64ull;
+	_NBL_STATIC_INLINE_CONSTEXPR uint32_t InvalidObject = 0xffffffffu;
+
+	_NBL_STATIC_INLINE_CONSTEXPR uint64_t SupportedTypes = IAsset::ET_BUFFER|IAsset::ET_IMAGE|IAsset::ET_SUB_MESH|IAsset::ET_MESH|IAsset::ET_SKELETON|IAsset::ET_ANIMATION_LIBRARY;
+
+	struct SHeader
+	{
+		uint8_t magic[sizeof(Magic)];
+		uint32_t version;
+		uint32_t objectCount;
+		//! array of `objectCount` SObject
+		uint64_t objectTableOffset;
+		//! array of `rootCount` object indices, all of the same type, they make up the loaded bundle
+		uint64_t rootTableOffset;
+		uint32_t rootCount;
+		uint32_t padding;
+		uint64_t fileSize;
+	};
+	struct SObject
+	{
+		//! IAsset::E_TYPE
+		uint64_t type;
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	struct SBinding
+	{
+		uint32_t object = InvalidObject;
+		uint32_t padding = 0u;
+		uint64_t offset = 0ull;
+	};
+	struct SRange
+	{
+		uint32_t object = InvalidObject;
+		uint32_t padding = 0u;
+		uint64_t offset = 0ull;
+		uint64_t size = 0ull;
+	};
+	struct SAABB
+	{
+		float minEdge[3];
+		float maxEdge[3];
+	};
+
+	struct SBuffer
+	{
+		uint64_t dataOffset;
+		uint64_t size;
+		uint32_t usage;
+		uint32_t padding;
+	};
+	//! followed by `regionCount` SRegion
+	struct SImage
+	{
+		uint32_t buffer;
+		uint32_t regionCount;
+		uint32_t type;
+		uint32_t samples;
+		uint32_t format;
+		uint32_t flags;
+		uint32_t usage;
+		uint32_t stencilUsage;
+		uint32_t extent[3];
+		uint32_t mipLevels;
+		uint32_t arrayLayers;
+		uint32_t padding;
+		uint64_t viewFormats[(EF_COUNT+63u)/64u];
+	};
+	struct SRegion
+	{
+		uint64_t bufferOffset;
+		uint32_t bufferRowLength;
+		uint32_t bufferImageHeight;
+		uint32_t aspectMask;
+		uint32_t mipLevel;
+		uint32_t baseArrayLayer;
+		uint32_t layerCount;
+		int32_t imageOffset[3];
+		uint32_t imageExtent[3];
+	};
+	//! Only the fixed function state of a pipeline is stored, its shaders and layout are not
+	/** Every bitfield of `SCachedCreationParams` gets a member of its own, so the layout doesn't depend on how the compiler packs them. */
+	struct SPipeline
+	{
+		struct SAttribute
+		{
+			uint32_t binding;
+			uint32_t format;
+			uint32_t relativeOffset;
+		};
+		struct SVertexBinding
+		{
+			uint32_t stride;
+			uint32_t inputRate;
+		};
+		struct SStencilOps
+		{
+			uint8_t failOp;
+			uint8_t passOp;
+			uint8_t depthFailOp;
+			uint8_t compareOp;
+		};
+		struct SAttachmentBlend
+		{
+			uint8_t srcColorFactor;
+			uint8_t dstColorFactor;
+			uint8_t colorBlendOp;
+			uint8_t srcAlphaFactor;
+			uint8_t dstAlphaFactor;
+			uint8_t alphaBlendOp;
+			uint8_t colorWriteMask;
+			uint8_t padding;
+		};
+
+		uint32_t enabledAttribFlags;
+		uint32_t enabledBindingFlags;
+		SAttribute attributes[SVertexInputParams::MAX_VERTEX_ATTRIB_COUNT];
+		SVertexBinding bindings[SVertexInputParams::MAX_ATTR_BUF_BINDING_COUNT];
+		uint32_t primitiveType;
+		uint32_t primitiveRestartEnable;
+		uint32_t tessPatchVertCount;
+		uint8_t viewportCount;
+		uint8_t samplesLog2;
+		uint8_t depthClampEnable;
+		uint8_t rasterizerDiscard;
+		uint8_t polygonMode;
+		uint8_t faceCullingMode;
+		uint8_t frontFaceIsCCW;
+		uint8_t depthBiasEnable;
+		uint8_t alphaToCoverageEnable;
+		uint8_t alphaToOneEnable;
+		uint8_t depthWriteEnable;
+		uint8_t depthCompareOp;
+		uint8_t depthBoundsTestEnable;
+		uint8_t minSampleShadingUnorm;
+		uint8_t padding[2];
+		SStencilOps frontStencilOps;
+		SStencilOps backStencilOps;
+		uint32_t sampleMask[2];
+		SAttachmentBlend blend[IRenderpass::SCreationParams::SSubpassDescription::MaxColorAttachments];
+		uint32_t logicOp;
+	};
+	struct SMeshBuffer
+	{
+		SBinding vertexBindings[SVertexInputParams::MAX_ATTR_BUF_BINDING_COUNT];
+		SBinding indexBinding;
+		SBinding inverseBindPoseBinding;
+		SBinding jointAABBBinding;
+		uint32_t indexType;
+		uint32_t indexCount;
+		uint32_t instanceCount;
+		uint32_t baseInstance;
+		int32_t baseVertex;
+		uint32_t positionAttribute;
+		uint32_t normalAttribute;
+		uint32_t jointIDAttribute;
+		uint32_t jointWeightAttribute;
+		uint32_t jointCount;
+		uint32_t maxJointsPerVertex;
+		//! `InvalidObject` if the meshbuffer had no pipeline
+		uint32_t pipeline;
+		SAABB boundingBox;
+		uint8_t pushConstants[ICPUMeshBuffer::MAX_PUSH_CONSTANT_BYTESIZE];
+	};
+	//! followed by `meshBufferCount` object indices
+	struct SMesh
+	{
+		uint32_t meshBufferCount;
+		SAABB boundingBox;
+	};
+	//! followed by `jointCount` null terminated names, unnamed joints get an empty string
+	struct SSkeleton
+	{
+		SBinding parentJointIDs;
+		SBinding defaultTransforms;
+		uint32_t jointCount;
+		uint32_t padding;
+	};
+	//! followed by `nameCount` animation offsets and then as many null terminated names
+	struct SAnimationLibrary
+	{
+		SBinding keyframes;
+		SBinding timestamps;
+		SRange animations;
+		uint32_t keyframeCount;
+		uint32_t nameCount;
+	};
+
+	//! Where the next record or blob goes, if `offset` is where the previous one ended
+	static inline uint64_t alignRecord(const uint64_t offset) {return core::roundUp<uint64_t>(offset,alignof(uint64_t));}
+	static inline uint64_t alignBlob(const uint64_t offset) {return core::roundUp<uint64_t>(offset,BlobAlignment);}
+
+	static inline SPipeline toRecord(const ICPURenderpassIndependentPipeline::SCachedCreationParams& params)
+	{
+		SPipeline record = {};
+		const auto& vertexInput = params.vertexInput;
+		record.enabledAttribFlags = vertexInput.enabledAttribFlags;
+		record.enabledBindingFlags = vertexInput.enabledBindingFlags;
+		for (uint32_t i=0u; i<SVertexInputParams::MAX_VERTEX_ATTRIB_COUNT; i++)
+			record.attributes[i] = {vertexInput.attributes[i].binding,vertexInput.attributes[i].format,vertexInput.attributes[i].relativeOffset};
+		for (uint32_t i=0u; i<SVertexInputParams::MAX_ATTR_BUF_BINDING_COUNT; i++)
+			record.bindings[i] = {vertexInput.bindings[i].stride,vertexInput.bindings[i].inputRate};
+
+		record.primitiveType = params.primitiveAssembly.primitiveType;
+		record.primitiveRestartEnable = params.primitiveAssembly.primitiveRestartEnable;
+		record.tessPatchVertCount = params.primitiveAssembly.tessPatchVertCount;
+
+		const auto& raster = params.rasterization;
+		record.viewportCount = raster.viewportCount;
+		record.samplesLog2 = raster.samplesLog2;
+		record.depthClampEnable = raster.depthClampEnable;
+		record.rasterizerDiscard = raster.rasterizerDiscard;
+		record.polygonMode = raster.polygonMode;
+		record.faceCullingMode = raster.faceCullingMode;
+		record.frontFaceIsCCW = raster.frontFaceIsCCW;
+		record.depthBiasEnable = raster.depthBiasEnable;
+		record.alphaToCoverageEnable = raster.alphaToCoverageEnable;
+		record.alphaToOneEnable = raster.alphaToOneEnable;
+		record.depthWriteEnable = raster.depthWriteEnable;
+		record.depthCompareOp = raster.depthCompareOp;
+		record.depthBoundsTestEnable = raster.depthBoundsTestEnable;
+		record.minSampleShadingUnorm = raster.minSampleShadingUnorm;
+		auto toStencilOps = [](const SStencilOpParams& ops) -> SPipeline::SStencilOps
+		{
+			return {static_cast<uint8_t>(ops.failOp),static_cast<uint8_t>(ops.passOp),static_cast<uint8_t>(ops.depthFailOp),static_cast<uint8_t>(ops.compareOp)};
+		};
+		record.frontStencilOps = toStencilOps(raster.frontStencilOps);
+		record.backStencilOps = toStencilOps(raster.backStencilOps);
+		record.sampleMask[0] = raster.sampleMask[0];
+		record.sampleMask[1] = raster.sampleMask[1];
+
+		for (uint32_t i=0u; i<IRenderpass::SCreationParams::SSubpassDescription::MaxColorAttachments; i++)
+		{
+			const auto& blend = params.blend.blendParams[i];
+			record.blend[i] = {
+				static_cast<uint8_t>(blend.srcColorFactor),static_cast<uint8_t>(blend.dstColorFactor),static_cast<uint8_t>(blend.colorBlendOp),
+				static_cast<uint8_t>(blend.srcAlphaFactor),static_cast<uint8_t>(blend.dstAlphaFactor),static_cast<uint8_t>(blend.alphaBlendOp),
+				static_cast<uint8_t>(blend.colorWriteMask),0u
+			};
+		}
+		record.logicOp = params.blend.logicOp;
+		return record;
+	}
+	static inline ICPURenderpassIndependentPipeline::SCachedCreationParams fromRecord(const SPipeline& record)
+	{
+		ICPURenderpassIndependentPipeline::SCachedCreationParams params = {};
+		auto& vertexInput = params.vertexInput;
+		vertexInput.enabledAttribFlags = static_cast<uint16_t>(record.enabledAttribFlags);
+		vertexInput.enabledBindingFlags = static_cast<uint16_t>(record.enabledBindingFlags);
+		for (uint32_t i=0u; i<SVertexInputParams::MAX_VERTEX_ATTRIB_COUNT; i++)
+		{
+			vertexInput.attributes[i].binding = record.attributes[i].binding;
+			vertexInput.attributes[i].format = record.attributes[i].format;
+			vertexInput.attributes[i].relativeOffset = record.attributes[i].relativeOffset;
+		}
+		for (uint32_t i=0u; i<SVertexInputParams::MAX_ATTR_BUF_BINDING_COUNT; i++)
+		{
+			vertexInput.bindings[i].stride = record.bindings[i].stride;
+			vertexInput.bindings[i].inputRate = static_cast<SVertexInputBindingParams::E_VERTEX_INPUT_RATE>(record.bindings[i].inputRate);
+		}
+
+		params.primitiveAssembly.primitiveType = static_cast<E_PRIMITIVE_TOPOLOGY>(record.primitiveType);
+		params.primitiveAssembly.primitiveRestartEnable = record.primitiveRestartEnable;
+		params.primitiveAssembly.tessPatchVertCount = record.tessPatchVertCount;
+
+		auto& raster = params.rasterization;
+		raster.viewportCount = record.viewportCount;
+		raster.samplesLog2 = record.samplesLog2;
+		raster.depthClampEnable = record.depthClampEnable;
+		raster.rasterizerDiscard = record.rasterizerDiscard;
+		raster.polygonMode = static_cast<E_POLYGON_MODE>(record.polygonMode);
+		raster.faceCullingMode = static_cast<E_FACE_CULL_MODE>(record.faceCullingMode);
+		raster.frontFaceIsCCW = record.frontFaceIsCCW;
+		raster.depthBiasEnable = record.depthBiasEnable;
+		raster.alphaToCoverageEnable = record.alphaToCoverageEnable;
+		raster.alphaToOneEnable = record.alphaToOneEnable;
+		raster.depthWriteEnable = record.depthWriteEnable;
+		raster.depthCompareOp = static_cast<E_COMPARE_OP>(record.depthCompareOp);
+		raster.depthBoundsTestEnable = record.depthBoundsTestEnable;
+		raster.minSampleShadingUnorm = record.minSampleShadingUnorm;
+		auto fromStencilOps = [](SStencilOpParams& ops, const SPipeline::SStencilOps& in) -> void
+		{
+			ops.failOp = static_cast<E_STENCIL_OP>(in.failOp);
+			ops.passOp = static_cast<E_STENCIL_OP>(in.passOp);
+			ops.depthFailOp = static_cast<E_STENCIL_OP>(in.depthFailOp);
+			ops.compareOp = static_cast<E_COMPARE_OP>(in.compareOp);
+		};
+		fromStencilOps(raster.frontStencilOps,record.frontStencilOps);
+		fromStencilOps(raster.backStencilOps,record.backStencilOps);
+		raster.sampleMask[0] = record.sampleMask[0];
+		raster.sampleMask[1] = record.sampleMask[1];
+
+		for (uint32_t i=0u; i<IRenderpass::SCreationParams::SSubpassDescription::MaxColorAttachments; i++)
+		{
+			auto& blend = params.blend.blendParams[i];
+			blend.srcColorFactor = record.blend[i].srcColorFactor;
+			blend.dstColorFactor = record.blend[i].dstColorFactor;
+			blend.colorBlendOp = record.blend[i].colorBlendOp;
+			blend.srcAlphaFactor = record.blend[i].srcAlphaFactor;
+			blend.dstAlphaFactor = record.blend[i].dstAlphaFactor;
+			blend.alphaBlendOp = record.blend[i].alphaBlendOp;
+			blend.colorWriteMask = record.blend[i].colorWriteMask;
+		}
+		params.blend.logicOp = static_cast<E_LOGIC_OP>(record.logicOp);
+		return params;
+	}
+};
+// records get written with `sizeof`, so they can't end in padding the compiler doesn't zero
+static_assert(sizeof(SNBLFormat::SPipeline)%alignof(uint64_t)==0u);
+static_assert(sizeof(SNBLFormat::SMeshBuffer)%alignof(uint64_t)==0u);
+
+}
+
+#endif
@@ -0,0 +1,272 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/asset/utils/CAssetContentHasher.h"
+
+#include "nbl/core/xxHash256.h"
+
+#include "nbl/asset/ICPUImage.h"
+#include "nbl/asset/ICPUSampler.h"
+#include "nbl/asset/ICPUMesh.h"
+
+using namespace nbl;
+using namespace nbl::asset;
+
+namespace
+{
+// everything but the buffer contents gets serialized field by field before hashing, so padding never leaks into the hash
+class CSerializer
+{
+	public:
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		inline void write(const T& value)
+		{
+			const auto* ptr = reinterpret_cast<const uint8_t*>(&value);
+			m_bytes.insert(m_bytes.end(),ptr,ptr+sizeof(T));
+		}
+		inline void write(const void* data, const size_t size)
+		{
+			write<uint64_t>(size);
+			const auto* ptr = reinterpret_cast<const uint8_t*>(data);
+			m_bytes.insert(m_bytes.end(),ptr,ptr+size);
+		}
+		inline void write(const std::string& str) { write(str.data(),str.size()); }
+
+		inline CAssetContentHasher::hash_t finalize() const { return core::XXHash_256(m_bytes.data(),m_bytes.size()); }
+
+	private:
+		core::vector<uint8_t> m_bytes;
+};
+}
+
+bool CAssetContentHasher::isSupported(const IAsset::E_TYPE type)
+{
+	switch (type)
+	{
+		case IAsset::ET_BUFFER: [[fallthrough]];
+		case IAsset::ET_IMAGE: [[fallthrough]];
+		case IAsset::ET_SAMPLER: [[fallthrough]];
+		case IAsset::ET_SHADER: [[fallthrough]];
+		case IAsset::ET_RENDERPASS_INDEPENDENT_PIPELINE: [[fallthrough]];
+		case IAsset::ET_SUB_MESH: [[fallthrough]];
+		case IAsset::ET_MESH:
+			return true;
+		default:
+			break;
+	}
+	return false;
+}
+
+CAssetContentHasher::hash_t CAssetContentHasher::hash(const IAsset* asset)
+{
+	if (!asset)
+		return {};
+	if (auto found=m_memo.find(asset); found!=m_memo.end())
+		return found->second;
+
+	CSerializer out;
+	const auto type = asset->getAssetType();
+	out.write(type);
+	// a reference to an asset we can't look into
+	auto writeIdentity = [&out](const IAsset* dependency) -> void
+	{
+		out.write(reinterpret_cast<uintptr_t>(dependency));
+	};
+	auto writeBinding = [&](const SBufferBinding<const ICPUBuffer>& binding) -> void
+	{
+		out.write(binding.offset);
+		out.write(hash(binding.buffer.get()));
+	};
+	auto writeBoundingBox = [&out](const core::aabbox3df& box) -> void
+	{
+		const float edges[] = {box.MinEdge.X,box.MinEdge.Y,box.MinEdge.Z,box.MaxEdge.X,box.MaxEdge.Y,box.MaxEdge.Z};
+		out.write(edges);
+	};
+
+	if (!isSupported(type) || asset->isADummyObjectForCache())
+		writeIdentity(asset);
+	else switch (type)
+	{
+		case IAsset::ET_BUFFER:
+		{
+			const auto* buffer = static_cast<const ICPUBuffer*>(asset);
+			// not the usage, the setters of whatever references a buffer add the flags they need to it
+			out.write(buffer->getSize());
+			const auto* contents = reinterpret_cast<const uint8_t*>(buffer->getPointer());
+			// the contents get hashed on their own, no need to copy them
+			if (contents)
+				out.write(core::XXHash_256(contents,buffer->getSize()));
+			else
+				writeIdentity(asset);
+			break;
+		}
+		case IAsset::ET_IMAGE:
+		{
+			const auto* image = static_cast<const ICPUImage*>(asset);
+			const auto& params = image->getCreationParameters();
+			out.write(params.type);
+			out.write(params.samples);
+			out.write(params.format);
+			out.write(params.extent);
+			out.write(params.mipLevels);
+			out.write(params.arrayLayers);
+			out.write(params.flags.value);
+			out.write(params.usage.value);
+			out.write(params.stencilUsage.value);
+			for (uint32_t f=0u; f<params.viewFormats.size(); f++)
+			if (params.viewFormats.test(f))
+				out.write(f);
+			const auto regions = image->getRegions();
+			out.write<uint64_t>(regions.size());
+			for (const auto& region : regions)
+			{
+				out.write(region.bufferOffset);
+				out.write(region.bufferRowLength);
+				out.write(region.bufferImageHeight);
+				out.write(region.imageSubresource.aspectMask.value);
+				out.write(region.imageSubresource.mipLevel);
+				out.write(region.imageSubresource.baseArrayLayer);
+				out.write(region.imageSubresource.layerCount);
+				out.write(region.imageOffset);
+				out.write(region.imageExtent);
+			}
+			out.write(hash(image->getBuffer()));
+			break;
+		}
+		case IAsset::ET_SAMPLER:
+		{
+			const auto& params = static_cast<const ICPUSampler*>(asset)->getParams();
+			// bitfields, can't take their address
+			const uint32_t bitfields[] = {
+				params.TextureWrapU,params.TextureWrapV,params.TextureWrapW,params.BorderColor,params.MinFilter,
+				params.MaxFilter,params.MipmapMode,params.AnisotropicFilter,params.CompareEnable,params.CompareFunc
+			};
+			out.write(bitfields);
+			out.write(params.LodBias);
+			out.write(params.MinLod);
+			out.write(params.MaxLod);
+			break;
+		}
+		case IAsset::ET_SHADER:
+		{
+			const auto* shader = static_cast<const ICPUShader*>(asset);
+			out.write(shader->getStage());
+			out.write(shader->getContentType());
+			// sources resolve their relative includes against the path
+			if (shader->getContentType()!=IShader::E_CONTENT_TYPE::ECT_SPIRV)
+				out.write(shader->getFilepathHint());
+			out.write(hash(shader->getContent()));
+			break;
+		}
+		case IAsset::ET_RENDERPASS_INDEPENDENT_PIPELINE:
+		{
+			const auto* pipeline = static_cast<const ICPURenderpassIndependentPipeline*>(asset);
+			// same as `canBeRestoredFrom` compares them, but field by field as they're bitfields whose padding bits are garbage
+			const auto& params = pipeline->getCachedCreationParams();
+			out.write(params.vertexInput.enabledAttribFlags);
+			out.write(params.vertexInput.enabledBindingFlags);
+			for (const auto& attribute : params.vertexInput.attributes)
+			{
+				const uint32_t bitfields[] = {attribute.binding,attribute.format,attribute.relativeOffset};
+				out.write(bitfields);
+			}
+			for (const auto& binding : params.vertexInput.bindings)
+			{
+				const uint32_t bitfields[] = {binding.stride,binding.inputRate};
+				out.write(bitfields);
+			}
+			{
+				const auto& assembly = params.primitiveAssembly;
+				const auto& raster = params.rasterization;
+				const uint32_t bitfields[] = {
+					assembly.primitiveType,assembly.primitiveRestartEnable,assembly.tessPatchVertCount,
+					raster.viewportCount,raster.samplesLog2,raster.depthClampEnable,raster.rasterizerDiscard,raster.polygonMode,
+					raster.faceCullingMode,raster.frontFaceIsCCW,raster.depthBiasEnable,raster.alphaToCoverageEnable,raster.alphaToOneEnable,
+					raster.depthWriteEnable,raster.depthCompareOp,raster.depthBoundsTestEnable,raster.minSampleShadingUnorm,
+					raster.frontStencilOps.failOp,raster.frontStencilOps.passOp,raster.frontStencilOps.depthFailOp,raster.frontStencilOps.compareOp,
+					raster.backStencilOps.failOp,raster.backStencilOps.passOp,raster.backStencilOps.depthFailOp,raster.backStencilOps.compareOp
+				};
+				out.write(bitfields);
+				out.write(raster.sampleMask);
+			}
+			for (const auto& blend : params.blend.blendParams)
+			{
+				const uint32_t bitfields[] = {
+					blend.srcColorFactor,blend.dstColorFactor,blend.colorBlendOp,
+					blend.srcAlphaFactor,blend.dstAlphaFactor,blend.alphaBlendOp,blend.colorWriteMask
+				};
+				out.write(bitfields);
+			}
+			out.write<uint32_t>(params.blend.logicOp);
+			writeIdentity(pipeline->getLayout());
+			for (uint32_t i=0u; i<ICPURenderpassIndependentPipeline::GRAPHICS_SHADER_STAGE_COUNT; i++)
+			{
+				const auto info = pipeline->getSpecInfo(static_cast<ICPUShader::E_SHADER_STAGE>(0x1u<<i));
+				out.write(hash(info.shader));
+				if (!info.shader)
+					continue;
+				out.write(info.entryPoint);
+				out.write<uint8_t>(static_cast<uint8_t>(info.requiredSubgroupSize));
+				out.write<uint8_t>(info.requireFullSubgroups);
+				// the map is unordered
+				core::vector<ICPUShader::SSpecInfo::spec_constant_id_t> ids;
+				if (info.entries)
+				for (const auto& entry : *info.entries)
+					ids.push_back(entry.first);
+				std::sort(ids.begin(),ids.end());
+				out.write<uint64_t>(ids.size());
+				for (const auto id : ids)
+				{
+					const auto value = info.entries->find(id)->second;
+					out.write(id);
+					out.write(value.data,value.size);
+				}
+			}
+			break;
+		}
+		case IAsset::ET_SUB_MESH:
+		{
+			const auto* meshbuffer = static_cast<const ICPUMeshBuffer*>(asset);
+			for (uint32_t i=0u; i<ICPUMeshBuffer::MAX_ATTR_BUF_BINDING_COUNT; i++)
+				writeBinding(meshbuffer->getVertexBufferBindings()[i]);
+			writeBinding(meshbuffer->getIndexBufferBinding());
+			writeBinding(meshbuffer->getInverseBindPoseBufferBinding());
+			writeBinding(meshbuffer->getJointAABBBufferBinding());
+			writeIdentity(meshbuffer->getAttachedDescriptorSet());
+			out.write(hash(meshbuffer->getPipeline()));
+			const uint8_t* pushConstants = meshbuffer->getPushConstantsDataPtr();
+			out.write(pushConstants,ICPUMeshBuffer::MAX_PUSH_CONSTANT_BYTESIZE);
+			out.write(meshbuffer->getIndexType());
+			out.write(meshbuffer->getIndexCount());
+			out.write(meshbuffer->getInstanceCount());
+			out.write(meshbuffer->getBaseVertex());
+			out.write(meshbuffer->getBaseInstance());
+			out.write<uint32_t>(meshbuffer->getJointCount());
+			out.write<uint32_t>(meshbuffer->getMaxJointsPerVertex());
+			out.write(meshbuffer->getPositionAttributeIx());
+			out.write(meshbuffer->getNormalAttributeIx());
+			out.write(meshbuffer->getJointIDAttributeIx());
+			out.write(meshbuffer->getJointWeightAttributeIx());
+			writeBoundingBox(meshbuffer->getBoundingBox());
+			break;
+		}
+		case IAsset::ET_MESH:
+		{
+			const auto* mesh = static_cast<const ICPUMesh*>(asset);
+			const auto meshbuffers = mesh->getMeshBuffers();
+			out.write<uint64_t>(meshbuffers.size());
+			for (const auto* meshbuffer : meshbuffers)
+				out.write(hash(meshbuffer));
+			writeBoundingBox(mesh->getBoundingBox());
+			break;
+		}
+		default:
+			assert(false);
+			break;
+	}
+
+	const auto retval = out.finalize();
+	m_memo[asset] = retval;
+	return retval;
+}
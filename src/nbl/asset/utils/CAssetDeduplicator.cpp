@@ -0,0 +1,259 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/asset/utils/CAssetDeduplicator.h"
+
+#include "nbl/asset/ICPUImage.h"
+#include "nbl/asset/ICPUMesh.h"
+
+using namespace nbl;
+using namespace nbl::asset;
+
+// the hashes are only valid while nothing changes, so every call hashes anew
+struct CAssetDeduplicator::SPass
+{
+	CAssetContentHasher hasher;
+	const IAssetMetadata* metadata;
+	const IAsset* root;
+	bool onlyDependencies;
+	core::unordered_map<const IAsset*,core::smart_refctd_ptr<IAsset>> replacements;
+	// assets with metadata and everything referencing them, these must stay as they are
+	core::unordered_set<const IAsset*> pinned;
+};
+
+namespace
+{
+bool hasMetadata(const IAssetMetadata* metadata, const IAsset* asset)
+{
+	if (metadata)
+	switch (asset->getAssetType())
+	{
+		case IAsset::ET_IMAGE:
+			return metadata->getAssetSpecificMetadata(static_cast<const ICPUImage*>(asset));
+		case IAsset::ET_RENDERPASS_INDEPENDENT_PIPELINE:
+			return metadata->getAssetSpecificMetadata(static_cast<const ICPURenderpassIndependentPipeline*>(asset));
+		case IAsset::ET_MESH:
+			return metadata->getAssetSpecificMetadata(static_cast<const ICPUMesh*>(asset));
+		default:
+			break;
+	}
+	return false;
+}
+}
+
+core::smart_refctd_ptr<IAsset> CAssetDeduplicator::deduplicate(IAsset* asset, const IAssetMetadata* metadata, const bool onlyDependencies)
+{
+	SPass pass = {.metadata=metadata,.root=asset,.onlyDependencies=onlyDependencies};
+	return deduplicate_impl(pass,asset);
+}
+
+CAssetDeduplicator::SStatistics CAssetDeduplicator::getStatistics() const
+{
+	std::unique_lock lock(m_lock);
+	return m_statistics;
+}
+
+void CAssetDeduplicator::clear()
+{
+	std::unique_lock lock(m_lock);
+	m_firstSeen.clear();
+	m_held.clear();
+	m_statistics = {};
+}
+
+uint32_t CAssetDeduplicator::getHeldReferenceCount(const IAsset* asset) const
+{
+	std::unique_lock lock(m_lock);
+	const auto found = m_held.find(asset);
+	return found!=m_held.end() ? found->second:0u;
+}
+
+void CAssetDeduplicator::releaseUnused()
+{
+	std::unique_lock lock(m_lock);
+	// dropping a mesh can leave its meshbuffers only referenced by us, and those their buffers
+	for (bool released=true; released;)
+	{
+		released = false;
+		for (auto it=m_firstSeen.begin(); it!=m_firstSeen.end();)
+		{
+			const auto held = m_held.find(it->second.get());
+			if (static_cast<uint32_t>(it->second->getReferenceCount())>held->second)
+			{
+				it++;
+				continue;
+			}
+			if (--held->second==0u)
+				m_held.erase(held);
+			it = m_firstSeen.erase(it);
+			released = true;
+		}
+	}
+}
+
+core::smart_refctd_ptr<IAsset> CAssetDeduplicator::deduplicate_impl(SPass& pass, IAsset* asset)
+{
+	if (!asset)
+		return nullptr;
+	if (auto found=pass.replacements.find(asset); found!=pass.replacements.end())
+		return found->second;
+
+	bool pinned = hasMetadata(pass.metadata,asset) || (pass.onlyDependencies && asset==pass.root);
+	auto dependency = [&](IAsset* dep) -> core::smart_refctd_ptr<IAsset>
+	{
+		auto replacement = deduplicate_impl(pass,dep);
+		pinned = pinned || pass.pinned.contains(replacement.get());
+		return replacement;
+	};
+	auto replaceBuffer = [&](ICPUBuffer* buffer, const core::bitflag<IBuffer::E_USAGE_FLAGS> usage) -> core::smart_refctd_ptr<ICPUBuffer>
+	{
+		auto replacement = core::smart_refctd_ptr_static_cast<ICPUBuffer>(dependency(buffer));
+		if (replacement.get()==buffer)
+			return nullptr;
+		// the setter will need to add the usage, other passes could be adding theirs to the same buffer
+		std::unique_lock lock(m_lock);
+		if (!replacement->isMutable() && (replacement->getUsageFlags()&usage)!=usage)
+			return nullptr;
+		return replacement;
+	};
+	// bottom-up, so that the hash of the asset is already the one of what it references after the pass
+	const auto type = asset->getAssetType();
+	if (asset->isMutable())
+	switch (type)
+	{
+		case IAsset::ET_IMAGE:
+		{
+			auto* image = static_cast<ICPUImage*>(asset);
+			if (auto buffer=replaceBuffer(image->getBuffer(),IBuffer::EUF_NONE))
+			{
+				std::unique_lock lock(m_lock);
+				image->setBufferAndRegions(std::move(buffer),image->getRegionArray());
+			}
+			break;
+		}
+		case IAsset::ET_RENDERPASS_INDEPENDENT_PIPELINE:
+		{
+			auto* pipeline = static_cast<ICPURenderpassIndependentPipeline*>(asset);
+			for (uint32_t i=0u; i<ICPURenderpassIndependentPipeline::GRAPHICS_SHADER_STAGE_COUNT; i++)
+			{
+				auto info = pipeline->getSpecInfo(static_cast<ICPUShader::E_SHADER_STAGE>(0x1u<<i));
+				if (!info.shader)
+					continue;
+				auto shader = dependency(info.shader);
+				if (shader.get()==info.shader)
+					continue;
+				info.shader = static_cast<ICPUShader*>(shader.get());
+				// `setSpecInfo` frees the map it copies from
+				ICPUShader::SSpecInfo::spec_constant_map_t entries;
+				if (info.entries)
+				{
+					entries = *info.entries;
+					info.entries = &entries;
+				}
+				pipeline->setSpecInfo(info);
+			}
+			break;
+		}
+		case IAsset::ET_SUB_MESH:
+		{
+			auto* meshbuffer = static_cast<ICPUMeshBuffer*>(asset);
+			for (uint32_t i=0u; i<ICPUMeshBuffer::MAX_ATTR_BUF_BINDING_COUNT; i++)
+			{
+				const auto& binding = meshbuffer->getVertexBufferBindings()[i];
+				if (auto buffer=replaceBuffer(binding.buffer.get(),IBuffer::EUF_VERTEX_BUFFER_BIT))
+				{
+					std::unique_lock lock(m_lock);
+					meshbuffer->setVertexBufferBinding({binding.offset,std::move(buffer)},i);
+				}
+			}
+			{
+				const auto& binding = meshbuffer->getIndexBufferBinding();
+				if (auto buffer=replaceBuffer(binding.buffer.get(),IBuffer::EUF_INDEX_BUFFER_BIT))
+				{
+					std::unique_lock lock(m_lock);
+					meshbuffer->setIndexBufferBinding({binding.offset,std::move(buffer)});
+				}
+			}
+			if (meshbuffer->isSkinned())
+			{
+				SBufferBinding<ICPUBuffer> inverseBindPose = meshbuffer->getInverseBindPoseBufferBinding();
+				SBufferBinding<ICPUBuffer> jointAABBs = meshbuffer->getJointAABBBufferBinding();
+				auto inverseBindPoseBuffer = replaceBuffer(inverseBindPose.buffer.get(),IBuffer::EUF_NONE);
+				auto jointAABBBuffer = replaceBuffer(jointAABBs.buffer.get(),IBuffer::EUF_NONE);
+				if (inverseBindPoseBuffer || jointAABBBuffer)
+				{
+					if (inverseBindPoseBuffer)
+						inverseBindPose.buffer = std::move(inverseBindPoseBuffer);
+					if (jointAABBBuffer)
+						jointAABBs.buffer = std::move(jointAABBBuffer);
+					std::unique_lock lock(m_lock);
+					meshbuffer->setSkin(std::move(inverseBindPose),std::move(jointAABBs),meshbuffer->getJointCount(),meshbuffer->getMaxJointsPerVertex());
+				}
+			}
+			if (auto* pipeline=meshbuffer->getPipeline())
+			{
+				auto replacement = dependency(pipeline);
+				if (replacement.get()!=pipeline)
+					meshbuffer->setPipeline(core::smart_refctd_ptr_static_cast<ICPURenderpassIndependentPipeline>(std::move(replacement)));
+			}
+			break;
+		}
+		case IAsset::ET_MESH:
+		{
+			for (auto& meshbuffer : static_cast<ICPUMesh*>(asset)->getMeshBufferVector())
+			{
+				auto replacement = dependency(meshbuffer.get());
+				if (replacement.get()!=meshbuffer.get())
+					meshbuffer = core::smart_refctd_ptr_static_cast<ICPUMeshBuffer>(std::move(replacement));
+			}
+			break;
+		}
+		default:
+			break;
+	}
+
+	core::smart_refctd_ptr<IAsset> retval(asset);
+	if (CAssetContentHasher::isSupported(type) && !asset->isADummyObjectForCache())
+	{
+		// hashing is what takes long, so the lock is only held for the lookups
+		const auto hash = pass.hasher.hash(asset);
+		core::smart_refctd_ptr<IAsset> firstSeen;
+		{
+			std::unique_lock lock(m_lock);
+			auto [found,inserted] = m_firstSeen.try_emplace(hash,retval);
+			if (inserted)
+				m_held[asset]++;
+			else
+				firstSeen = found->second;
+		}
+		if (firstSeen && firstSeen.get()!=asset)
+		{
+			// it could have been modified since we've seen it
+			const bool modified = pass.hasher.hash(firstSeen.get())!=hash;
+			std::unique_lock lock(m_lock);
+			if (modified)
+			{
+				// unless another pass replaced it already
+				auto found = m_firstSeen.find(hash);
+				if (found!=m_firstSeen.end() && found->second==firstSeen)
+				{
+					if (auto held=m_held.find(firstSeen.get()); --held->second==0u)
+						m_held.erase(held);
+					found->second = retval;
+					m_held[asset]++;
+				}
+			}
+			else if (!pinned)
+			{
+				m_statistics.duplicates++;
+				m_statistics.bytesSaved += asset->conservativeSizeEstimate();
+				retval = std::move(firstSeen);
+			}
+		}
+	}
+	if (pinned)
+		pass.pinned.insert(asset);
+	pass.replacements[asset] = retval;
+	return retval;
+}
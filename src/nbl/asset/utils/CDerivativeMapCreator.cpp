@@ -1,5 +1,7 @@
 #include "nbl/asset/utils/CDerivativeMapCreator.h"
 
+#include "nbl/core/containers/CFrameArena.h"
+
 #include "nbl/asset/filters/CSwizzleAndConvertImageFilter.h"
 #include "nbl/asset/filters/CBlitImageFilter.h"
 #include "nbl/asset/interchange/IImageAssetHandlerBase.h"
@@ -111,7 +113,10 @@ core::smart_refctd_ptr<ICPUImage> CDerivativeMapCreator::createDerivativeMapFrom
 	state.axisWraps[2] = ISampler::ETC_CLAMP_TO_EDGE;
 	state.borderColor = _borderColor;
 	state.scratchMemoryByteSize = DerivativeMapFilter::getRequiredScratchByteSize(&state);
-	state.scratchMemory = reinterpret_cast<uint8_t*>(_NBL_ALIGNED_MALLOC(state.scratchMemoryByteSize, _NBL_SIMD_ALIGNMENT));
+	core::CFrameArena::SScratch scratch(core::CFrameArena::getThreadLocal(),state.scratchMemoryByteSize);
+	if (!scratch.get())
+		return nullptr;
+	state.scratchMemory = reinterpret_cast<uint8_t*>(scratch.get());
 
 	state.recomputeScaledKernelPhasedLUT();
 	const bool result = DerivativeMapFilter::execute(core::execution::par_unseq,&state);
@@ -122,8 +127,6 @@ core::smart_refctd_ptr<ICPUImage> CDerivativeMapCreator::createDerivativeMapFrom
 			out_normalizationFactor[1] = state.normalization.maxAbsPerChannel[1];
 	}
 
-	_NBL_ALIGNED_FREE(state.scratchMemory);
-
 	return outImg;
 }
 
@@ -0,0 +1,121 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/core/alloc/AddressAllocatorTelemetry.h"
+
+#ifdef _NBL_ALLOCATOR_TELEMETRY_
+#include <sstream>
+
+using namespace nbl;
+using namespace nbl::core;
+
+
+IAddressAllocatorTelemetrySource::~IAddressAllocatorTelemetrySource()
+{
+    unregisterTelemetry();
+}
+
+void IAddressAllocatorTelemetrySource::registerTelemetry(const void* object, telemetry_getter_t getter)
+{
+    auto& registry = CAddressAllocatorTelemetryRegistry::get();
+    std::lock_guard lock(registry.mutex);
+    registry.sources[this] = {object,getter};
+}
+
+void IAddressAllocatorTelemetrySource::unregisterTelemetry()
+{
+    auto& registry = CAddressAllocatorTelemetryRegistry::get();
+    std::lock_guard lock(registry.mutex);
+    registry.sources.erase(this);
+}
+
+
+CAddressAllocatorTelemetryRegistry& CAddressAllocatorTelemetryRegistry::get()
+{
+    // never destroyed, so that allocators with static storage duration can still unregister during shutdown
+    static auto* registry = new CAddressAllocatorTelemetryRegistry();
+    return *registry;
+}
+
+std::vector<SAddressAllocatorTelemetry> CAddressAllocatorTelemetryRegistry::snapshot() const
+{
+    std::vector<SAddressAllocatorTelemetry> retval;
+    std::lock_guard lock(mutex);
+    retval.reserve(sources.size());
+    for (const auto& [source,registration] : sources)
+    {
+        SAddressAllocatorTelemetry telemetry;
+        if (registration.getter(registration.object,telemetry))
+            retval.push_back(telemetry);
+    }
+    return retval;
+}
+
+std::string CAddressAllocatorTelemetryRegistry::dumpJSON() const
+{
+    auto writeString = [](std::ostringstream& json, const char* str) -> void
+    {
+        if (!str)
+        {
+            json << "null";
+            return;
+        }
+        json << '"';
+        for (; *str; str++)
+        switch (*str)
+        {
+            case '"':
+                json << "\\\"";
+                break;
+            case '\\':
+                json << "\\\\";
+                break;
+            default:
+                if (static_cast<unsigned char>(*str)<0x20u)
+                    json << ' ';
+                else
+                    json << *str;
+                break;
+        }
+        json << '"';
+    };
+
+    std::ostringstream json;
+    json << "{\"allocators\":[";
+    bool first = true;
+    for (const auto& telemetry : snapshot())
+    {
+        if (!first)
+            json << ',';
+        first = false;
+
+        json << "{\"type\":";
+        writeString(json,telemetry.type);
+        json << ",\"label\":";
+        writeString(json,telemetry.label);
+        json << ",\"totalSize\":" << telemetry.totalSize;
+        json << ",\"allocatedSize\":" << telemetry.allocatedSize;
+        json << ",\"peakAllocatedSize\":" << telemetry.peakAllocatedSize;
+        json << ",\"freeSize\":" << telemetry.freeSize;
+        json << ",\"largestFreeBlock\":" << telemetry.largestFreeBlock;
+        json << ",\"allocCount\":" << telemetry.allocCount;
+        json << ",\"freeCount\":" << telemetry.freeCount;
+        json << ",\"failedAllocCount\":" << telemetry.failedAllocCount;
+
+        uint32_t bucketCount = SAddressAllocatorTelemetry::HistogramBuckets;
+        while (bucketCount && !telemetry.freeBlockHistogram[bucketCount-1u])
+            bucketCount--;
+        json << ",\"freeBlockHistogram\":[";
+        for (uint32_t i=0u; i<bucketCount; i++)
+        {
+            if (i)
+                json << ',';
+            json << telemetry.freeBlockHistogram[i];
+        }
+        json << "]}";
+    }
+    json << "]}";
+    return json.str();
+}
+#endif // _NBL_ALLOCATOR_TELEMETRY_
@@ -0,0 +1,14 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/core/containers/CFrameArena.h"
+
+using namespace nbl;
+using namespace core;
+
+CFrameArena& CFrameArena::getThreadLocal()
+{
+    thread_local CFrameArena arena;
+    return arena;
+}
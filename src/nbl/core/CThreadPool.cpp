@@ -0,0 +1,182 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/core/parallel/CThreadPool.h"
+
+#include <deque>
+
+using namespace nbl;
+using namespace core;
+
+struct alignas(64) CThreadPool::SQueue
+{
+    std::mutex lock;
+    std::deque<STask> tasks;
+};
+
+namespace
+{
+    // which pool the current thread is a worker of, if any
+    thread_local const CThreadPool* tl_pool = nullptr;
+    thread_local uint32_t tl_workerIx = 0u;
+
+    std::atomic_uint32_t g_defaultPoolWorkerCount = CThreadPool::getDefaultWorkerCount();
+    std::atomic_bool g_defaultPoolCreated = false;
+}
+
+CThreadPool::CThreadPool(uint32_t workerCount) : m_workerCount(workerCount)
+{
+    m_queues = new SQueue[m_workerCount+1u];
+    m_workers = new std::thread[m_workerCount];
+    for (uint32_t i=0u; i<m_workerCount; i++)
+        m_workers[i] = std::thread(&CThreadPool::workerLoop,this,i);
+}
+
+CThreadPool::~CThreadPool()
+{
+    {
+        std::unique_lock lock(m_sleepMutex);
+        m_stop = true;
+        m_wakeEpoch++;
+    }
+    m_sleepCondition.notify_all();
+    for (uint32_t i=0u; i<m_workerCount; i++)
+        m_workers[i].join();
+    delete[] m_workers;
+    delete[] m_queues;
+}
+
+CThreadPool& CThreadPool::getDefault()
+{
+    static CThreadPool pool([]() -> uint32_t
+    {
+        g_defaultPoolCreated = true;
+        return g_defaultPoolWorkerCount.load();
+    }());
+    return pool;
+}
+
+bool CThreadPool::setDefaultPoolWorkerCount(uint32_t workerCount)
+{
+    if (g_defaultPoolCreated)
+        return false;
+    g_defaultPoolWorkerCount = workerCount;
+    return true;
+}
+
+void CThreadPool::run(SJob& job)
+{
+    const uint32_t ownQueueIx = getOwnQueueIndex();
+    executeTask(ownQueueIx,{&job,0ull,job.pending.load(std::memory_order_relaxed)});
+    // help out with whatever there is to do until our job is finished, this is what makes nesting safe
+    for (uint32_t idleSpins=0u; job.pending.load(std::memory_order_acquire); )
+    {
+        STask task;
+        if (tryGetTask(ownQueueIx,task))
+        {
+            executeTask(ownQueueIx,task);
+            idleSpins = 0u;
+        }
+        else if (++idleSpins>64u)
+            std::this_thread::yield();
+    }
+}
+
+uint32_t CThreadPool::getOwnQueueIndex() const
+{
+    return tl_pool==this ? tl_workerIx:m_workerCount;
+}
+
+void CThreadPool::push(const uint32_t queueIx, const STask& task)
+{
+    {
+        std::unique_lock lock(m_queues[queueIx].lock);
+        m_queues[queueIx].tasks.push_back(task);
+    }
+    // pairs up with the fence in `workerLoop`, either the sleeper sees the task or we see the sleeper
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_relaxed))
+    {
+        {
+            std::unique_lock lock(m_sleepMutex);
+            m_wakeEpoch++;
+        }
+        m_sleepCondition.notify_one();
+    }
+}
+
+bool CThreadPool::tryGetTask(const uint32_t ownQueueIx, STask& task)
+{
+    // own work is hot in cache, so LIFO
+    {
+        auto& queue = m_queues[ownQueueIx];
+        std::unique_lock lock(queue.lock);
+        if (!queue.tasks.empty())
+        {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+    // steal the oldest, which are the biggest ranges
+    const uint32_t queueCount = m_workerCount+1u;
+    for (uint32_t i=1u; i<queueCount; i++)
+    {
+        auto& queue = m_queues[(ownQueueIx+i)%queueCount];
+        std::unique_lock lock(queue.lock,std::try_to_lock);
+        if (lock.owns_lock() && !queue.tasks.empty())
+        {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void CThreadPool::executeTask(const uint32_t ownQueueIx, STask task)
+{
+    SJob& job = *task.job;
+    while (task.end-task.begin>job.grainSize)
+    {
+        const size_t middle = task.begin+(task.end-task.begin)/2ull;
+        push(ownQueueIx,{task.job,middle,task.end});
+        task.end = middle;
+    }
+    job.execute(job.context,task.begin,task.end);
+    // the job lives on the stack of the thread waiting for it, can't touch it after this
+    job.pending.fetch_sub(task.end-task.begin,std::memory_order_release);
+}
+
+void CThreadPool::workerLoop(const uint32_t workerIx)
+{
+    tl_pool = this;
+    tl_workerIx = workerIx;
+    while (true)
+    {
+        STask task;
+        if (tryGetTask(workerIx,task))
+        {
+            executeTask(workerIx,task);
+            continue;
+        }
+
+        std::unique_lock lock(m_sleepMutex);
+        if (m_stop)
+            return;
+        const uint64_t epoch = m_wakeEpoch;
+        m_sleeping.fetch_add(1u,std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // a task could have been pushed before we announced we're going to sleep
+        bool anyWork = false;
+        for (uint32_t i=0u; !anyWork && i<=m_workerCount; i++)
+        {
+            std::unique_lock queueLock(m_queues[i].lock);
+            anyWork = !m_queues[i].tasks.empty();
+        }
+        if (!anyWork)
+            m_sleepCondition.wait(lock,[&]() -> bool {return m_wakeEpoch!=epoch;});
+        m_sleeping.fetch_sub(1u,std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,104 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/core/util/cpu_features.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define _NBL_CPU_FEATURES_X86_
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+using namespace nbl;
+using namespace nbl::core;
+
+#ifdef _NBL_CPU_FEATURES_X86_
+namespace
+{
+    void cpuid(uint32_t out[4], const uint32_t leaf, const uint32_t subleaf)
+    {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int regs[4];
+        __cpuidex(regs,leaf,subleaf);
+        for (auto i=0; i<4; i++)
+            out[i] = static_cast<uint32_t>(regs[i]);
+    #else
+        __cpuid_count(leaf,subleaf,out[0],out[1],out[2],out[3]);
+    #endif
+    }
+
+    // which register states the OS saves on a context switch
+    uint64_t xgetbv0()
+    {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        return _xgetbv(0);
+    #else
+        uint32_t eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (uint64_t(edx)<<32u)|eax;
+    #endif
+    }
+
+    SCPUFeatures detect()
+    {
+        SCPUFeatures retval;
+
+        uint32_t regs[4];
+        cpuid(regs,0u,0u);
+        const uint32_t maxLeaf = regs[0];
+        // "AuthenticAMD" spread over EBX, EDX and ECX
+        const bool amd = regs[1]==0x68747541u && regs[3]==0x69746e65u && regs[2]==0x444d4163u;
+        if (maxLeaf<1u)
+            return retval;
+
+        cpuid(regs,1u,0u);
+        const uint32_t baseFamily = (regs[0]>>8u)&0xfu;
+        const uint32_t family = baseFamily==0xfu ? (baseFamily+((regs[0]>>20u)&0xffu)):baseFamily;
+        const uint32_t ecx1 = regs[2];
+        retval.sse42 = ecx1&(0x1u<<20u);
+        retval.popcnt = ecx1&(0x1u<<23u);
+
+        const bool osxsave = ecx1&(0x1u<<27u);
+        const uint64_t xcr0 = osxsave ? xgetbv0():0ull;
+        // XMM and YMM state
+        const bool osAVX = (xcr0&0x6ull)==0x6ull;
+        // and opmask plus both halves of ZMM state
+        const bool osAVX512 = osAVX && (xcr0&0xe0ull)==0xe0ull;
+
+        retval.avx = osAVX && (ecx1&(0x1u<<28u));
+        retval.fma = retval.avx && (ecx1&(0x1u<<12u));
+        retval.f16c = retval.avx && (ecx1&(0x1u<<29u));
+
+        if (maxLeaf<7u)
+            return retval;
+
+        cpuid(regs,7u,0u);
+        const uint32_t ebx7 = regs[1];
+        retval.bmi1 = ebx7&(0x1u<<3u);
+        retval.bmi2 = ebx7&(0x1u<<8u);
+        // Zen 3 is family 19h
+        retval.fastPdepPext = retval.bmi2 && !(amd && family<0x19u);
+        retval.avx2 = retval.avx && (ebx7&(0x1u<<5u));
+        retval.avx512f = osAVX512 && (ebx7&(0x1u<<16u));
+        retval.avx512bw = retval.avx512f && (ebx7&(0x1u<<30u));
+        retval.avx512vl = retval.avx512f && (ebx7&(0x1u<<31u));
+        return retval;
+    }
+}
+#endif
+
+const SCPUFeatures& nbl::core::getCPUFeatures()
+{
+#ifdef _NBL_CPU_FEATURES_X86_
+    static const SCPUFeatures features = detect();
+#else
+    static const SCPUFeatures features = {};
+#endif
+    return features;
+}
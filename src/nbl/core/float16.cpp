@@ -0,0 +1,174 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/core/math/floatutil.h"
+#include "nbl/core/util/cpu_features.h"
+
+#include <cstring>
+#include <immintrin.h>
+
+using namespace nbl;
+using namespace core;
+
+namespace
+{
+
+constexpr float MaxHalf = 65504.f;
+
+// same rounding as `vcvtps2ph` with round to nearest even, thanks to Fabian Giesen's `float_to_half_fast3_rtne`
+inline uint16_t encode_scalar(float value, const bool saturate)
+{
+    if (saturate)
+    {
+        // written so NaNs fall through
+        if (value>MaxHalf)
+            value = MaxHalf;
+        else if (value<-MaxHalf)
+            value = -MaxHalf;
+    }
+
+    uint32_t bits;
+    memcpy(&bits,&value,sizeof(float));
+    const uint32_t sign = (bits>>16u)&0x8000u;
+    bits &= 0x7fffffffu;
+
+    uint32_t retval;
+    // 65536.f and above, infinity or NaN (quietened, top of the payload kept)
+    if (bits>=0x47800000u)
+        retval = bits>0x7f800000u ? (0x7e00u|((bits>>13u)&0x3ffu)):0x7c00u;
+    // float16 subnormals, let the FPU round by adding a number with an exponent where the mantissa LSB is the smallest subnormal
+    else if (bits<0x38800000u)
+    {
+        constexpr uint32_t DenormMagicBits = ((127u-15u)+(23u-10u)+1u)<<23u;
+        float denormMagic, f;
+        memcpy(&denormMagic,&DenormMagicBits,sizeof(float));
+        memcpy(&f,&bits,sizeof(float));
+        f += denormMagic;
+        memcpy(&retval,&f,sizeof(float));
+        retval -= DenormMagicBits;
+    }
+    else
+    {
+        const uint32_t mantissaOdd = (bits>>13u)&0x1u;
+        // rebias the exponent and round, a carry out of the mantissa correctly bumps the exponent (up to infinity)
+        bits += (uint32_t(15-127)<<23u)+0xfffu+mantissaOdd;
+        retval = bits>>13u;
+    }
+    return static_cast<uint16_t>(retval|sign);
+}
+
+inline float decode_scalar(const uint16_t value)
+{
+    const uint32_t sign = uint32_t(value&0x8000u)<<16u;
+    const uint32_t exponent = (value>>10u)&0x1fu;
+    const uint32_t mantissa = value&0x3ffu;
+
+    uint32_t bits;
+    if (exponent==0u)
+    {
+        // zero or subnormal, which is exact as float32 arithmetic
+        const float magnitude = float(mantissa)*(1.f/16777216.f);
+        memcpy(&bits,&magnitude,sizeof(float));
+        bits |= sign;
+    }
+    else if (exponent==0x1fu)
+        bits = sign|0x7f800000u|(mantissa<<13u)|(mantissa ? 0x400000u:0u);
+    else
+        bits = sign|((exponent+112u)<<23u)|(mantissa<<13u);
+
+    float retval;
+    memcpy(&retval,&bits,sizeof(float));
+    return retval;
+}
+
+void encode_scalar(uint16_t* out, const float* in, size_t i, const size_t count, const bool saturate)
+{
+    for (; i<count; i++)
+        out[i] = encode_scalar(in[i],saturate);
+}
+
+void decode_scalar(float* out, const uint16_t* in, size_t i, const size_t count)
+{
+    for (; i<count; i++)
+        out[i] = decode_scalar(in[i]);
+}
+
+NBL_TARGET_ISA("avx,f16c") void encode_F16C(uint16_t* out, const float* in, const size_t count, const bool saturate)
+{
+    const __m256 maxHalf = _mm256_set1_ps(MaxHalf);
+    const __m256 minHalf = _mm256_set1_ps(-MaxHalf);
+    size_t i = 0ull;
+    for (; i+8u<=count; i+=8u)
+    {
+        __m256 v = _mm256_loadu_ps(in+i);
+        // NaN in the second operand gets returned by min and max
+        if (saturate)
+            v = _mm256_min_ps(maxHalf,_mm256_max_ps(minHalf,v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out+i),_mm256_cvtps_ph(v,_MM_FROUND_TO_NEAREST_INT|_MM_FROUND_NO_EXC));
+    }
+    encode_scalar(out,in,i,count,saturate);
+}
+
+NBL_TARGET_ISA("avx,f16c") void decode_F16C(float* out, const uint16_t* in, const size_t count)
+{
+    size_t i = 0ull;
+    for (; i+8u<=count; i+=8u)
+        _mm256_storeu_ps(out+i,_mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in+i))));
+    decode_scalar(out,in,i,count);
+}
+
+NBL_TARGET_ISA("avx512f,avx512bw,avx512vl") void encode_AVX512(uint16_t* out, const float* in, const size_t count, const bool saturate)
+{
+    const __m512 maxHalf = _mm512_set1_ps(MaxHalf);
+    const __m512 minHalf = _mm512_set1_ps(-MaxHalf);
+    size_t i = 0ull;
+    for (; i+16u<=count; i+=16u)
+    {
+        __m512 v = _mm512_loadu_ps(in+i);
+        if (saturate)
+            v = _mm512_min_ps(maxHalf,_mm512_max_ps(minHalf,v));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+i),_mm512_cvtps_ph(v,_MM_FROUND_TO_NEAREST_INT|_MM_FROUND_NO_EXC));
+    }
+    // the masked tail avoids a scalar loop of up to 15 elements
+    if (i<count)
+    {
+        const __mmask16 mask = static_cast<__mmask16>((0x1u<<(count-i))-1u);
+        __m512 v = _mm512_maskz_loadu_ps(mask,in+i);
+        if (saturate)
+            v = _mm512_min_ps(maxHalf,_mm512_max_ps(minHalf,v));
+        _mm256_mask_storeu_epi16(out+i,mask,_mm512_cvtps_ph(v,_MM_FROUND_TO_NEAREST_INT|_MM_FROUND_NO_EXC));
+    }
+}
+
+NBL_TARGET_ISA("avx512f") void decode_AVX512(float* out, const uint16_t* in, const size_t count)
+{
+    size_t i = 0ull;
+    for (; i+16u<=count; i+=16u)
+        _mm512_storeu_ps(out+i,_mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in+i))));
+    decode_scalar(out,in,i,count);
+}
+
+}
+
+void nbl::core::float32_to_float16(uint16_t* _out, const float* _in, size_t _count, bool _saturate)
+{
+    const auto& features = getCPUFeatures();
+    if (features.avx512f && features.avx512bw && features.avx512vl)
+        encode_AVX512(_out,_in,_count,_saturate);
+    else if (features.f16c)
+        encode_F16C(_out,_in,_count,_saturate);
+    else
+        encode_scalar(_out,_in,0ull,_count,_saturate);
+}
+
+void nbl::core::float16_to_float32(float* _out, const uint16_t* _in, size_t _count)
+{
+    const auto& features = getCPUFeatures();
+    if (features.avx512f)
+        decode_AVX512(_out,_in,_count);
+    else if (features.f16c)
+        decode_F16C(_out,_in,_count);
+    else
+        decode_scalar(_out,_in,0ull,_count);
+}
@@ -0,0 +1,264 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "matrix4SIMD.h"
+#include "nbl/core/util/cpu_features.h"
+
+#include <immintrin.h>
+
+using namespace nbl;
+using namespace core;
+
+namespace
+{
+
+//! Column major copy of the matrix, columns padded with zeros to 4 rows, the last one being the translation (or zero for directions)
+struct SColumns
+{
+    alignas(64) float c[4][4];
+
+    SColumns(const vectorSIMDf* rows, const uint32_t rowCount, const bool translate)
+    {
+        for (uint32_t j=0u; j<4u; j++)
+        for (uint32_t r=0u; r<4u; r++)
+            c[j][r] = r<rowCount && (j<3u||translate) ? rows[r][j]:0.f;
+    }
+};
+
+template<typename T>
+inline T* advance(T* ptr, const size_t bytes)
+{
+    using byte_t = std::conditional_t<std::is_const_v<T>,const uint8_t,uint8_t>;
+    return reinterpret_cast<T*>(reinterpret_cast<byte_t*>(ptr)+bytes);
+}
+
+//! Never reads past the 3rd float, for the last point of a batch
+inline __m128 load3(const float* in)
+{
+    const __m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(in)));
+    return _mm_movelh_ps(xy,_mm_load_ss(in+2));
+}
+
+template<uint32_t OutComponents>
+inline void store(float* out, const __m128 v)
+{
+    if constexpr (OutComponents==4u)
+        _mm_storeu_ps(out,v);
+    else
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(out),v);
+        _mm_store_ss(out+2,_mm_movehl_ps(v,v));
+    }
+}
+
+// Array of Structures, every point gets multiplied as a whole so the kernels only differ in how many points share a register.
+// Points are loaded 16 bytes at a time which is safe as long as there's another point after them (the stride is at least 12 bytes).
+template<uint32_t OutComponents>
+void transformAoS_SSE(const SColumns& m, float* out, const size_t outStride, const float* in, const size_t inStride, size_t i, const size_t count)
+{
+    const __m128 c0 = _mm_load_ps(m.c[0]);
+    const __m128 c1 = _mm_load_ps(m.c[1]);
+    const __m128 c2 = _mm_load_ps(m.c[2]);
+    const __m128 c3 = _mm_load_ps(m.c[3]);
+    for (; i<count; i++)
+    {
+        const float* src = advance(in,i*inStride);
+        const __m128 p = i+1u<count ? _mm_loadu_ps(src):load3(src);
+        __m128 o = _mm_add_ps(_mm_mul_ps(c0,_mm_shuffle_ps(p,p,0x00)),c3);
+        o = _mm_add_ps(_mm_mul_ps(c1,_mm_shuffle_ps(p,p,0x55)),o);
+        o = _mm_add_ps(_mm_mul_ps(c2,_mm_shuffle_ps(p,p,0xaa)),o);
+        store<OutComponents>(advance(out,i*outStride),o);
+    }
+}
+
+template<uint32_t OutComponents>
+NBL_TARGET_ISA("avx2,fma") void transformAoS_AVX2(const SColumns& m, float* out, const size_t outStride, const float* in, const size_t inStride, const size_t count)
+{
+    const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.c[0]));
+    const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.c[1]));
+    const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.c[2]));
+    const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.c[3]));
+    size_t i = 0ull;
+    for (; i+2u<count; i+=2u)
+    {
+        __m256 p = _mm256_castps128_ps256(_mm_loadu_ps(advance(in,i*inStride)));
+        p = _mm256_insertf128_ps(p,_mm_loadu_ps(advance(in,(i+1u)*inStride)),1);
+        __m256 o = _mm256_fmadd_ps(c0,_mm256_permute_ps(p,0x00),c3);
+        o = _mm256_fmadd_ps(c1,_mm256_permute_ps(p,0x55),o);
+        o = _mm256_fmadd_ps(c2,_mm256_permute_ps(p,0xaa),o);
+        store<OutComponents>(advance(out,i*outStride),_mm256_castps256_ps128(o));
+        store<OutComponents>(advance(out,(i+1u)*outStride),_mm256_extractf128_ps(o,1));
+    }
+    transformAoS_SSE<OutComponents>(m,out,outStride,in,inStride,i,count);
+}
+
+template<uint32_t OutComponents>
+NBL_TARGET_ISA("avx512f") void transformAoS_AVX512(const SColumns& m, float* out, const size_t outStride, const float* in, const size_t inStride, const size_t count)
+{
+    const __m512 c0 = _mm512_broadcast_f32x4(_mm_load_ps(m.c[0]));
+    const __m512 c1 = _mm512_broadcast_f32x4(_mm_load_ps(m.c[1]));
+    const __m512 c2 = _mm512_broadcast_f32x4(_mm_load_ps(m.c[2]));
+    const __m512 c3 = _mm512_broadcast_f32x4(_mm_load_ps(m.c[3]));
+    size_t i = 0ull;
+    for (; i+4u<count; i+=4u)
+    {
+        __m512 p = _mm512_castps128_ps512(_mm_loadu_ps(advance(in,i*inStride)));
+        p = _mm512_insertf32x4(p,_mm_loadu_ps(advance(in,(i+1u)*inStride)),1);
+        p = _mm512_insertf32x4(p,_mm_loadu_ps(advance(in,(i+2u)*inStride)),2);
+        p = _mm512_insertf32x4(p,_mm_loadu_ps(advance(in,(i+3u)*inStride)),3);
+        __m512 o = _mm512_fmadd_ps(c0,_mm512_permute_ps(p,0x00),c3);
+        o = _mm512_fmadd_ps(c1,_mm512_permute_ps(p,0x55),o);
+        o = _mm512_fmadd_ps(c2,_mm512_permute_ps(p,0xaa),o);
+        store<OutComponents>(advance(out,i*outStride),_mm512_castps512_ps128(o));
+        store<OutComponents>(advance(out,(i+1u)*outStride),_mm512_extractf32x4_ps(o,1));
+        store<OutComponents>(advance(out,(i+2u)*outStride),_mm512_extractf32x4_ps(o,2));
+        store<OutComponents>(advance(out,(i+3u)*outStride),_mm512_extractf32x4_ps(o,3));
+    }
+    transformAoS_SSE<OutComponents>(m,out,outStride,in,inStride,i,count);
+}
+
+template<uint32_t OutComponents>
+void transformAoS(const SColumns& m, float* out, const size_t outStride, const float* in, const size_t inStride, const size_t count)
+{
+    assert(inStride>=3u*sizeof(float) && outStride>=OutComponents*sizeof(float));
+    const auto& features = getCPUFeatures();
+    if (features.avx512f)
+        transformAoS_AVX512<OutComponents>(m,out,outStride,in,inStride,count);
+    else if (features.avx2 && features.fma)
+        transformAoS_AVX2<OutComponents>(m,out,outStride,in,inStride,count);
+    else
+        transformAoS_SSE<OutComponents>(m,out,outStride,in,inStride,0ull,count);
+}
+
+// Structure of Arrays, every lane is a different point so the kernels are straight multiply-adds of the components by the matrix elements.
+template<uint32_t OutComponents>
+void transformSoA_scalar(const SColumns& m, float* const out[], const float* const in[3], size_t i, const size_t count)
+{
+    for (; i<count; i++)
+    {
+        const float x = in[0][i], y = in[1][i], z = in[2][i];
+        for (uint32_t r=0u; r<OutComponents; r++)
+            out[r][i] = m.c[0][r]*x+m.c[1][r]*y+m.c[2][r]*z+m.c[3][r];
+    }
+}
+
+template<uint32_t OutComponents>
+void transformSoA_SSE(const SColumns& m, float* const out[], const float* const in[3], const size_t count)
+{
+    __m128 coeffs[4][OutComponents];
+    for (uint32_t j=0u; j<4u; j++)
+    for (uint32_t r=0u; r<OutComponents; r++)
+        coeffs[j][r] = _mm_set1_ps(m.c[j][r]);
+
+    size_t i = 0ull;
+    for (; i+4u<=count; i+=4u)
+    {
+        const __m128 x = _mm_loadu_ps(in[0]+i);
+        const __m128 y = _mm_loadu_ps(in[1]+i);
+        const __m128 z = _mm_loadu_ps(in[2]+i);
+        for (uint32_t r=0u; r<OutComponents; r++)
+        {
+            __m128 o = _mm_add_ps(_mm_mul_ps(coeffs[0][r],x),coeffs[3][r]);
+            o = _mm_add_ps(_mm_mul_ps(coeffs[1][r],y),o);
+            o = _mm_add_ps(_mm_mul_ps(coeffs[2][r],z),o);
+            _mm_storeu_ps(out[r]+i,o);
+        }
+    }
+    transformSoA_scalar<OutComponents>(m,out,in,i,count);
+}
+
+template<uint32_t OutComponents>
+NBL_TARGET_ISA("avx2,fma") void transformSoA_AVX2(const SColumns& m, float* const out[], const float* const in[3], const size_t count)
+{
+    __m256 coeffs[4][OutComponents];
+    for (uint32_t j=0u; j<4u; j++)
+    for (uint32_t r=0u; r<OutComponents; r++)
+        coeffs[j][r] = _mm256_set1_ps(m.c[j][r]);
+
+    size_t i = 0ull;
+    for (; i+8u<=count; i+=8u)
+    {
+        const __m256 x = _mm256_loadu_ps(in[0]+i);
+        const __m256 y = _mm256_loadu_ps(in[1]+i);
+        const __m256 z = _mm256_loadu_ps(in[2]+i);
+        for (uint32_t r=0u; r<OutComponents; r++)
+        {
+            __m256 o = _mm256_fmadd_ps(coeffs[0][r],x,coeffs[3][r]);
+            o = _mm256_fmadd_ps(coeffs[1][r],y,o);
+            o = _mm256_fmadd_ps(coeffs[2][r],z,o);
+            _mm256_storeu_ps(out[r]+i,o);
+        }
+    }
+    transformSoA_scalar<OutComponents>(m,out,in,i,count);
+}
+
+template<uint32_t OutComponents>
+NBL_TARGET_ISA("avx512f") void transformSoA_AVX512(const SColumns& m, float* const out[], const float* const in[3], const size_t count)
+{
+    __m512 coeffs[4][OutComponents];
+    for (uint32_t j=0u; j<4u; j++)
+    for (uint32_t r=0u; r<OutComponents; r++)
+        coeffs[j][r] = _mm512_set1_ps(m.c[j][r]);
+
+    size_t i = 0ull;
+    for (; i+16u<=count; i+=16u)
+    {
+        const __m512 x = _mm512_loadu_ps(in[0]+i);
+        const __m512 y = _mm512_loadu_ps(in[1]+i);
+        const __m512 z = _mm512_loadu_ps(in[2]+i);
+        for (uint32_t r=0u; r<OutComponents; r++)
+        {
+            __m512 o = _mm512_fmadd_ps(coeffs[0][r],x,coeffs[3][r]);
+            o = _mm512_fmadd_ps(coeffs[1][r],y,o);
+            o = _mm512_fmadd_ps(coeffs[2][r],z,o);
+            _mm512_storeu_ps(out[r]+i,o);
+        }
+    }
+    // masked loads and stores would do the tail in one go, but it's at most 15 points
+    transformSoA_scalar<OutComponents>(m,out,in,i,count);
+}
+
+template<uint32_t OutComponents>
+void transformSoA(const SColumns& m, float* const out[], const float* const in[3], const size_t count)
+{
+    const auto& features = getCPUFeatures();
+    if (features.avx512f)
+        transformSoA_AVX512<OutComponents>(m,out,in,count);
+    else if (features.avx2 && features.fma)
+        transformSoA_AVX2<OutComponents>(m,out,in,count);
+    else
+        transformSoA_SSE<OutComponents>(m,out,in,count);
+}
+
+}
+
+void matrix3x4SIMD::transformPoints(float* _out, size_t _outStride, const float* _in, size_t _inStride, size_t _count) const
+{
+    transformAoS<3u>(SColumns(rows,VectorCount,true),_out,_outStride,_in,_inStride,_count);
+}
+
+void matrix3x4SIMD::transformDirections(float* _out, size_t _outStride, const float* _in, size_t _inStride, size_t _count) const
+{
+    transformAoS<3u>(SColumns(rows,VectorCount,false),_out,_outStride,_in,_inStride,_count);
+}
+
+void matrix3x4SIMD::transformPointsSoA(float* const _out[3], const float* const _in[3], size_t _count) const
+{
+    transformSoA<3u>(SColumns(rows,VectorCount,true),_out,_in,_count);
+}
+
+void matrix3x4SIMD::transformDirectionsSoA(float* const _out[3], const float* const _in[3], size_t _count) const
+{
+    transformSoA<3u>(SColumns(rows,VectorCount,false),_out,_in,_count);
+}
+
+void matrix4SIMD::transformPoints(float* _out, size_t _outStride, const float* _in, size_t _inStride, size_t _count) const
+{
+    transformAoS<4u>(SColumns(rows,VectorCount,true),_out,_outStride,_in,_inStride,_count);
+}
+
+void matrix4SIMD::transformPointsSoA(float* const _out[4], const float* const _in[3], size_t _count) const
+{
+    transformSoA<4u>(SColumns(rows,VectorCount,true),_out,_in,_count);
+}
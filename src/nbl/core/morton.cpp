@@ -0,0 +1,241 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/core/math/morton.h"
+
+#include <immintrin.h>
+
+using namespace nbl;
+using namespace core;
+
+namespace
+{
+
+// The SIMD kernels spread the bits of every axis same as `impl::separate_bits_2d/3d`, but the masks are tighter
+// because they only have to handle the bit budget of an axis (so 3D in 32 bits needs one step less).
+struct SStep
+{
+    uint32_t shift;
+    uint64_t mask;
+};
+constexpr SStep Spread2D32[] = {{8u,0x00FF00FFull},{4u,0x0F0F0F0Full},{2u,0x33333333ull},{1u,0x55555555ull}};
+constexpr SStep Spread3D32[] = {{16u,0x030000FFull},{8u,0x0300F00Full},{4u,0x030C30C3ull},{2u,0x09249249ull}};
+constexpr SStep Spread2D64[] = {
+    {16u,0x0000FFFF0000FFFFull},{8u,0x00FF00FF00FF00FFull},{4u,0x0F0F0F0F0F0F0F0Full},{2u,0x3333333333333333ull},{1u,0x5555555555555555ull}
+};
+constexpr SStep Spread3D64[] = {
+    {32u,0x001F00000000FFFFull},{16u,0x001F0000FF0000FFull},{8u,0x100F00F00F00F00Full},{4u,0x10C30C30C30C30C3ull},{2u,0x1249249249249249ull}
+};
+
+template<typename OutT, uint32_t Dims>
+constexpr const auto& getSpreadSteps()
+{
+    if constexpr (sizeof(OutT)==4u)
+    {
+        if constexpr (Dims==2u)
+            return Spread2D32;
+        else
+            return Spread3D32;
+    }
+    else
+    {
+        if constexpr (Dims==2u)
+            return Spread2D64;
+        else
+            return Spread3D64;
+    }
+}
+
+template<typename OutT, uint32_t Dims>
+void encode_scalar(OutT* out, const uint32_t* const in[Dims], size_t i, const size_t count)
+{
+    for (; i<count; i++)
+    {
+        if constexpr (Dims==2u)
+            out[i] = morton2d_encode<OutT>(in[0][i],in[1][i]);
+        else
+            out[i] = morton3d_encode<OutT>(in[0][i],in[1][i],in[2][i]);
+    }
+}
+
+template<typename OutT, uint32_t Dims>
+NBL_TARGET_ISA("bmi2") void encode_BMI2(OutT* out, const uint32_t* const in[Dims], const size_t count)
+{
+    for (size_t i=0ull; i<count; i++)
+    {
+        if constexpr (Dims==2u)
+            out[i] = morton2d_encode_bmi2<OutT>(in[0][i],in[1][i]);
+        else
+            out[i] = morton3d_encode_bmi2<OutT>(in[0][i],in[1][i],in[2][i]);
+    }
+}
+
+// two 64-bit lanes don't beat the scalar code, so this only does 32-bit codes
+template<typename OutT, uint32_t Dims>
+void encode_SSE(OutT* out, const uint32_t* const in[Dims], size_t i, const size_t count)
+{
+    if constexpr (sizeof(OutT)==4u)
+    for (; i+4u<=count; i+=4u)
+    {
+        __m128i res = _mm_setzero_si128();
+        for (uint32_t d=0u; d<Dims; d++)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in[d]+i));
+            for (const auto& step : getSpreadSteps<OutT,Dims>())
+                v = _mm_and_si128(_mm_or_si128(v,_mm_slli_epi32(v,step.shift)),_mm_set1_epi32(step.mask));
+            res = _mm_or_si128(res,_mm_slli_epi32(v,d));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out+i),res);
+    }
+    encode_scalar<OutT,Dims>(out,in,i,count);
+}
+
+template<typename OutT, uint32_t Dims>
+NBL_TARGET_ISA("avx2") void encode_AVX2(OutT* out, const uint32_t* const in[Dims], const size_t count)
+{
+    constexpr auto& steps = getSpreadSteps<OutT,Dims>();
+    constexpr size_t lanes = sizeof(__m256i)/sizeof(OutT);
+    size_t i = 0ull;
+    for (; i+lanes<=count; i+=lanes)
+    {
+        __m256i res = _mm256_setzero_si256();
+        for (uint32_t d=0u; d<Dims; d++)
+        {
+            __m256i v;
+            if constexpr (sizeof(OutT)==4u)
+            {
+                v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in[d]+i));
+                for (const auto& step : steps)
+                    v = _mm256_and_si256(_mm256_or_si256(v,_mm256_slli_epi32(v,step.shift)),_mm256_set1_epi32(step.mask));
+                res = _mm256_or_si256(res,_mm256_slli_epi32(v,d));
+            }
+            else
+            {
+                v = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in[d]+i)));
+                for (const auto& step : steps)
+                    v = _mm256_and_si256(_mm256_or_si256(v,_mm256_slli_epi64(v,step.shift)),_mm256_set1_epi64x(step.mask));
+                res = _mm256_or_si256(res,_mm256_slli_epi64(v,d));
+            }
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+i),res);
+    }
+    encode_SSE<OutT,Dims>(out,in,i,count);
+}
+
+template<typename OutT, uint32_t Dims>
+NBL_TARGET_ISA("avx512f") void encode_AVX512(OutT* out, const uint32_t* const in[Dims], const size_t count)
+{
+    constexpr auto& steps = getSpreadSteps<OutT,Dims>();
+    constexpr size_t lanes = sizeof(__m512i)/sizeof(OutT);
+    size_t i = 0ull;
+    for (; i+lanes<=count; i+=lanes)
+    {
+        __m512i res = _mm512_setzero_si512();
+        for (uint32_t d=0u; d<Dims; d++)
+        {
+            __m512i v;
+            if constexpr (sizeof(OutT)==4u)
+            {
+                v = _mm512_loadu_si512(in[d]+i);
+                for (const auto& step : steps)
+                    v = _mm512_and_si512(_mm512_or_si512(v,_mm512_slli_epi32(v,step.shift)),_mm512_set1_epi32(step.mask));
+                res = _mm512_or_si512(res,_mm512_slli_epi32(v,d));
+            }
+            else
+            {
+                v = _mm512_cvtepu32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in[d]+i)));
+                for (const auto& step : steps)
+                    v = _mm512_and_si512(_mm512_or_si512(v,_mm512_slli_epi64(v,step.shift)),_mm512_set1_epi64(step.mask));
+                res = _mm512_or_si512(res,_mm512_slli_epi64(v,d));
+            }
+        }
+        _mm512_storeu_si512(out+i,res);
+    }
+    encode_SSE<OutT,Dims>(out,in,i,count);
+}
+
+template<typename OutT, uint32_t Dims>
+void encode(OutT* out, const uint32_t* const in[Dims], const size_t count)
+{
+    // a `pdep` per axis beats spreading 64-bit lanes with shifts, even on AVX-512, but not 32-bit ones
+    const auto& features = getCPUFeatures();
+    if (features.avx512f && (sizeof(OutT)==4u || !features.fastPdepPext))
+        encode_AVX512<OutT,Dims>(out,in,count);
+    else if (features.fastPdepPext)
+        encode_BMI2<OutT,Dims>(out,in,count);
+    else if (features.avx2)
+        encode_AVX2<OutT,Dims>(out,in,count);
+    else
+        encode_SSE<OutT,Dims>(out,in,0ull,count);
+}
+
+template<typename OutT, uint32_t Dims>
+void encode(const impl::E_MORTON_ENCODE_ISA isa, OutT* out, const uint32_t* const in[Dims], const size_t count)
+{
+    switch (isa)
+    {
+        case impl::EMEI_AVX512:
+            encode_AVX512<OutT,Dims>(out,in,count);
+            break;
+        case impl::EMEI_AVX2:
+            encode_AVX2<OutT,Dims>(out,in,count);
+            break;
+        case impl::EMEI_BMI2:
+            encode_BMI2<OutT,Dims>(out,in,count);
+            break;
+        default:
+            encode_SSE<OutT,Dims>(out,in,0ull,count);
+            break;
+    }
+}
+
+}
+
+void nbl::core::morton2d_encode(uint32_t* _out, const uint32_t* _x, const uint32_t* _y, size_t _count)
+{
+    const uint32_t* const in[2] = {_x,_y};
+    encode<uint32_t,2u>(_out,in,_count);
+}
+
+void nbl::core::morton2d_encode(uint64_t* _out, const uint32_t* _x, const uint32_t* _y, size_t _count)
+{
+    const uint32_t* const in[2] = {_x,_y};
+    encode<uint64_t,2u>(_out,in,_count);
+}
+
+void nbl::core::morton3d_encode(uint32_t* _out, const uint32_t* _x, const uint32_t* _y, const uint32_t* _z, size_t _count)
+{
+    const uint32_t* const in[3] = {_x,_y,_z};
+    encode<uint32_t,3u>(_out,in,_count);
+}
+
+void nbl::core::morton3d_encode(uint64_t* _out, const uint32_t* _x, const uint32_t* _y, const uint32_t* _z, size_t _count)
+{
+    const uint32_t* const in[3] = {_x,_y,_z};
+    encode<uint64_t,3u>(_out,in,_count);
+}
+
+void nbl::core::impl::morton2d_encode(const E_MORTON_ENCODE_ISA _isa, uint32_t* _out, const uint32_t* _x, const uint32_t* _y, size_t _count)
+{
+    const uint32_t* const in[2] = {_x,_y};
+    encode<uint32_t,2u>(_isa,_out,in,_count);
+}
+
+void nbl::core::impl::morton2d_encode(const E_MORTON_ENCODE_ISA _isa, uint64_t* _out, const uint32_t* _x, const uint32_t* _y, size_t _count)
+{
+    const uint32_t* const in[2] = {_x,_y};
+    encode<uint64_t,2u>(_isa,_out,in,_count);
+}
+
+void nbl::core::impl::morton3d_encode(const E_MORTON_ENCODE_ISA _isa, uint32_t* _out, const uint32_t* _x, const uint32_t* _y, const uint32_t* _z, size_t _count)
+{
+    const uint32_t* const in[3] = {_x,_y,_z};
+    encode<uint32_t,3u>(_isa,_out,in,_count);
+}
+
+void nbl::core::impl::morton3d_encode(const E_MORTON_ENCODE_ISA _isa, uint64_t* _out, const uint32_t* _x, const uint32_t* _y, const uint32_t* _z, size_t _count)
+{
+    const uint32_t* const in[3] = {_x,_y,_z};
+    encode<uint64_t,3u>(_isa,_out,in,_count);
+}
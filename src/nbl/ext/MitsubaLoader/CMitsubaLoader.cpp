@@ -560,8 +560,8 @@ asset::SAssetBundle CMitsubaLoader::loadAsset(system::IFile* _file, const asset:
 			ctx.meta->addDerivMapMeta(derivMap.first.get(), derivMap.second);
 		}
 
-		auto meshSmartPtrArray = core::make_refctd_dynamic_array<SAssetBundle::contents_container_t>(meshes.size());
-		auto meshSmartPtrArrayIt = meshSmartPtrArray->begin();
+		SAssetBundle::contents_container_t meshSmartPtrArray(meshes.size());
+		auto meshSmartPtrArrayIt = meshSmartPtrArray.begin();
 		for (const auto& mesh_ : meshes)
 		{
 			for (auto mb : mesh_.first.get()->getMeshBuffers())
@@ -0,0 +1,82 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_TOOLS_BENCHMARKS_ASSET_COMMON_H_INCLUDED_
+#define _NBL_TOOLS_BENCHMARKS_ASSET_COMMON_H_INCLUDED_
+
+#include "nabla.h"
+#include "nbl/system/IApplicationFramework.h"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace nbl::benchmarks
+{
+
+inline core::smart_refctd_ptr<asset::IAssetManager> createAssetManager()
+{
+#ifdef _NBL_PLATFORM_LINUX_
+	auto system = core::make_smart_refctd_ptr<system::CSystemLinux>();
+#else
+	auto system = system::IApplicationFramework::createSystem();
+#endif
+	if (!system)
+		return nullptr;
+	return core::make_smart_refctd_ptr<asset::IAssetManager>(std::move(system));
+}
+
+//! Nothing gets cached, so that every repetition of a benchmark does the whole load again
+inline asset::IAssetLoader::SAssetLoadParams uncachedLoadParams(const asset::IAssetLoader::E_LOADER_PARAMETER_FLAGS flags=asset::IAssetLoader::ELPF_NONE)
+{
+	asset::IAssetLoader::SAssetLoadParams params;
+	params.cacheFlags = asset::IAssetLoader::ECF_DONT_CACHE_REFERENCES;
+	params.loaderFlags = static_cast<asset::IAssetLoader::E_LOADER_PARAMETER_FLAGS>(flags|asset::IAssetLoader::ELPF_DONT_COMPILE_GLSL);
+	return params;
+}
+
+//! Scratch directory for the generated inputs, emptied on construction and removed on destruction
+class CScratchDirectory
+{
+	public:
+		explicit CScratchDirectory(const char* name) : m_path(std::filesystem::temp_directory_path()/"nbl_benchmarks"/name)
+		{
+			std::filesystem::remove_all(m_path);
+			std::filesystem::create_directories(m_path);
+		}
+		~CScratchDirectory()
+		{
+			std::error_code ec;
+			std::filesystem::remove_all(m_path,ec);
+		}
+
+		inline const system::path& get() const {return m_path;}
+
+	private:
+		system::path m_path;
+};
+
+//! Writes an ASCII PLY of a `gridSize` by `gridSize` vertex grid, `seed` perturbs the heights so different seeds make different contents
+inline system::path writeGridPLY(const system::path& path, const uint32_t gridSize, const uint32_t seed)
+{
+	std::ofstream file(path,std::ios::binary);
+	const uint32_t quadsPerSide = gridSize-1u;
+	file << "ply\nformat ascii 1.0\n";
+	file << "element vertex " << gridSize*gridSize << "\nproperty float x\nproperty float y\nproperty float z\n";
+	file << "element face " << quadsPerSide*quadsPerSide*2u << "\nproperty list uchar uint vertex_indices\nend_header\n";
+	for (uint32_t y=0u; y<gridSize; y++)
+	for (uint32_t x=0u; x<gridSize; x++)
+		file << float(x) << ' ' << float(((x*31u+y*17u+seed*7u)%13u))*0.125f << ' ' << float(y) << '\n';
+	for (uint32_t y=0u; y<quadsPerSide; y++)
+	for (uint32_t x=0u; x<quadsPerSide; x++)
+	{
+		const uint32_t i = y*gridSize+x;
+		file << "3 " << i << ' ' << i+gridSize << ' ' << i+1u << '\n';
+		file << "3 " << i+1u << ' ' << i+gridSize << ' ' << i+gridSize+1u << '\n';
+	}
+	return path;
+}
+
+}
+
+#endif
@@ -0,0 +1,48 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#include "nabla.h"
+
+#include "common.h"
+
+using namespace nbl;
+using namespace nbl::asset;
+
+namespace
+{
+constexpr uint32_t MeshBufferCount = 1024u;
+// every buffer is shared by this many meshbuffers, like the vertex buffers of a packed scene
+constexpr uint32_t MeshBuffersPerBuffer = 16u;
+constexpr size_t BufferSize = 1ull<<20ull;
+constexpr uint32_t Repetitions = 5u;
+}
+
+void benchmarkCloneSession()
+{
+	auto mesh = core::make_smart_refctd_ptr<ICPUMesh>();
+	auto& meshbuffers = mesh->getMeshBufferVector();
+	core::smart_refctd_ptr<ICPUBuffer> buffer;
+	for (uint32_t i=0u; i<MeshBufferCount; i++)
+	{
+		if (i%MeshBuffersPerBuffer==0u)
+		{
+			buffer = core::make_smart_refctd_ptr<ICPUBuffer>(BufferSize);
+			memset(buffer->getPointer(),i,BufferSize);
+		}
+		auto meshbuffer = core::make_smart_refctd_ptr<ICPUMeshBuffer>();
+		meshbuffer->setVertexBufferBinding({(i%MeshBuffersPerBuffer)*(BufferSize/MeshBuffersPerBuffer),core::smart_refctd_ptr(buffer)},0u);
+		meshbuffers.push_back(std::move(meshbuffer));
+	}
+
+	benchmarks::measure("clone session: ICPUMesh::clone, no session",MeshBufferCount,Repetitions,[&]()
+	{
+		auto clone = mesh->clone();
+		benchmarks::doNotOptimize(clone);
+	});
+	benchmarks::measure("clone session: ICPUMesh::clone, in an SCloneSession",MeshBufferCount,Repetitions,[&]()
+	{
+		IAsset::SCloneSession session;
+		auto clone = mesh->clone();
+		benchmarks::doNotOptimize(clone);
+	});
+}
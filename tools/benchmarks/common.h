@@ -0,0 +1,45 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_TOOLS_BENCHMARKS_COMMON_H_INCLUDED_
+#define _NBL_TOOLS_BENCHMARKS_COMMON_H_INCLUDED_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+
+namespace nbl::benchmarks
+{
+
+//! Runs `body` `repetitions` times and prints the fastest run, so that noise from the rest of the system doesn't count
+/** `itemCount` is however many items (elements, transforms, assets...) one call of `body` processes. */
+template<typename F>
+inline double measure(const char* name, const uint64_t itemCount, const uint32_t repetitions, F&& body)
+{
+	double best = std::numeric_limits<double>::infinity();
+	for (uint32_t i=0u; i<repetitions; i++)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		body();
+		const std::chrono::duration<double,std::milli> elapsed = std::chrono::steady_clock::now()-start;
+		best = std::min(best,elapsed.count());
+	}
+	printf("%-72s %10.3f ms %10.2f ns/item\n",name,best,best*1000000.0/double(std::max<uint64_t>(itemCount,1ull)));
+	return best;
+}
+
+//! Keeps the compiler from optimizing away a computation whose result is never used (portable, unlike inline asm)
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+	static const void* volatile sink;
+	sink = &value;
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+}
+
+#endif
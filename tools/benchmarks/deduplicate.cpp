@@ -0,0 +1,60 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#include "assetCommon.h"
+#include "common.h"
+
+using namespace nbl;
+
+namespace
+{
+constexpr uint32_t FileCount = 64u;
+// every contents is in `FileCount/DistinctCount` files
+constexpr uint32_t DistinctCount = 8u;
+constexpr uint32_t GridSize = 128u;
+constexpr uint32_t Repetitions = 3u;
+}
+
+void benchmarkDeduplicate()
+{
+	auto assetManager = benchmarks::createAssetManager();
+	if (!assetManager)
+	{
+		printf("Could not create the asset manager!\n");
+		return;
+	}
+
+	benchmarks::CScratchDirectory scratch("deduplicate");
+	std::vector<system::path> paths;
+	for (uint32_t i=0u; i<FileCount; i++)
+		paths.push_back(benchmarks::writeGridPLY(scratch.get()/("grid"+std::to_string(i)+".ply"),GridSize,i%DistinctCount));
+
+	auto* deduplicator = assetManager->getDeduplicator();
+	auto loadAll = [&](const asset::IAssetLoader::SAssetLoadParams& params) -> core::vector<asset::SAssetBundle>
+	{
+		auto bundles = assetManager->getAssets(paths,params);
+		for (uint32_t i=0u; i<FileCount; i++)
+		if (bundles[i].getContents().empty())
+			printf("Failed to load %s!\n",paths[i].string().c_str());
+		return bundles;
+	};
+	benchmarks::measure("deduplicate: getAssets",FileCount,Repetitions,[&](){loadAll(benchmarks::uncachedLoadParams());});
+	// the loads run on many threads, which only wait on each other for the lookups and not the hashing
+	benchmarks::measure("deduplicate: getAssets with ELPF_DEDUPLICATE",FileCount,Repetitions,[&]()
+	{
+		deduplicator->clear();
+		loadAll(benchmarks::uncachedLoadParams(asset::IAssetLoader::ELPF_DEDUPLICATE));
+	});
+	const auto statistics = deduplicator->getStatistics();
+	printf("%llu duplicates, %llu bytes saved\n",static_cast<unsigned long long>(statistics.duplicates),static_cast<unsigned long long>(statistics.bytesSaved));
+
+	// just the hashing and replacing, without the loads
+	const auto bundles = loadAll(benchmarks::uncachedLoadParams());
+	benchmarks::measure("deduplicate: CAssetDeduplicator::deduplicate on loaded meshes",FileCount,Repetitions,[&]()
+	{
+		deduplicator->clear();
+		for (const auto& bundle : bundles)
+		for (const auto& asset : bundle.getContents())
+			deduplicator->deduplicate(asset.get(),bundle.getMetadata(),true);
+	});
+}
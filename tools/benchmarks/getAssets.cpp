@@ -0,0 +1,47 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#include "assetCommon.h"
+#include "common.h"
+
+using namespace nbl;
+
+namespace
+{
+constexpr uint32_t FileCount = 64u;
+constexpr uint32_t GridSize = 128u;
+constexpr uint32_t Repetitions = 3u;
+}
+
+void benchmarkGetAssets()
+{
+	auto assetManager = benchmarks::createAssetManager();
+	if (!assetManager)
+	{
+		printf("Could not create the asset manager!\n");
+		return;
+	}
+
+	benchmarks::CScratchDirectory scratch("getAssets");
+	std::vector<system::path> paths;
+	for (uint32_t i=0u; i<FileCount; i++)
+		paths.push_back(benchmarks::writeGridPLY(scratch.get()/("grid"+std::to_string(i)+".ply"),GridSize,i));
+
+	const auto params = benchmarks::uncachedLoadParams();
+	benchmarks::measure("getAssets: getAsset for every file in turn",FileCount,Repetitions,[&]()
+	{
+		for (const auto& path : paths)
+		{
+			auto bundle = assetManager->getAsset(path.string(),params);
+			if (bundle.getContents().empty())
+				printf("Failed to load %s!\n",path.string().c_str());
+		}
+	});
+	benchmarks::measure("getAssets: getAssets",FileCount,Repetitions,[&]()
+	{
+		const auto bundles = assetManager->getAssets(paths,params);
+		for (uint32_t i=0u; i<FileCount; i++)
+		if (bundles[i].getContents().empty())
+			printf("Failed to load %s!\n",paths[i].string().c_str());
+	});
+}
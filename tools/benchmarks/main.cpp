@@ -0,0 +1,46 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+// Micro-benchmarks of the containers and asset pipeline paths which were written for speed,
+// each one runs against the code (or the standard library equivalent) it replaced.
+// Pass a substring of the benchmark names to only run the matching ones.
+#include <cstdio>
+#include <string_view>
+
+void benchmarkRingBuffers();
+void benchmarkStableFlatHashMap();
+void benchmarkMatrixTransforms();
+void benchmarkMorton();
+void benchmarkGetAssets();
+void benchmarkNBLLoad();
+void benchmarkCloneSession();
+void benchmarkDeduplicate();
+
+int main(int argc, char* argv[])
+{
+	struct SBenchmark
+	{
+		std::string_view name;
+		void(*run)();
+	};
+	constexpr SBenchmark Benchmarks[] = {
+		{"ring buffers",benchmarkRingBuffers},
+		{"stable flat hash map",benchmarkStableFlatHashMap},
+		{"matrix transforms",benchmarkMatrixTransforms},
+		{"morton",benchmarkMorton},
+		{"getAssets",benchmarkGetAssets},
+		{"nbl load",benchmarkNBLLoad},
+		{"clone session",benchmarkCloneSession},
+		{"deduplicate",benchmarkDeduplicate}
+	};
+
+	const std::string_view filter = argc>1 ? argv[1]:"";
+	for (const auto& benchmark : Benchmarks)
+	if (benchmark.name.find(filter)!=std::string_view::npos)
+	{
+		printf("== %s ==\n",benchmark.name.data());
+		benchmark.run();
+	}
+	return 0;
+}
@@ -0,0 +1,95 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#include "matrix4SIMD.h"
+
+#include "common.h"
+
+#include <vector>
+
+using namespace nbl;
+using namespace nbl::core;
+
+namespace
+{
+constexpr size_t PointCount = 1ull<<20;
+constexpr uint32_t Repetitions = 20u;
+// position, normal and uv interleaved, like most vertex buffers
+constexpr size_t VertexStride = 8ull*sizeof(float);
+}
+
+void benchmarkMatrixTransforms()
+{
+	std::vector<float> interleaved(PointCount*VertexStride/sizeof(float));
+	for (size_t i=0ull; i<interleaved.size(); i++)
+		interleaved[i] = float(i%1021u)*0.125f-64.f;
+	std::vector<float> soaIn[3];
+	for (uint32_t c=0u; c<3u; c++)
+	{
+		soaIn[c].resize(PointCount);
+		for (size_t i=0ull; i<PointCount; i++)
+			soaIn[c][i] = interleaved[i*VertexStride/sizeof(float)+c];
+	}
+	std::vector<float> out(PointCount*3ull);
+	std::vector<float> soaOut[4];
+	for (auto& component : soaOut)
+		component.resize(PointCount);
+
+	matrix3x4SIMD transform(
+		0.36f,0.48f,-0.8f,1.f,
+		-0.8f,0.6f,0.f,-2.f,
+		0.48f,0.64f,0.6f,3.f
+	);
+
+	// what `calculateBoundingBox` and friends do, one `vectorSIMDf` at a time
+	benchmarks::measure("matrix transforms: per-point pseudoMulWith4x1",PointCount,Repetitions,[&]()
+	{
+		for (size_t i=0ull; i<PointCount; i++)
+		{
+			const float* in = interleaved.data()+i*VertexStride/sizeof(float);
+			vectorSIMDf point(in[0],in[1],in[2]);
+			transform.pseudoMulWith4x1(point);
+			std::copy_n(point.pointer,3u,out.data()+i*3ull);
+		}
+		benchmarks::doNotOptimize(out);
+	});
+	benchmarks::measure("matrix transforms: matrix3x4SIMD::transformPoints",PointCount,Repetitions,[&]()
+	{
+		transform.transformPoints(out.data(),3ull*sizeof(float),interleaved.data(),VertexStride,PointCount);
+		benchmarks::doNotOptimize(out);
+	});
+	benchmarks::measure("matrix transforms: matrix3x4SIMD::transformDirections",PointCount,Repetitions,[&]()
+	{
+		transform.transformDirections(out.data(),3ull*sizeof(float),interleaved.data(),VertexStride,PointCount);
+		benchmarks::doNotOptimize(out);
+	});
+	{
+		const float* const in[3] = {soaIn[0].data(),soaIn[1].data(),soaIn[2].data()};
+		float* const soa[3] = {soaOut[0].data(),soaOut[1].data(),soaOut[2].data()};
+		benchmarks::measure("matrix transforms: matrix3x4SIMD::transformPointsSoA",PointCount,Repetitions,[&]()
+		{
+			transform.transformPointsSoA(soa,in,PointCount);
+			benchmarks::doNotOptimize(soaOut);
+		});
+	}
+
+	matrix4SIMD projection(transform);
+	projection.rows[3] = vectorSIMDf(0.f,0.f,1.f,0.f);
+	std::vector<float> homogeneous(PointCount*4ull);
+	benchmarks::measure("matrix transforms: per-point matrix4SIMD::transformVect",PointCount,Repetitions,[&]()
+	{
+		for (size_t i=0ull; i<PointCount; i++)
+		{
+			const float* in = interleaved.data()+i*VertexStride/sizeof(float);
+			vectorSIMDf point(in[0],in[1],in[2],1.f);
+			projection.transformVect(point);
+			point.storeTo4Floats(homogeneous.data()+i*4ull);
+		}
+		benchmarks::doNotOptimize(homogeneous);
+	});
+	benchmarks::measure("matrix transforms: matrix4SIMD::transformPoints",PointCount,Repetitions,[&]()
+	{
+		projection.transformPoints(homogeneous.data(),4ull*sizeof(float),interleaved.data(),VertexStride,PointCount);
+		benchmarks::doNotOptimize(homogeneous);
+	});
+}
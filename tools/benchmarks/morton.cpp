@@ -0,0 +1,82 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#include "nbl/core/math/morton.h"
+
+#include "common.h"
+
+#include <vector>
+
+using namespace nbl;
+using namespace nbl::core;
+
+namespace
+{
+constexpr size_t PointCount = 1ull<<22;
+constexpr uint32_t Repetitions = 20u;
+
+struct SPath
+{
+	const char* name;
+	impl::E_MORTON_ENCODE_ISA isa;
+	bool supported;
+};
+
+// the scalar encoder is what every caller did per point before the batch encoders
+template<typename OutT>
+void benchmark3D(const char* scalarName, const uint32_t axisBits)
+{
+	const uint32_t axisMask = (0x1u<<axisBits)-1u;
+	std::vector<uint32_t> axes[3];
+	for (uint32_t d=0u; d<3u; d++)
+	{
+		axes[d].resize(PointCount);
+		for (size_t i=0ull; i<PointCount; i++)
+			axes[d][i] = static_cast<uint32_t>(i*2654435761ull>>(d*5u))&axisMask;
+	}
+	std::vector<OutT> expected(PointCount), out(PointCount);
+
+	benchmarks::measure(scalarName,PointCount,Repetitions,[&]()
+	{
+		for (size_t i=0ull; i<PointCount; i++)
+			expected[i] = morton3d_encode<OutT>(axes[0][i],axes[1][i],axes[2][i]);
+		benchmarks::doNotOptimize(expected);
+	});
+
+	const auto& features = getCPUFeatures();
+	const SPath paths[] = {
+		{"SSE",impl::EMEI_SSE,true},
+		{"BMI2",impl::EMEI_BMI2,features.bmi2},
+		{"AVX2",impl::EMEI_AVX2,features.avx2},
+		{"AVX-512",impl::EMEI_AVX512,features.avx512f}
+	};
+	const std::string prefix = "morton: morton3d_encode batch to "+std::to_string(sizeof(OutT)*8u)+" bits, ";
+	for (const auto& path : paths)
+	{
+		const std::string name = prefix+path.name;
+		if (!path.supported)
+		{
+			printf("%-72s not supported by the CPU\n",name.c_str());
+			continue;
+		}
+		benchmarks::measure(name.c_str(),PointCount,Repetitions,[&]()
+		{
+			impl::morton3d_encode(path.isa,out.data(),axes[0].data(),axes[1].data(),axes[2].data(),PointCount);
+			benchmarks::doNotOptimize(out);
+		});
+		if (out!=expected)
+			printf("%s gives different codes than the scalar encoder!\n",name.c_str());
+	}
+	benchmarks::measure((prefix+"picked at runtime").c_str(),PointCount,Repetitions,[&]()
+	{
+		morton3d_encode(out.data(),axes[0].data(),axes[1].data(),axes[2].data(),PointCount);
+		benchmarks::doNotOptimize(out);
+	});
+}
+}
+
+void benchmarkMorton()
+{
+	benchmark3D<uint32_t>("morton: per-point morton3d_encode<uint32_t>",10u);
+	benchmark3D<uint64_t>("morton: per-point morton3d_encode<uint64_t>",21u);
+}
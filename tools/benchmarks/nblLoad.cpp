@@ -0,0 +1,58 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#include "assetCommon.h"
+#include "common.h"
+
+using namespace nbl;
+
+namespace
+{
+constexpr uint32_t FileCount = 16u;
+constexpr uint32_t GridSize = 256u;
+constexpr uint32_t Repetitions = 5u;
+}
+
+void benchmarkNBLLoad()
+{
+	auto assetManager = benchmarks::createAssetManager();
+	if (!assetManager)
+	{
+		printf("Could not create the asset manager!\n");
+		return;
+	}
+
+	// the same meshes, once as text and once converted to the native container
+	benchmarks::CScratchDirectory scratch("nblLoad");
+	const auto params = benchmarks::uncachedLoadParams();
+	std::vector<system::path> plyPaths,nblPaths;
+	for (uint32_t i=0u; i<FileCount; i++)
+	{
+		const auto name = "grid"+std::to_string(i);
+		plyPaths.push_back(benchmarks::writeGridPLY(scratch.get()/(name+".ply"),GridSize,i));
+		auto bundle = assetManager->getAsset(plyPaths.back().string(),params);
+		if (bundle.getContents().empty())
+		{
+			printf("Failed to load %s!\n",plyPaths.back().string().c_str());
+			return;
+		}
+		nblPaths.push_back(scratch.get()/(name+".nbl"));
+		if (!assetManager->writeAsset(nblPaths.back().string(),asset::IAssetWriter::SAssetWriteParams(bundle.getContents().begin()->get())))
+		{
+			printf("Failed to write %s!\n",nblPaths.back().string().c_str());
+			return;
+		}
+	}
+
+	auto loadAll = [&](const std::vector<system::path>& paths) -> void
+	{
+		for (const auto& path : paths)
+		{
+			auto bundle = assetManager->getAsset(path.string(),params);
+			if (bundle.getContents().empty())
+				printf("Failed to load %s!\n",path.string().c_str());
+		}
+	};
+	benchmarks::measure("nbl load: PLY",FileCount,Repetitions,[&](){loadAll(plyPaths);});
+	benchmarks::measure("nbl load: the same meshes written to NBL",FileCount,Repetitions,[&](){loadAll(nblPaths);});
+}
@@ -0,0 +1,90 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#include "nbl/core/containers/CConcurrentRingBuffer.h"
+
+#include "common.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace nbl;
+
+namespace
+{
+// what the rings replace, a deque guarded by a mutex with a condition variable to block on
+template<typename T>
+class CLockedQueue
+{
+	public:
+		explicit CLockedQueue(size_t cap) : m_capacity(cap) {}
+
+		inline void push(const T& val)
+		{
+			std::unique_lock lock(m_mutex);
+			m_notFull.wait(lock,[&](){return m_items.size()<m_capacity;});
+			m_items.push_back(val);
+			m_notEmpty.notify_one();
+		}
+		inline T pop()
+		{
+			std::unique_lock lock(m_mutex);
+			m_notEmpty.wait(lock,[&](){return !m_items.empty();});
+			T retval = m_items.front();
+			m_items.pop_front();
+			m_notFull.notify_one();
+			return retval;
+		}
+
+	private:
+		const size_t m_capacity;
+		std::mutex m_mutex;
+		std::condition_variable m_notFull,m_notEmpty;
+		std::deque<T> m_items;
+};
+
+constexpr size_t Capacity = 1024ull;
+constexpr uint64_t ItemCount = 1ull<<20;
+constexpr uint32_t Repetitions = 5u;
+
+// every producer pushes `ItemCount/producers` items, every consumer pops `ItemCount/consumers`
+template<class Queue>
+void transfer(const char* name, const uint32_t producers, const uint32_t consumers)
+{
+	benchmarks::measure(name,ItemCount,Repetitions,[&]()
+	{
+		Queue queue(Capacity);
+		std::atomic_uint64_t checksum = 0u;
+		std::vector<std::thread> threads;
+		for (uint32_t p=0u; p<producers; p++)
+			threads.emplace_back([&queue,p,producers]()
+			{
+				for (uint64_t i=p; i<ItemCount; i+=producers)
+					queue.push(i);
+			});
+		for (uint32_t c=0u; c<consumers; c++)
+			threads.emplace_back([&queue,&checksum,consumers]()
+			{
+				uint64_t sum = 0u;
+				for (uint64_t i=0u; i<ItemCount/consumers; i++)
+					sum += queue.pop();
+				checksum.fetch_add(sum,std::memory_order_relaxed);
+			});
+		for (auto& thread : threads)
+			thread.join();
+		if (checksum.load()!=ItemCount*(ItemCount-1ull)/2ull)
+			printf("%s lost or duplicated items!\n",name);
+	});
+}
+}
+
+void benchmarkRingBuffers()
+{
+	transfer<CLockedQueue<uint64_t>>("ring buffers: std::mutex+std::deque 1P/1C",1u,1u);
+	transfer<core::CSPSCRingBuffer<uint64_t>>("ring buffers: CSPSCRingBuffer 1P/1C",1u,1u);
+	transfer<CLockedQueue<uint64_t>>("ring buffers: std::mutex+std::deque 4P/4C",4u,4u);
+	transfer<core::CMPMCRingBuffer<uint64_t>>("ring buffers: CMPMCRingBuffer 4P/4C",4u,4u);
+}
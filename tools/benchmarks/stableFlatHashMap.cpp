@@ -0,0 +1,77 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#include "nbl/core/containers/stable_flat_hash_map.h"
+
+#include "common.h"
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace nbl;
+
+namespace
+{
+constexpr uint32_t KeyCount = 200000u;
+constexpr uint32_t Repetitions = 5u;
+
+// what the asset cache gets keyed with
+std::vector<std::string> makePathLikeKeys()
+{
+	std::vector<std::string> keys;
+	keys.reserve(KeyCount);
+	for (uint32_t i=0u; i<KeyCount; i++)
+		keys.push_back("../../media/models/set"+std::to_string(i%97u)+"/mesh_"+std::to_string(i)+".obj");
+	return keys;
+}
+
+template<class Map>
+void insertAndLookup(const char* name, const std::vector<std::string>& keys, const std::vector<std::string_view>& lookups)
+{
+	std::string insertName = name;
+	insertName += " insert";
+	benchmarks::measure(insertName.c_str(),KeyCount,Repetitions,[&]()
+	{
+		Map map;
+		for (uint32_t i=0u; i<KeyCount; i++)
+			map.emplace(keys[i],i);
+		benchmarks::doNotOptimize(map);
+	});
+
+	Map map;
+	for (uint32_t i=0u; i<KeyCount; i++)
+		map.emplace(keys[i],i);
+	std::string lookupName = name;
+	lookupName += " string_view lookup";
+	benchmarks::measure(lookupName.c_str(),KeyCount,Repetitions,[&]()
+	{
+		uint64_t sum = 0ull;
+		for (const auto& key : lookups)
+		{
+			// the std containers without a transparent comparator need the `std::string` made
+			if constexpr (std::is_same_v<Map,std::multimap<std::string,uint32_t>> || std::is_same_v<Map,std::unordered_multimap<std::string,uint32_t>>)
+				sum += map.find(std::string(key))->second;
+			else
+				sum += map.find(key)->second;
+		}
+		benchmarks::doNotOptimize(sum);
+	});
+}
+}
+
+void benchmarkStableFlatHashMap()
+{
+	const auto keys = makePathLikeKeys();
+	// look up in a different order than inserted, so we don't walk the node pool linearly
+	std::vector<std::string_view> lookups;
+	lookups.reserve(KeyCount);
+	for (uint32_t i=0u; i<KeyCount; i++)
+		lookups.push_back(keys[(i*7919u)%KeyCount]);
+
+	insertAndLookup<std::multimap<std::string,uint32_t>>("stable flat hash map: std::multimap",keys,lookups);
+	insertAndLookup<std::unordered_multimap<std::string,uint32_t>>("stable flat hash map: std::unordered_multimap",keys,lookups);
+	insertAndLookup<core::stable_flat_hash_multimap<std::string,uint32_t>>("stable flat hash map: core::stable_flat_hash_multimap",keys,lookups);
+}